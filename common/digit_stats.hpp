@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <immintrin.h>
+
+// Статистика цифр по десятичной записи числа (любой длины) без деления:
+// - max_digit: наибольшая цифра и число ее повторений
+// - histogram: сколько раз встречается каждая цифра
+//
+// Работают прямо с текстом: байты '0'..'9' - цифры, остальные (знак,
+// пробелы) пропускаются. AVX2 по 32 байта с выбором ядра при запуске,
+// скалярный вариант - для процессоров без AVX2 и для сверки.
+//
+// Используется в lab3 (пункт 2 и пакетный режим) и lab5 (handle_option1)
+
+namespace digits {
+
+struct DigitStats {
+    int max_digit = -1;            // -1 - цифр нет
+    std::uint64_t max_count = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// СКАЛЯРНЫЕ ВАРИАНТЫ
+////////////////////////////////////////////////////////////////////////////////
+
+inline DigitStats max_digit_scalar(std::string_view text) {
+    DigitStats stats;
+    for (char c : text) {
+        int digit = c - '0';
+        if (static_cast<unsigned>(digit) > 9) continue;
+        if (digit > stats.max_digit) {
+            stats.max_digit = digit;
+            stats.max_count = 1;
+        } else {
+            stats.max_count += digit == stats.max_digit;
+        }
+    }
+    return stats;
+}
+
+inline void histogram_scalar(std::string_view text, std::uint64_t counts[10]) {
+    for (char c : text) {
+        unsigned digit = static_cast<unsigned char>(c) - '0';
+        if (digit <= 9) ++counts[digit];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2
+////////////////////////////////////////////////////////////////////////////////
+
+// Цифра + 1 (1..10) для байтов-цифр, 0 для остальных
+__attribute__((target("avx2")))
+inline __m256i digit_codes(__m256i bytes) {
+    const __m256i values = _mm256_sub_epi8(bytes, _mm256_set1_epi8('0'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(values, _mm256_set1_epi8(9)), values);
+    return _mm256_and_si256(_mm256_add_epi8(values, _mm256_set1_epi8(1)), is_digit);
+}
+
+// Горизонтальный максимум байтов
+__attribute__((target("avx2")))
+inline int max_byte(__m256i v) {
+    __m128i m = _mm_max_epu8(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 8));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 4));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 2));
+    m = _mm_max_epu8(m, _mm_srli_si128(m, 1));
+    return _mm_cvtsi128_si32(m) & 0xff;
+}
+
+// Последние неполные 32 байта, байты за концом - нули (не цифры)
+// Копия в буфер на стеке: чтение за концом строки вызывающего - UB, даже
+// если не пересекает границу страницы
+__attribute__((target("avx2")))
+inline __m256i load_tail(const char* data, std::size_t size) {
+    alignas(32) char buffer[32] = {};
+    std::memcpy(buffer, data, size);
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(buffer));
+}
+
+// Два прохода: максимум кодов, затем число совпадений с ним
+// (запись до 32 байт - один регистр на оба прохода)
+__attribute__((target("avx2")))
+inline DigitStats max_digit_avx2(std::string_view text) {
+    const char* data = text.data();
+    const std::size_t full = text.size() & ~std::size_t(31);
+    const std::size_t rest = text.size() - full;
+
+    __m256i max = _mm256_setzero_si256();
+    for (std::size_t i = 0; i < full; i += 32) {
+        max = _mm256_max_epu8(max, digit_codes(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))));
+    }
+    const __m256i tail = rest ? digit_codes(load_tail(data + full, rest)) : _mm256_setzero_si256();
+    const int code = max_byte(_mm256_max_epu8(max, tail));
+    if (code == 0) return {};
+
+    const __m256i target = _mm256_set1_epi8(static_cast<char>(code));
+    std::uint64_t count = __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpeq_epi8(tail, target)));
+    for (std::size_t i = 0; i < full; i += 32) {
+        const __m256i codes = digit_codes(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        count += __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpeq_epi8(codes, target)));
+    }
+    return {code - 1, count};
+}
+
+// Счетчики по байтам (cmpeq дает -1, вычитание прибавляет 1) сбрасываются
+// в 64-битные через sad каждые 255 блоков, пока байт не переполнился
+__attribute__((target("avx2")))
+inline void histogram_avx2(std::string_view text, std::uint64_t counts[10]) {
+    const char* data = text.data();
+    const std::size_t full = text.size() & ~std::size_t(31);
+    const __m256i zero = _mm256_setzero_si256();
+
+    std::size_t i = 0;
+    while (i < full) {
+        __m256i acc[10];
+        for (int d = 0; d < 10; ++d) acc[d] = zero;
+        const std::size_t stop = i + std::min<std::size_t>(full - i, 255 * 32);
+        for (; i < stop; i += 32) {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            for (int d = 0; d < 10; ++d) {
+                acc[d] = _mm256_sub_epi8(acc[d], _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(static_cast<char>('0' + d))));
+            }
+        }
+        for (int d = 0; d < 10; ++d) {
+            const __m256i sums = _mm256_sad_epu8(acc[d], zero);
+            counts[d] += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1)
+                       + _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+        }
+    }
+    histogram_scalar(text.substr(full), counts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ВЫБОР ЯДРА
+////////////////////////////////////////////////////////////////////////////////
+
+inline bool avx2_supported() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+inline DigitStats max_digit(std::string_view text) {
+    return avx2_supported() ? max_digit_avx2(text) : max_digit_scalar(text);
+}
+
+// counts[d] увеличиваются на число цифр d в text
+inline void histogram(std::string_view text, std::uint64_t counts[10]) {
+    if (avx2_supported()) histogram_avx2(text, counts);
+    else histogram_scalar(text, counts);
+}
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Файловый ввод-вывод пакетных режимов:
+// - InputFile - файл целиком, отображенный в память только для чтения;
+//   разбор идет прямо по страницам файла без копирования
+// - OutputBuffer - буфер 1 МБ поверх дескриптора: запись форматируется
+//   прямо в буфер (reserve / commit), буфер уходит write() большими кусками
+//
+// Используется в lab1, lab2, lab3 и lab4 (пакетные режимы), lab5 (скрипты)
+// и table::Writer (common/table_output.hpp)
+
+namespace file_io {
+
+////////////////////////////////////////////////////////////////////////////////
+// ВХОД
+////////////////////////////////////////////////////////////////////////////////
+
+class InputFile {
+public:
+    explicit InputFile(const char* path) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        struct stat st;
+        ok_ = fstat(fd, &st) == 0;
+        if (ok_ && st.st_size > 0) { // Пустой файл - не ошибка, просто нет данных
+            void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ok_ = addr != MAP_FAILED;
+            if (ok_) {
+                data_ = static_cast<const char*>(addr);
+                size_ = st.st_size;
+                madvise(addr, size_, MADV_SEQUENTIAL);
+            }
+        }
+        close(fd);
+    }
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    ~InputFile() {
+        if (data_) munmap(const_cast<char*>(data_), size_);
+    }
+
+    bool ok() const { return ok_; }
+    std::string_view text() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool ok_ = false;
+};
+
+// Разделитель токенов - любой байт <= ' ' (пробелы, переводы строк, нули)
+inline bool is_space(char c) {
+    return static_cast<unsigned char>(c) <= ' ';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ВЫХОД
+////////////////////////////////////////////////////////////////////////////////
+
+class OutputBuffer {
+public:
+    static constexpr std::size_t capacity = 1 << 20;
+
+    explicit OutputBuffer(int fd) : fd_(fd), buffer_(new char[capacity]) {}
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    ~OutputBuffer() { flush(); }
+
+    // Место под запись до max_record байт
+    char* reserve(std::size_t max_record) {
+        if (capacity - used_ < max_record) flush();
+        return buffer_.get() + used_;
+    }
+
+    void commit(char* end) { used_ = end - buffer_.get(); }
+
+    // false - ошибка записи (она запоминается до конца работы)
+    bool flush() {
+        const char* pos = buffer_.get();
+        const char* end = pos + used_;
+        while (ok_ && pos < end) {
+            ssize_t n = ::write(fd_, pos, end - pos);
+            if (n < 0) ok_ = false;
+            else pos += n;
+        }
+        used_ = 0;
+        return ok_;
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    int fd_;
+    std::size_t used_ = 0;
+    bool ok_ = true;
+    std::unique_ptr<char[]> buffer_;
+};
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// Запуск работы на нескольких потоках без пула: потоки создаются на вызов,
+// вызывающий поток работает как поток 0
+//
+// Используется в lab3 (свертка по кускам файла), lab4 (radix сортировка и
+// подсчет по столбцам) и lab6 (поиск строк с нулями)
+
+namespace workers {
+
+// Потоков по умолчанию: hardware_concurrency() может вернуть 0
+inline unsigned hardware_threads() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Число потоков из аргумента командной строки: целое > 0 без хвоста,
+// больше hardware_threads() не нужно - ограничивается им.
+// nullopt - не число, хвост после числа или <= 0 ("-1" не становится 2^32 - 1)
+inline std::optional<unsigned> parse_thread_count(const char* text) {
+    const char* end = text + std::strlen(text);
+    long long value;
+    auto [last, ec] = std::from_chars(text, end, value);
+    if (ec == std::errc::result_out_of_range && *text != '-') value = hardware_threads(); // Огромное - тоже максимум
+    else if (ec != std::errc()) return std::nullopt;
+    if (last != end || value <= 0) return std::nullopt;
+    return static_cast<unsigned>(std::min<long long>(value, hardware_threads()));
+}
+
+// fn(t) для t в [0, threads): t = 0 - в вызывающем потоке
+template<typename F>
+void parallel_for(unsigned threads, F&& fn) {
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(fn, t);
+    fn(0u);
+    for (std::thread& worker : pool) worker.join();
+}
+
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_io.hpp"
+
+// Вывод массивов и матриц чисел:
+// - Writer - текст прямо в file_io::OutputBuffer (to_chars, без std::cout на
+//   каждый элемент); буфер уходит write(), когда заполнен, и в явных точках
+//   flush (вместо std::endl после каждой строки). Перед первой записью после
+//   flush сбрасывается stdout, поэтому порядок с std::cout (синхронизирован
+//   с stdio) сохраняется, если перед выводом в std::cout вызван flush
+// - write_binary / MappedMatrix - сырой дамп: заголовок 64 байта, затем
+//   строки подряд без шага, little-endian; читается обратно через mmap без
+//   разбора (данные выровнены на 64 байта от начала файла)
+//
+// Используется в lab4 (пункты 1, 2 и пакетные режимы), lab6 (вывод
+// матриц) и lab7 (print_arr)
+
+namespace table {
+
+static_assert(std::endian::native == std::endian::little, "binary dump is the raw in-memory little-endian layout");
+
+////////////////////////////////////////////////////////////////////////////////
+// ТЕКСТ
+////////////////////////////////////////////////////////////////////////////////
+
+class Writer {
+public:
+    explicit Writer(int fd = STDOUT_FILENO) : out_(fd) {}
+
+    Writer& text(std::string_view s) {
+        // Текст длиннее буфера уходит кусками по размеру буфера
+        while (!s.empty()) {
+            const std::size_t size = std::min(s.size(), file_io::OutputBuffer::capacity);
+            char* p = reserve(size);
+            std::memcpy(p, s.data(), size);
+            out_.commit(p + size);
+            s.remove_prefix(size);
+        }
+        return *this;
+    }
+
+    Writer& text(char c) {
+        char* p = reserve(1);
+        *p++ = c;
+        out_.commit(p);
+        return *this;
+    }
+
+    // Целые - как std::cout; дробные - кратчайшая запись, которая читается
+    // обратно в то же число (std::cout печатает 6 значащих цифр)
+    template<typename T>
+    Writer& value(T x) {
+        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>);
+        char* p = reserve(max_width<T>);
+        out_.commit(std::to_chars(p, p + max_width<T>, x).ptr);
+        return *this;
+    }
+
+    // Элементы строки, после каждого separator (как "x\t" в лабах), затем "\n"
+    template<typename T>
+    Writer& row(std::span<const T> values, char separator = '\t') {
+        for (T x : values) {
+            char* p = reserve(max_width<T> + 1);
+            p = std::to_chars(p, p + max_width<T>, x).ptr;
+            *p++ = separator;
+            out_.commit(p);
+        }
+        return text('\n');
+    }
+
+    // rows x cols, начала строк через stride элементов
+    template<typename T>
+    Writer& matrix(const T* data, std::size_t rows, std::size_t cols, std::size_t stride, char separator = '\t') {
+        for (std::size_t i = 0; i < rows; ++i) row(std::span<const T>(data + i * stride, cols), separator);
+        return *this;
+    }
+
+    // Буфер - в дескриптор; false, если запись не удалась (сейчас или раньше)
+    bool flush() {
+        pending_ = false;
+        return out_.flush();
+    }
+
+    bool ok() const { return out_.ok(); }
+
+private:
+    template<typename T>
+    static constexpr std::size_t max_width = std::is_floating_point_v<T>
+        ? std::numeric_limits<T>::max_digits10 + 8        // Знак, точка, e-308
+        : std::numeric_limits<T>::digits10 + 2;          // Знак и неполная старшая цифра
+
+    char* reserve(std::size_t size) {
+        if (!pending_) {
+            std::fflush(stdout); // Вывод std::cout до этой записи уходит первым
+            pending_ = true;
+        }
+        return out_.reserve(size);
+    }
+
+    file_io::OutputBuffer out_;
+    bool pending_ = false;  // В буфере есть данные после последнего flush
+};
+
+// Общий Writer для stdout: буфер выделяется один раз на процесс
+inline Writer& standard_output() {
+    static Writer writer(STDOUT_FILENO);
+    return writer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ДВОИЧНЫЙ ДАМП
+////////////////////////////////////////////////////////////////////////////////
+
+enum class Kind : std::uint16_t { unsigned_integer = 0, signed_integer = 1, floating = 2 };
+
+struct BinaryHeader {
+    char magic[4] = {'L', 'M', 'A', 'T'};
+    std::uint16_t version = 1;
+    std::uint16_t header_size = 64;     // Смещение данных от начала файла
+    std::uint16_t element_size = 0;
+    Kind kind = Kind::signed_integer;
+    std::uint32_t reserved = 0;
+    std::uint64_t rows = 0;
+    std::uint64_t cols = 0;
+    char padding[32] = {};
+};
+static_assert(sizeof(BinaryHeader) == 64);
+
+template<typename T>
+constexpr Kind kind_of() {
+    static_assert(std::is_arithmetic_v<T>);
+    if constexpr (std::is_floating_point_v<T>) return Kind::floating;
+    else if constexpr (std::is_signed_v<T>) return Kind::signed_integer;
+    else return Kind::unsigned_integer;
+}
+
+template<typename T>
+BinaryHeader header_for(std::size_t rows, std::size_t cols) {
+    BinaryHeader header;
+    header.element_size = sizeof(T);
+    header.kind = kind_of<T>();
+    header.rows = rows;
+    header.cols = cols;
+    return header;
+}
+
+// Заголовок и строки rows x cols (шаг stride убирается); false при ошибке
+// записи. Строки без зазоров уходят одним fwrite
+template<typename T>
+bool write_binary(std::FILE* file, const T* data, std::size_t rows, std::size_t cols, std::size_t stride) {
+    const BinaryHeader header = header_for<T>(rows, cols);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    if (stride == cols || rows <= 1) {
+        ok = ok && (rows * cols == 0 || std::fwrite(data, sizeof(T), rows * cols, file) == rows * cols);
+    } else {
+        for (std::size_t i = 0; ok && i < rows; ++i) ok = std::fwrite(data + i * stride, sizeof(T), cols, file) == cols;
+    }
+    return std::fflush(file) == 0 && ok;
+}
+
+template<typename T>
+bool write_binary(const char* path, const T* data, std::size_t rows, std::size_t cols, std::size_t stride) {
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    bool ok = write_binary(file, data, rows, cols, stride);
+    return std::fclose(file) == 0 && ok;
+}
+
+// Дамп, открытый через mmap: данные читаются прямо из страниц файла.
+// ok() - файл открылся, заголовок совпал с T и файл не короче данных
+template<typename T>
+class MappedMatrix {
+public:
+    explicit MappedMatrix(const char* path) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(BinaryHeader)) {
+            size_ = st.st_size;
+            void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) map_ = static_cast<const char*>(p);
+        }
+        close(fd);
+        if (!map_) return;
+
+        std::memcpy(&header_, map_, sizeof(header_));
+        const BinaryHeader expected = header_for<T>(header_.rows, header_.cols);
+        ok_ = std::memcmp(header_.magic, expected.magic, sizeof(expected.magic)) == 0
+            && header_.version == expected.version && header_.header_size >= sizeof(BinaryHeader)
+            && header_.header_size % alignof(T) == 0
+            && header_.element_size == expected.element_size && header_.kind == expected.kind
+            && header_.header_size <= size_
+            && (header_.cols == 0 || header_.rows <= (size_ - header_.header_size) / sizeof(T) / header_.cols);
+    }
+
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+    ~MappedMatrix() {
+        if (map_) munmap(const_cast<char*>(map_), size_);
+    }
+
+    bool ok() const { return ok_; }
+    std::size_t rows() const { return header_.rows; }
+    std::size_t cols() const { return header_.cols; }
+    const T* data() const { return reinterpret_cast<const T*>(map_ + header_.header_size); }
+    std::span<const T> row(std::size_t i) const { return {data() + i * cols(), cols()}; }
+
+private:
+    const char* map_ = nullptr;
+    std::size_t size_ = 0;
+    BinaryHeader header_;
+    bool ok_ = false;
+};
+
+}
@@ -0,0 +1,115 @@
+// Пропускная способность (радиусов в секунду): поштучный путь из lab1.cpp
+// против пакетного режима (sphere_batch.hpp)
+//
+// - per_value: std::istream >> R, pow(), std::ostream << V << S (как lab1.cpp)
+// - batch_<ядро>: mmap + from_chars, SIMD ядро, to_chars (весь конвейер)
+// - kernel_<ядро>: только вычисление над блоком конвейера в кэше
+//
+// Вход - временный текстовый файл со случайными радиусами, выход - /dev/null
+//
+// g++ -O2 bench/lab1_bench.cpp -o bench_out && ./bench_out [радиусов]
+
+#include "../sphere_batch.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define PI 13.1415 // как в lab1.cpp
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void report(const char* name, std::size_t count, double seconds) {
+    std::printf("  %-16s %10.3f s %14.0f radii/s\n", name, seconds, count / seconds);
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string path = "/tmp/lab1-bench-" + std::to_string(getpid()) + ".txt";
+
+    // Вход: радиусы с разным числом знаков
+    {
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> dist(0.0, 1000.0);
+        std::vector<char> text;
+        text.reserve(count * 20);
+        char buffer[32];
+        for (std::size_t i = 0; i < count; ++i) {
+            char* end = std::to_chars(buffer, buffer + sizeof(buffer), dist(rng)).ptr;
+            text.insert(text.end(), buffer, end);
+            text.push_back(i % 8 == 7 ? '\n' : ' ');
+        }
+        std::ofstream(path, std::ios::binary).write(text.data(), text.size());
+    }
+    std::printf("%zu radii, %s\n", count, sphere::kernel_name(sphere::best_kernel()));
+
+    // Поштучный путь
+    {
+        auto start = Clock::now();
+        std::ifstream in(path);
+        std::ofstream out("/dev/null");
+        double R;
+        std::size_t n = 0;
+        while (in >> R) {
+            out << (4/3) * PI * pow(R, 3) << ' ' << 4 * PI * pow(R, 2) << '\n';
+            ++n;
+        }
+        report("per_value", n, seconds_since(start));
+    }
+
+    // Пакетный режим на каждом поддерживаемом ядре
+    std::vector<sphere::Kernel> kernels = {sphere::compute_scalar};
+    if (__builtin_cpu_supports("avx2")) kernels.push_back(sphere::compute_avx2);
+    if (__builtin_cpu_supports("avx512f")) kernels.push_back(sphere::compute_avx512);
+
+    int null_fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    for (sphere::Kernel kernel : kernels) {
+        auto start = Clock::now();
+        file_io::InputFile input(path.c_str());
+        sphere::RadiusParser parser(input.text(), false);
+        file_io::OutputBuffer writer(null_fd);
+        sphere::BatchResult result = sphere::run(parser, writer, kernel, (4/3) * PI, 4 * PI);
+        writer.flush();
+        report((std::string("batch_") + sphere::kernel_name(kernel)).c_str(), result.count, seconds_since(start));
+    }
+    close(null_fd);
+
+    // Только вычисление: блок конвейера (block_size радиусов) в кэше
+    {
+        file_io::InputFile input(path.c_str());
+        sphere::RadiusParser parser(input.text(), false);
+        alignas(64) double r[sphere::block_size], v[sphere::block_size], s[sphere::block_size];
+        std::size_t n = parser.next(r, sphere::block_size);
+        std::size_t repeats = std::max<std::size_t>(count * 10 / std::max<std::size_t>(n, 1), 1);
+
+        for (sphere::Kernel kernel : kernels) {
+            auto start = Clock::now();
+            for (std::size_t i = 0; i < repeats; ++i) {
+                kernel(r, v, s, n, (4/3) * PI, 4 * PI);
+                asm volatile("" : : "r"(v), "r"(s) : "memory");
+            }
+            report((std::string("kernel_") + sphere::kernel_name(kernel)).c_str(), n * repeats, seconds_since(start));
+        }
+
+        // Все ядра дают одинаковые биты
+        bool same = true;
+        double v0[sphere::block_size], s0[sphere::block_size];
+        sphere::compute_scalar(r, v0, s0, n, (4/3) * PI, 4 * PI);
+        for (sphere::Kernel kernel : kernels) {
+            kernel(r, v, s, n, (4/3) * PI, 4 * PI);
+            same = same && std::memcmp(v, v0, n * sizeof(double)) == 0 && std::memcmp(s, s0, n * sizeof(double)) == 0;
+        }
+        std::printf("  kernels agree: %s\n", same ? "yes" : "NO");
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -1,9 +1,63 @@
 #include <iostream>
 #include <cmath>
 #include <limits>
+#include <cstring>
+#include "sphere_batch.hpp"
 #define PI 13.1415 
 
-int main() {
+// Пакетный режим: ./out --batch <вход> [выход] [--binary]
+// Вход - текст (радиусы через пробелы/переводы строк) или, с --binary, подряд
+// идущие double; на выходе по строке "V S" на радиус (stdout, если файл не задан)
+int batch(int argc, char** argv) {
+    const char* input_path = nullptr;
+    const char* output_path = nullptr;
+    bool binary = false;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--binary") == 0) binary = true;
+        else if (!input_path) input_path = argv[i];
+        else output_path = argv[i];
+    }
+    if (!input_path) {
+        std::cerr << "usage: " << argv[0] << " --batch <input> [output] [--binary]" << std::endl;
+        return 2;
+    }
+
+    file_io::InputFile input(input_path);
+    if (!input.ok()) {
+        std::cerr << "cannot read " << input_path << std::endl;
+        return 1;
+    }
+    int out_fd = output_path ? open(output_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : STDOUT_FILENO;
+    if (out_fd < 0) {
+        std::cerr << "cannot write " << output_path << std::endl;
+        return 1;
+    }
+
+    sphere::RadiusParser parser(input.text(), binary);
+    sphere::BatchResult result;
+    bool written;
+    {
+        file_io::OutputBuffer writer(out_fd);
+        // Те же коэффициенты, что и в формулах ниже
+        result = sphere::run(parser, writer, sphere::best_kernel(), (4/3) * PI, 4 * PI);
+        written = writer.flush();
+    }
+    if (output_path) close(out_fd);
+
+    if (result.error) {
+        std::cerr << "bad value at byte " << (result.error - input.text().data()) << std::endl;
+        return 1;
+    }
+    if (!written) {
+        std::cerr << "write error" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) return batch(argc, argv);
+
     double R; // Не сказанно, что радиус - целое => число с плав. точкой (и что бы явно не приводить типы позже)
     // double - 64bit (1 - знак, 10 - экспонента, 53 - мантисса) ~ 1,7 * 10^308 значений (без учета периодических чисел в 2 СС)
 
@@ -24,4 +78,5 @@ int main() {
 
     return 0;
 }
-// g++ lab1.cpp -o out && ./out < ../input.txt
\ No newline at end of file
+// g++ lab1.cpp -o out && ./out < ../input.txt
+// g++ -O2 lab1.cpp -o out && ./out --batch radii.txt volumes.txt
\ No newline at end of file
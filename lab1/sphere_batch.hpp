@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <immintrin.h>
+#include "../common/file_io.hpp"
+
+// Пакетный режим: те же формулы, что и для одного радиуса, но над файлами
+// из сотен миллионов значений
+//
+// Конвейер идет блоками по block_size радиусов, поэтому память не растет
+// с размером входа:
+//   file_io::InputFile (mmap) -> RadiusParser (from_chars) -> compute (SIMD) -> write_results (to_chars)
+//
+// pow(R, 3) и pow(R, 2) заменены умножениями: R*R*R может отличаться от pow
+// в последнем бите, но все ядра (scalar/AVX2/AVX-512) считают одинаково
+// (без FMA), поэтому результат не зависит от процессора
+
+namespace sphere {
+
+constexpr std::size_t block_size = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+// ВХОД
+////////////////////////////////////////////////////////////////////////////////
+
+// Текст: радиусы через пробелы/переводы строк
+// Бинарный вход: подряд идущие double (порядок байт машины)
+class RadiusParser {
+public:
+    RadiusParser(std::string_view input, bool binary) : pos_(input.data()), end_(input.data() + input.size()), binary_(binary) {}
+
+    // Следующий блок (до max значений); 0 - вход кончился или ошибка (см. error())
+    std::size_t next(double* out, std::size_t max) {
+        if (binary_) {
+            std::size_t count = std::min<std::size_t>(max, (end_ - pos_) / sizeof(double));
+            std::memcpy(out, pos_, count * sizeof(double));
+            pos_ += count * sizeof(double);
+            if (count == 0 && pos_ != end_) error_ = pos_; // Хвост короче double
+            return count;
+        }
+
+        std::size_t count = 0;
+        while (count < max) {
+            while (pos_ < end_ && is_space(*pos_)) ++pos_;
+            if (pos_ == end_) break;
+            auto [next, ec] = std::from_chars(pos_, end_, out[count]);
+            if (ec != std::errc() || (next < end_ && !is_space(*next))) {
+                error_ = pos_;
+                return count;
+            }
+            pos_ = next;
+            ++count;
+        }
+        return count;
+    }
+
+    // Позиция нераспознанного значения (nullptr - ошибок нет)
+    const char* error() const { return error_; }
+
+private:
+    static bool is_space(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+    const char* pos_;
+    const char* end_;
+    const char* error_ = nullptr;
+    bool binary_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ВЫЧИСЛЕНИЕ
+////////////////////////////////////////////////////////////////////////////////
+
+// V = volume_factor * R^3, S = area_factor * R^2
+using Kernel = void (*)(const double* r, double* v, double* s, std::size_t n, double volume_factor, double area_factor);
+
+inline void compute_scalar(const double* r, double* v, double* s, std::size_t n, double volume_factor, double area_factor) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double r2 = r[i] * r[i];
+        v[i] = volume_factor * (r2 * r[i]);
+        s[i] = area_factor * r2;
+    }
+}
+
+__attribute__((target("avx2")))
+inline void compute_avx2(const double* r, double* v, double* s, std::size_t n, double volume_factor, double area_factor) {
+    const __m256d vf = _mm256_set1_pd(volume_factor);
+    const __m256d af = _mm256_set1_pd(area_factor);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(r + i);
+        __m256d x2 = _mm256_mul_pd(x, x);
+        _mm256_storeu_pd(v + i, _mm256_mul_pd(vf, _mm256_mul_pd(x2, x)));
+        _mm256_storeu_pd(s + i, _mm256_mul_pd(af, x2));
+    }
+    compute_scalar(r + i, v + i, s + i, n - i, volume_factor, area_factor);
+}
+
+__attribute__((target("avx512f")))
+inline void compute_avx512(const double* r, double* v, double* s, std::size_t n, double volume_factor, double area_factor) {
+    const __m512d vf = _mm512_set1_pd(volume_factor);
+    const __m512d af = _mm512_set1_pd(area_factor);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d x = _mm512_loadu_pd(r + i);
+        __m512d x2 = _mm512_mul_pd(x, x);
+        _mm512_storeu_pd(v + i, _mm512_mul_pd(vf, _mm512_mul_pd(x2, x)));
+        _mm512_storeu_pd(s + i, _mm512_mul_pd(af, x2));
+    }
+    // Хвост - маской, без скалярного цикла
+    if (i < n) {
+        __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+        __m512d x = _mm512_maskz_loadu_pd(mask, r + i);
+        __m512d x2 = _mm512_mul_pd(x, x);
+        _mm512_mask_storeu_pd(v + i, mask, _mm512_mul_pd(vf, _mm512_mul_pd(x2, x)));
+        _mm512_mask_storeu_pd(s + i, mask, _mm512_mul_pd(af, x2));
+    }
+}
+
+// Лучшее ядро для текущего процессора
+inline Kernel best_kernel() {
+    if (__builtin_cpu_supports("avx512f")) return compute_avx512;
+    if (__builtin_cpu_supports("avx2")) return compute_avx2;
+    return compute_scalar;
+}
+
+inline const char* kernel_name(Kernel kernel) {
+    if (kernel == compute_avx512) return "avx512";
+    if (kernel == compute_avx2) return "avx2";
+    return "scalar";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ВЫХОД
+////////////////////////////////////////////////////////////////////////////////
+
+// Строки "V S\n" через to_chars (кратчайшая запись, однозначно читаемая
+// обратно) в общий буфер вывода
+inline void write_results(file_io::OutputBuffer& out, const double* v, const double* s, std::size_t n) {
+    constexpr std::size_t max_record = 64; // Две записи double по <= 24 символа + разделители
+    for (std::size_t i = 0; i < n; ++i) {
+        char* pos = out.reserve(max_record);
+        char* end = pos + max_record;
+        pos = std::to_chars(pos, end, v[i]).ptr;
+        *pos++ = ' ';
+        pos = std::to_chars(pos, end, s[i]).ptr;
+        *pos++ = '\n';
+        out.commit(pos);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// КОНВЕЙЕР
+////////////////////////////////////////////////////////////////////////////////
+
+struct BatchResult {
+    std::size_t count = 0;           // Обработано радиусов
+    const char* error = nullptr;     // Позиция ошибки разбора во входе
+};
+
+// Разбор, вычисление и вывод блоками
+inline BatchResult run(RadiusParser& parser, file_io::OutputBuffer& out, Kernel kernel, double volume_factor, double area_factor) {
+    alignas(64) double r[block_size], v[block_size], s[block_size];
+    BatchResult result;
+    while (std::size_t n = parser.next(r, block_size)) {
+        kernel(r, v, s, n, volume_factor, area_factor);
+        write_results(out, v, s, n);
+        result.count += n;
+    }
+    result.error = parser.error();
+    return result;
+}
+
+}
@@ -0,0 +1,155 @@
+// Поштучная обработка запросов (логика lab2.cpp: std::cin/std::cout,
+// bitset::to_string(), вложенные тернарные операторы) против пакетного
+// режима (query_batch.hpp). Выводы обоих путей сравниваются побайтно.
+//
+// - per_value: сеанс за сеансом из std::ifstream в std::ofstream
+// - batch_<ядро>: mmap + from_chars, правило A/B/C ядром, вывод через таблицы
+// - rules_<ядро>: только правило A/B/C над блоком в кэше
+//
+// g++ -O2 bench/lab2_bench.cpp -o bench_out && ./bench_out [сеансов]
+
+#include "../query_batch.hpp"
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void report(const char* name, std::size_t count, double seconds) {
+    std::printf("  %-16s %10.3f s %14.0f queries/s\n", name, seconds, count / seconds);
+}
+
+// Один сеанс программы lab2.cpp (main с потоками вместо std::cin/std::cout)
+static bool original_session(std::istream& in, std::ostream& out) {
+    out<<"Enter A, i: ";
+    int A, B, C, i;
+    if (!(in>>A>>i)) return false;
+
+    if (!(1 <= i && i <= (int)sizeof(int)*8)) {
+        out<<"Wrong input\n";
+        return true;
+    }
+    if (!(A&(1<<(i-1)))){
+        out<<"Bit i ("<<i<<") is 0;\nbinary A is:\n";
+        out<<(std::bitset<sizeof(int)*8>(A).to_string())<<std::endl;
+    }else {
+        out<<"Enter A, B, C: "; in>>A>>B>>C;
+        out<< (((A < B && B < C)) ? C-B-A : (A%C==0) ? A/C+B : A+B+C)<<std::endl;
+    }
+
+    out<<"Enter month number: ";
+    int N; in>>N;
+    switch (N){
+        case 1: case 3: case 5: case 7: case 8: case 10: case 12:
+            out<<"Days: 30"<<std::endl;
+            break;
+        case 4: case 6: case 9: case 11:
+            out<<"Days: 31"<<std::endl;
+            break;
+        case 2:
+            out<<"Days: 28"<<std::endl;
+            break;
+        default:
+            out<<"Wrong input";
+    }
+    return true;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), {}};
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    std::string base = "/tmp/lab2-bench-" + std::to_string(getpid());
+    std::string input_path = base + ".txt", reference_path = base + ".ref", batch_path = base + ".out";
+
+    // Сеансы: ~10% с i вне диапазона, биты A случайны, C != 0
+    // (малые C, чтобы встречались и делимость, и A < B < C)
+    {
+        std::mt19937 rng(42);
+        std::ofstream out(input_path);
+        for (std::size_t k = 0; k < count; ++k) {
+            int a = static_cast<int>(rng());
+            int i = rng() % 10 == 0 ? static_cast<int>(rng() % 8) * 5 : static_cast<int>(rng() % 32) + 1;
+            out<<a<<' '<<i<<'\n';
+            if (!(1 <= i && i <= 32)) continue;
+            if (a & (1 << (i - 1))) {
+                int c = static_cast<int>(rng() % 41) - 20;
+                out<<static_cast<int>(rng() % 2001) - 1000<<' '<<static_cast<int>(rng() % 2001) - 1000<<' '<<(c ? c : 7)<<'\n';
+            }
+            out<<rng() % 15<<'\n';
+        }
+    }
+    std::printf("%zu queries, %s\n", count, bitquery::kernel_name(bitquery::best_kernel()));
+
+    {
+        auto start = Clock::now();
+        std::ifstream in(input_path);
+        std::ofstream out(reference_path);
+        std::size_t n = 0;
+        while (in>>std::ws, !in.eof() && original_session(in, out)) ++n;
+        out.flush();
+        report("per_value", n, seconds_since(start));
+    }
+    std::string reference = read_file(reference_path);
+
+    std::vector<bitquery::RuleKernel> kernels = {bitquery::rules_scalar};
+    if (__builtin_cpu_supports("avx2")) kernels.push_back(bitquery::rules_avx2);
+
+    bool same = true;
+    for (bitquery::RuleKernel kernel : kernels) {
+        auto start = Clock::now();
+        bitquery::BatchResult result;
+        {
+            file_io::InputFile input(input_path.c_str());
+            bitquery::QueryParser parser(input.text());
+            int fd = open(batch_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            {
+                file_io::OutputBuffer out(fd);
+                result = bitquery::run(parser, out, kernel);
+            }
+            close(fd);
+        }
+        report((std::string("batch_") + bitquery::kernel_name(kernel)).c_str(), result.count, seconds_since(start));
+        same = same && read_file(batch_path) == reference;
+    }
+    std::printf("  output matches per_value: %s\n", same ? "yes" : "NO");
+
+    // Только правило: блок с A, B, C в кэше
+    {
+        alignas(32) int a[bitquery::block_size], b[bitquery::block_size], c[bitquery::block_size], out[bitquery::block_size];
+        std::mt19937 rng(7);
+        for (std::size_t k = 0; k < bitquery::block_size; ++k) {
+            a[k] = static_cast<int>(rng() % 2001) - 1000;
+            b[k] = static_cast<int>(rng() % 2001) - 1000;
+            c[k] = static_cast<int>(rng() % 40) + 1;
+        }
+        std::size_t repeats = std::max<std::size_t>(count * 10 / bitquery::block_size, 1);
+        for (bitquery::RuleKernel kernel : kernels) {
+            auto start = Clock::now();
+            for (std::size_t r = 0; r < repeats; ++r) {
+                kernel(a, b, c, out, bitquery::block_size);
+                asm volatile("" : : "r"(out) : "memory");
+            }
+            report((std::string("rules_") + bitquery::kernel_name(kernel)).c_str(), bitquery::block_size * repeats, seconds_since(start));
+        }
+    }
+
+    std::remove(input_path.c_str());
+    std::remove(reference_path.c_str());
+    std::remove(batch_path.c_str());
+    return same ? 0 : 1;
+}
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <bitset>
+#include <cstring>
+#include "query_batch.hpp"
 
 void print_bin(int x) {
     if (!x) return;
@@ -7,7 +9,53 @@ void print_bin(int x) {
     std::cout<<x%2;
 }
 
-int main() {
+// Пакетный режим: ./out --batch <вход> [выход]
+// Вход - подряд идущие сеансы в формате ввода программы (см. query_batch.hpp),
+// вывод совпадает с выводом программы на каждом сеансе (stdout, если файл не задан)
+int batch(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr<<"usage: "<<argv[0]<<" --batch <input> [output]"<<std::endl;
+        return 2;
+    }
+    file_io::InputFile input(argv[2]);
+    if (!input.ok()) {
+        std::cerr<<"cannot read "<<argv[2]<<std::endl;
+        return 1;
+    }
+    int out_fd = argc > 3 ? open(argv[3], O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : STDOUT_FILENO;
+    if (out_fd < 0) {
+        std::cerr<<"cannot write "<<argv[3]<<std::endl;
+        return 1;
+    }
+
+    bitquery::QueryParser parser(input.text());
+    bitquery::BatchResult result;
+    bool written;
+    {
+        file_io::OutputBuffer out(out_fd);
+        result = bitquery::run(parser, out, bitquery::best_kernel());
+        written = out.flush();
+    }
+    if (argc > 3) close(out_fd);
+
+    if (result.division_error) {
+        std::cerr<<"division by zero in query "<<(result.count + 1)<<std::endl;
+        return 1;
+    }
+    if (result.error) {
+        std::cerr<<"bad or incomplete query at byte "<<(result.error - input.text().data())<<std::endl;
+        return 1;
+    }
+    if (!written) {
+        std::cerr<<"write error"<<std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--batch") == 0) return batch(argc, argv);
+
     /*
     лаба 2 вариант 4
 
@@ -56,4 +104,6 @@ int main() {
     return 0;
 }
 //  ./build/bin/lab2 
-// g++ lab2.cpp -o out && ./out < input0.txt && ./out < input1.txt && ./out < input2.txt && ./out < input3.txt && ./out < input4.txt
\ No newline at end of file
+// g++ lab2.cpp -o out && ./out < input0.txt && ./out < input1.txt && ./out < input2.txt && ./out < input3.txt && ./out < input4.txt
+// cat input*.txt > all.txt && ./out --batch all.txt
+// ./out --batch batch_truncated.txt  -> "bad or incomplete query at byte 12"
\ No newline at end of file
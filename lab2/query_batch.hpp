@@ -0,0 +1,312 @@
+#pragma once
+
+#include <charconv>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <immintrin.h>
+#include "../common/file_io.hpp"
+
+// Пакетный режим: поток запросов в том же формате, что и ввод программы,
+// один "сеанс" за другим:
+//   A i            - i вне [1, 32]: "Wrong input", сеанс закончен
+//   A i N          - бит i равен 0: двоичная запись A, затем месяц N
+//   A i A B C N    - бит i равен 1: правило A/B/C, затем месяц N
+// Вывод побайтно совпадает с выводом программы, запущенной на каждом сеансе
+// отдельно (вместе с приглашениями "Enter ...").
+//
+// Обработка блоками по block_size сеансов:
+// 1) разбор (from_chars) и разбиение на сеансы - последовательно: длина
+//    сеанса зависит от бита i, поэтому бит проверяется здесь же (одно AND)
+// 2) правило A/B/C для всех сеансов блока с битом 1 - без ветвлений,
+//    AVX2 по 8 запросов (деление - через double, оно точно для int32)
+// 3) вывод в общий буфер: двоичная запись - по таблице байт -> 8 символов,
+//    числа - to_chars, дни месяца - по таблице; без выделений памяти на запрос
+
+namespace bitquery {
+
+constexpr std::size_t block_size = 4096;
+constexpr int bits = sizeof(int) * 8;
+
+////////////////////////////////////////////////////////////////////////////////
+// ВХОД
+////////////////////////////////////////////////////////////////////////////////
+
+enum Kind : std::uint8_t {
+    wrong_bit,  // i вне диапазона
+    bit_zero,
+    bit_one
+};
+
+// Блок сеансов: общие поля по сеансам, входы правила - плотно, только
+// для сеансов с битом 1 (в том же порядке)
+struct Block {
+    std::size_t count = 0;
+    std::size_t rules = 0;
+    Kind kind[block_size];
+    int a[block_size], i[block_size], n[block_size];
+    alignas(32) int rule_a[block_size];
+    alignas(32) int rule_b[block_size];
+    alignas(32) int rule_c[block_size];
+    alignas(32) int rule_result[block_size];
+};
+
+// Разбор потока сеансов
+class QueryParser {
+public:
+    explicit QueryParser(std::string_view input) : pos_(input.data()), end_(input.data() + input.size()) {}
+
+    // Следующий блок; false - вход кончился или ошибка (см. error())
+    bool next(Block& block) {
+        block.count = 0;
+        block.rules = 0;
+        while (block.count < block_size) {
+            skip_spaces();
+            if (pos_ == end_) break;
+
+            const char* start = pos_;
+            std::size_t k = block.count;
+            int a, i;
+            if (!read(a) || !read(i)) return fail(start);
+            block.a[k] = a;
+            block.i[k] = i;
+
+            if (!(1 <= i && i <= bits)) {
+                block.kind[k] = wrong_bit;
+            } else if (!(a & (1 << (i - 1)))) {
+                block.kind[k] = bit_zero;
+                if (!read(block.n[k])) return fail(start);
+            } else {
+                block.kind[k] = bit_one;
+                // Правило засчитывается только целиком: иначе ядро получит
+                // недочитанный слот (c == 0 - ложное деление на 0)
+                const std::size_t r = block.rules;
+                if (!read(block.rule_a[r]) || !read(block.rule_b[r]) || !read(block.rule_c[r]) || !read(block.n[k])) {
+                    return fail(start);
+                }
+                block.rules = r + 1;
+            }
+            ++block.count;
+        }
+        return block.count > 0;
+    }
+
+    // Начало сеанса, который не удалось разобрать (nullptr - ошибок нет)
+    const char* error() const { return error_; }
+
+private:
+    static bool is_space(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+    void skip_spaces() {
+        while (pos_ < end_ && is_space(*pos_)) ++pos_;
+    }
+
+    bool read(int& value) {
+        skip_spaces();
+        auto [next, ec] = std::from_chars(pos_, end_, value);
+        if (ec != std::errc() || (next < end_ && !is_space(*next))) return false;
+        pos_ = next;
+        return true;
+    }
+
+    // Неполный последний сеанс или не число; уже разобранные сеансы блока сохраняются
+    bool fail(const char* start) {
+        error_ = start;
+        pos_ = end_;
+        return false;
+    }
+
+    const char* pos_;
+    const char* end_;
+    const char* error_ = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// ПРАВИЛО A/B/C
+////////////////////////////////////////////////////////////////////////////////
+
+// A < B < C ? C-B-A : A%C == 0 ? A/C+B : A+B+C (переполнение - по модулю 2^32)
+// Возвращает false, если где-то понадобилось деление на 0 или INT_MIN / -1
+// (исходная программа на них падает)
+using RuleKernel = bool (*)(const int* a, const int* b, const int* c, int* out, std::size_t n);
+
+inline bool rules_scalar(const int* a, const int* b, const int* c, int* out, std::size_t n) {
+    bool ok = true;
+    for (std::size_t k = 0; k < n; ++k) {
+        unsigned ua = a[k], ub = b[k], uc = c[k];
+        if (a[k] < b[k] && b[k] < c[k]) {
+            out[k] = static_cast<int>(uc - ub - ua);
+        } else if (c[k] == 0 || (a[k] == INT_MIN && c[k] == -1)) {
+            ok = false;
+            out[k] = 0;
+        } else {
+            out[k] = a[k] % c[k] == 0 ? static_cast<int>(static_cast<unsigned>(a[k] / c[k]) + ub)
+                                      : static_cast<int>(ua + ub + uc);
+        }
+    }
+    return ok;
+}
+
+// Частное 4 пар int32 через double: для |x| < 2^31 округление к нулю
+// после деления в double дает то же, что и целочисленное деление
+__attribute__((target("avx2")))
+inline __m128i quotient_epi32(__m128i a, __m128i c) {
+    return _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(a), _mm256_cvtepi32_pd(c)));
+}
+
+__attribute__((target("avx2")))
+inline bool rules_avx2(const int* a, const int* b, const int* c, int* out, std::size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i int_min = _mm256_set1_epi32(INT_MIN);
+    const __m256i minus_one = _mm256_set1_epi32(-1);
+    __m256i errors = zero;
+    std::size_t k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+        __m256i vc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + k));
+
+        __m256i ordered = _mm256_and_si256(_mm256_cmpgt_epi32(vb, va), _mm256_cmpgt_epi32(vc, vb));
+        // Недопустимый делитель заменяется на 1, чтобы не получить inf/nan
+        __m256i bad = _mm256_or_si256(_mm256_cmpeq_epi32(vc, zero),
+                                      _mm256_and_si256(_mm256_cmpeq_epi32(va, int_min), _mm256_cmpeq_epi32(vc, minus_one)));
+        __m256i divisor = _mm256_blendv_epi8(vc, _mm256_set1_epi32(1), bad);
+        __m256i q = _mm256_setr_m128i(quotient_epi32(_mm256_castsi256_si128(va), _mm256_castsi256_si128(divisor)),
+                                      quotient_epi32(_mm256_extracti128_si256(va, 1), _mm256_extracti128_si256(divisor, 1)));
+        __m256i divisible = _mm256_cmpeq_epi32(_mm256_sub_epi32(va, _mm256_mullo_epi32(q, divisor)), zero);
+
+        __m256i result = _mm256_blendv_epi8(_mm256_add_epi32(_mm256_add_epi32(va, vb), vc),
+                                            _mm256_add_epi32(q, vb), divisible);
+        result = _mm256_blendv_epi8(result, _mm256_sub_epi32(_mm256_sub_epi32(vc, vb), va), ordered);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), result);
+        errors = _mm256_or_si256(errors, _mm256_andnot_si256(ordered, bad));
+    }
+    bool ok = _mm256_testz_si256(errors, errors);
+    return rules_scalar(a + k, b + k, c + k, out + k, n - k) && ok;
+}
+
+// Лучшее ядро для текущего процессора
+inline RuleKernel best_kernel() {
+    if (__builtin_cpu_supports("avx2")) return rules_avx2;
+    return rules_scalar;
+}
+
+inline const char* kernel_name(RuleKernel kernel) {
+    return kernel == rules_avx2 ? "avx2" : "scalar";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ВЫХОД
+////////////////////////////////////////////////////////////////////////////////
+
+// Байт -> 8 символов '0'/'1', старший бит первым
+struct BinaryTable {
+    char digits[256][8];
+
+    constexpr BinaryTable() : digits() {
+        for (int byte = 0; byte < 256; ++byte) {
+            for (int bit = 0; bit < 8; ++bit) digits[byte][bit] = (byte >> (7 - bit)) & 1 ? '1' : '0';
+        }
+    }
+};
+
+inline constexpr BinaryTable binary_table;
+
+// Строка ответа для месяца 0..12 (0 - ошибочный ввод), как в switch программы
+inline constexpr std::string_view month_answer[13] = {
+    "Wrong input",
+    "Days: 30\n", "Days: 28\n", "Days: 30\n", "Days: 31\n", "Days: 30\n", "Days: 31\n",
+    "Days: 30\n", "Days: 30\n", "Days: 31\n", "Days: 30\n", "Days: 31\n", "Days: 30\n"
+};
+
+inline char* put(char* pos, std::string_view text) {
+    std::memcpy(pos, text.data(), text.size());
+    return pos + text.size();
+}
+
+inline char* put(char* pos, int value) {
+    return std::to_chars(pos, pos + 11, value).ptr;
+}
+
+// Двоичная запись всех 32 бит (как std::bitset<32>::to_string())
+inline char* put_binary(char* pos, int value) {
+    unsigned bits = value;
+    for (int shift = 24; shift >= 0; shift -= 8, pos += 8) std::memcpy(pos, binary_table.digits[(bits >> shift) & 0xff], 8);
+    return pos;
+}
+
+// Вывод сеансов блока (результаты правил уже посчитаны)
+inline void write_block(const Block& block, file_io::OutputBuffer& out) {
+    constexpr std::size_t max_record = 160;
+    std::size_t rule = 0;
+    for (std::size_t k = 0; k < block.count; ++k) {
+        char* pos = put(out.reserve(max_record), "Enter A, i: ");
+        if (block.kind[k] == wrong_bit) {
+            out.commit(put(pos, "Wrong input\n"));
+            continue;
+        }
+        if (block.kind[k] == bit_zero) {
+            pos = put(pos, "Bit i (");
+            pos = put(pos, block.i[k]);
+            pos = put(pos, ") is 0;\nbinary A is:\n");
+            pos = put_binary(pos, block.a[k]);
+            *pos++ = '\n';
+        } else {
+            pos = put(pos, "Enter A, B, C: ");
+            pos = put(pos, block.rule_result[rule++]);
+            *pos++ = '\n';
+        }
+        pos = put(pos, "Enter month number: ");
+        int n = block.n[k];
+        out.commit(put(pos, month_answer[1 <= n && n <= 12 ? n : 0]));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// КОНВЕЙЕР
+////////////////////////////////////////////////////////////////////////////////
+
+struct BatchResult {
+    std::size_t count = 0;           // Обработано сеансов
+    const char* error = nullptr;     // Сеанс, который не удалось разобрать
+    bool division_error = false;     // Сеанс номер count + 1 делит на 0
+};
+
+// Первый сеанс блока, на котором правило делит на 0
+inline std::size_t first_division_error(const Block& block) {
+    std::size_t rule = 0;
+    for (std::size_t k = 0; k < block.count; ++k) {
+        if (block.kind[k] != bit_one) continue;
+        int result;
+        if (!rules_scalar(block.rule_a + rule, block.rule_b + rule, block.rule_c + rule, &result, 1)) return k;
+        ++rule;
+    }
+    return block.count;
+}
+
+inline BatchResult run(QueryParser& parser, file_io::OutputBuffer& out, RuleKernel kernel) {
+    auto block = std::make_unique<Block>();
+    BatchResult result;
+    while (parser.next(*block) || block->count > 0) {
+        if (!kernel(block->rule_a, block->rule_b, block->rule_c, block->rule_result, block->rules)) {
+            // Вывод до сеанса с ошибкой, как у программы, упавшей на нем
+            block->count = first_division_error(*block);
+            write_block(*block, out);
+            result.count += block->count;
+            result.division_error = true;
+            return result;
+        }
+        write_block(*block, out);
+        result.count += block->count;
+        if (parser.error()) break;
+    }
+    result.error = parser.error();
+    return result;
+}
+
+}
@@ -0,0 +1,104 @@
+// Статистика цифр (common/digit_stats.hpp) против цикла с делением на 10
+// из lab3 (пункт 2) и lab5 (handle_option1)
+//
+// - division: наибольшая цифра и ее повторы циклом %10 и /10 по уже
+//   разобранным uint64 (чисел до 19 знаков; деление на каждую цифру)
+// - text_scalar / text_avx2: то же по десятичной записи
+// - histogram_* и long_max_*: запись длиной в десятки МБ, для которой
+//   цикл с делением неприменим
+//
+// g++ -O2 bench/digits_bench.cpp -o bench_out && ./bench_out [чисел]
+
+#include "../../common/digit_stats.hpp"
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Цикл из lab5: повторы наибольшей цифры делением
+static digits::DigitStats division_stats(std::uint64_t n) {
+    digits::DigitStats stats;
+    while (n) {
+        int digit = n % 10;
+        if (stats.max_digit < digit) {
+            stats.max_digit = digit;
+            stats.max_count = 1;
+        } else {
+            stats.max_count += digit == stats.max_digit;
+        }
+        n /= 10;
+    }
+    return stats;
+}
+
+int main(int argc, char** argv) {
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    // Числа 1..19 знаков: и значения, и их записи
+    std::mt19937_64 rng(42);
+    std::vector<std::uint64_t> values(count);
+    std::string text;
+    std::vector<std::uint32_t> offsets(count + 1);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t value = rng() >> (rng() % 60 + 1);
+        values[i] = value ? value : 1;
+        char buffer[24];
+        offsets[i] = text.size();
+        text.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), values[i]).ptr);
+    }
+    offsets[count] = text.size();
+    std::printf("%zu numbers, %.1f digits on average\n", count, static_cast<double>(text.size()) / count);
+
+    std::vector<digits::DigitStats> expected(count);
+    {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < count; ++i) expected[i] = division_stats(values[i]);
+        double seconds = seconds_since(start);
+        std::printf("  %-16s %8.3f s %8.1f M numbers/s\n", "division", seconds, count / seconds / 1e6);
+    }
+
+    bool same = true;
+    auto run = [&](const char* name, digits::DigitStats (*kernel)(std::string_view)) {
+        std::vector<digits::DigitStats> got(count);
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            got[i] = kernel(std::string_view(text.data() + offsets[i], offsets[i + 1] - offsets[i]));
+        }
+        double seconds = seconds_since(start);
+        std::printf("  %-16s %8.3f s %8.1f M numbers/s\n", name, seconds, count / seconds / 1e6);
+        for (std::size_t i = 0; i < count; ++i) {
+            same = same && got[i].max_digit == expected[i].max_digit && got[i].max_count == expected[i].max_count;
+        }
+    };
+    run("text_scalar", digits::max_digit_scalar);
+    if (digits::avx2_supported()) run("text_avx2", digits::max_digit_avx2);
+
+    // Одна длинная запись: все числа подряд
+    auto run_long = [&](const char* name, auto kernel) {
+        auto start = Clock::now();
+        auto result = kernel();
+        double seconds = seconds_since(start);
+        std::printf("  %-16s %8.3f s %8.2f GB/s\n", name, seconds, text.size() / seconds / 1e9);
+        return result;
+    };
+    std::vector<std::uint64_t> scalar_counts(10), simd_counts(10);
+    run_long("histogram_scalar", [&] { digits::histogram_scalar(text, scalar_counts.data()); return 0; });
+    digits::DigitStats long_scalar = run_long("long_max_scalar", [&] { return digits::max_digit_scalar(text); });
+    if (digits::avx2_supported()) {
+        run_long("histogram_avx2", [&] { digits::histogram_avx2(text, simd_counts.data()); return 0; });
+        digits::DigitStats long_simd = run_long("long_max_avx2", [&] { return digits::max_digit_avx2(text); });
+        same = same && scalar_counts == simd_counts && long_scalar.max_count == long_simd.max_count
+            && long_scalar.max_count == scalar_counts[9];
+    }
+    std::printf("  results agree: %s\n", same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
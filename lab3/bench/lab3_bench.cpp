@@ -0,0 +1,96 @@
+// Пропускная способность (ГБ/с) редукции пункта 1: поштучный std::cin путь
+// против negative_reduce.hpp (mmap, разбиение по потокам, SIMD разбор)
+//
+// - per_value: std::ifstream >> a и свертка как в lab3.cpp (на префиксе файла)
+// - scalar_t<N>: from_chars, N потоков
+// - simd_t<N>: SIMD разбор, N потоков
+// Результаты всех режимов сверяются между собой (на одном и том же файле)
+//
+// g++ -O2 bench/lab3_bench.cpp -o bench_out && ./bench_out [МБ] [макс. потоков]
+
+#include "../negative_reduce.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void report(const char* name, std::size_t bytes, double seconds) {
+    std::printf("  %-12s %9.3f s %8.3f GB/s\n", name, seconds, bytes / seconds / 1e9);
+}
+
+static bool same(const negatives::Partial& a, const negatives::Partial& b) {
+    return a.sum == b.sum && a.max == b.max && a.max_count == b.max_count && a.count == b.count;
+}
+
+int main(int argc, char** argv) {
+    std::size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    unsigned max_threads = argc > 2 ? std::atoi(argv[2]) : std::max(std::thread::hardware_concurrency(), 1u) * 2;
+    std::string path = "/tmp/lab3-bench-" + std::to_string(getpid()) + ".txt";
+
+    // Числа разной длины и знака, по 16 на строку
+    {
+        std::mt19937 rng(42);
+        std::vector<char> text(1 << 20);
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        std::size_t written = 0, index = 0;
+        while (written < megabytes << 20) {
+            char* pos = text.data();
+            while (pos < text.data() + text.size() - 16) {
+                int value = static_cast<int>(rng()) >> (rng() % 31);
+                pos = std::to_chars(pos, pos + 12, value).ptr;
+                *pos++ = ++index % 16 ? ' ' : '\n';
+            }
+            written += std::fwrite(text.data(), 1, pos - text.data(), file);
+        }
+        std::fclose(file);
+    }
+
+    file_io::InputFile input(path.c_str());
+    std::string_view text = input.text();
+    std::printf("%.1f MB, %u hardware threads\n", text.size() / 1e6, std::thread::hardware_concurrency());
+    negatives::reduce(text, 1, false); // Прогрев: страницы файла в кэше
+
+    bool consistent = true;
+    {
+        // Префикс, обрезанный по границе числа
+        std::size_t prefix = std::min<std::size_t>(text.size(), 128 << 20);
+        while (prefix < text.size() && !negatives::is_space(text[prefix])) ++prefix;
+        std::size_t numbers = 0;
+        for (std::size_t k = 0; k < prefix; ++k) numbers += !negatives::is_space(text[k]) && (k + 1 == prefix || negatives::is_space(text[k + 1]));
+
+        auto start = Clock::now();
+        std::ifstream in(path);
+        negatives::Partial partial;
+        int a;
+        for (std::size_t k = 0; k < numbers && in >> a; ++k) partial.add(a);
+        report("per_value", prefix, seconds_since(start));
+        consistent = same(partial, negatives::reduce(text.substr(0, prefix), 1, false).partial);
+    }
+
+    negatives::Partial expected = negatives::reduce(text, 1, false).partial;
+    for (bool simd : {false, true}) {
+        if (simd && !negatives::simd_supported()) continue;
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            auto start = Clock::now();
+            negatives::Result result = negatives::reduce(text, threads, simd);
+            double seconds = seconds_since(start);
+            report((std::string(simd ? "simd_t" : "scalar_t") + std::to_string(threads)).c_str(), text.size(), seconds);
+            consistent = consistent && result.error == std::string_view::npos && same(result.partial, expected);
+        }
+    }
+    std::printf("  results agree: %s (sum %lld, max %lld x %llu)\n", consistent ? "yes" : "NO",
+                static_cast<long long>(expected.sum), static_cast<long long>(expected.max),
+                static_cast<unsigned long long>(expected.max_count));
+
+    std::remove(path.c_str());
+    return consistent ? 0 : 1;
+}
@@ -1,5 +1,14 @@
 #include <iostream>
 #include <limits>
+#include <optional>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include "negative_reduce.hpp"
+#include "../common/digit_stats.hpp"
+#include "../common/file_io.hpp"
+#include "../common/parallel.hpp"
 
 /*
 ВАРИАНТ 4
@@ -9,7 +18,83 @@
 2) Найти наибольшую цифру числа.
 */
 
-int main() {
+// Пункт 1 над файлом: ./out --reduce <файл> [потоков]
+// Файл - целые числа через пробельные символы (без количества в начале)
+int reduce(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " --reduce <input> [threads]" << std::endl;
+        return 2;
+    }
+    file_io::InputFile input(argv[2]);
+    if (!input.ok()) {
+        std::cerr << "cannot read " << argv[2] << std::endl;
+        return 1;
+    }
+    std::optional<unsigned> threads = argc > 3 ? workers::parse_thread_count(argv[3]) : workers::hardware_threads();
+    if (!threads) {
+        std::cerr << "bad thread count " << argv[3] << std::endl;
+        return 2;
+    }
+
+    negatives::Result result = negatives::reduce(input.text(), *threads, negatives::simd_supported());
+    if (result.error != std::string_view::npos) {
+        std::cerr << "bad number at byte " << result.error << std::endl;
+        return 1;
+    }
+    if (result.partial.count) {
+        std::cout << "Sum: " << result.partial.sum << std::endl;
+        std::cout << "The max number is " << result.partial.max <<" it's appeared " << result.partial.max_count << " times." << std::endl;
+    } else {
+        std::cout << "None of numbers match the condition." << std::endl;
+    }
+    return 0;
+}
+
+// Пункт 2 над файлом: ./out --digits <файл>
+// Для каждого числа (через пробельные символы, любой длины) - строка
+// "<наибольшая цифра> <сколько раз она встречается>"
+int digits_batch(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " --digits <input>" << std::endl;
+        return 2;
+    }
+    file_io::InputFile input(argv[2]);
+    if (!input.ok()) {
+        std::cerr << "cannot read " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::string_view text = input.text();
+    std::string out;
+    out.reserve(1 << 20);
+    std::size_t pos = 0;
+    while (true) {
+        while (pos < text.size() && file_io::is_space(text[pos])) ++pos;
+        if (pos == text.size()) break;
+        std::size_t end = pos;
+        while (end < text.size() && !file_io::is_space(text[end])) ++end;
+
+        digits::DigitStats stats = digits::max_digit(text.substr(pos, end - pos));
+        char line[32]; // "-1" или цифра, пробел, uint64 (до 20 знаков), перевод строки
+        char* last = std::to_chars(line, line + 2, stats.max_digit).ptr;
+        *last++ = ' ';
+        last = std::to_chars(last, line + sizeof(line) - 1, stats.max_count).ptr;
+        *last++ = '\n';
+        out.append(line, last);
+        if (out.size() > (1 << 20) - sizeof(line)) {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+        pos = end;
+    }
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    return std::fflush(stdout) == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--reduce") == 0) return reduce(argc, argv);
+    if (argc > 1 && std::strcmp(argv[1], "--digits") == 0) return digits_batch(argc, argv);
+
     // ----- ----- 1 ----- -----
     std::cout << "1)" << std::endl;
 
@@ -17,7 +102,8 @@ int main() {
 
     auto condition = [](const int& x){return x < 0;};
 
-    int sum{}, max_num{std::numeric_limits<int>::min()}, max_num_repeats;
+    long long sum{}; // int переполняется уже на ~10^6 чисел порядка -10^4
+    int max_num{std::numeric_limits<int>::min()}, max_num_repeats;
     while (n--)
     {
         std::cin >> a;
@@ -39,16 +125,15 @@ int main() {
     // ----- ----- 2 ----- -----
     std::cout  << std::endl << "2)" << std::endl;
 
-    int x, max_digit{-1}; std::cin >> x;
-    int tmp = std::abs(x);
-    while(tmp){
-        max_digit = std::max(max_digit, tmp%10);
-        tmp /= 10;
-    }
+    // Число читается как текст: длина не ограничена int, цифры без деления
+    std::string x; std::cin >> x;
+    int max_digit = digits::max_digit(x).max_digit;
     std::cout << "Max digit of " << x << " is " << max_digit << std::endl;
     
     return 0;
 }
 
 // g++ lab3.cpp -o out && ./out < input.txt
+// g++ -O2 lab3.cpp -o out && ./out --reduce numbers.txt 8
+// g++ -O2 lab3.cpp -o out && ./out --digits numbers.txt > digits.txt
 // ./build/bin/lab3
\ No newline at end of file
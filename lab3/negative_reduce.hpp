@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <immintrin.h>
+#include "../common/file_io.hpp"
+
+// Потоковая редукция пункта 1 над файлом целых чисел (через пробельные
+// символы, без количества в начале): сумма отрицательных (int64),
+// наибольшее из них и число его повторений
+//
+// - файл отображается в память и режется на куски по границам чисел,
+//   кусок на поток
+// - поток разбирает свой кусок (SIMD разбор: начала чисел - по маске
+//   разделителей блока 64 байта, длина - по маске цифр 16 байт, цифры
+//   сворачиваются умножениями-сложениями SSE) и копит частичное состояние
+// - частичные состояния сливаются ассоциативно и коммутативно, поэтому
+//   результат не зависит от числа потоков и разбиения
+
+namespace negatives {
+
+////////////////////////////////////////////////////////////////////////////////
+// СОСТОЯНИЕ
+////////////////////////////////////////////////////////////////////////////////
+
+struct Partial {
+    std::int64_t sum = 0;
+    std::int64_t max = INT64_MIN;   // INT64_MIN - отрицательных еще не было
+    std::uint64_t max_count = 0;
+    std::uint64_t count = 0;        // Всего отрицательных
+
+    // Без ветвления по знаку (на случайных данных оно не предсказывается):
+    // неотрицательное число превращается в INT64_MIN, которое не меньше
+    // max только пока отрицательных не было - тогда счетчик обнуляется
+    void add(int value) {
+        const std::int64_t negative = static_cast<std::int64_t>(value) >> 63;   // -1 или 0
+        const std::int64_t candidate = (value & negative) | (INT64_MIN & ~negative);
+        sum += value & negative;
+        count += negative & 1;
+        if (candidate > max) [[unlikely]] {
+            max = candidate;
+            max_count = 1;
+        } else {
+            max_count += (candidate == max) & negative;
+        }
+    }
+
+    // Пустое состояние - нейтральный элемент
+    Partial& merge(const Partial& other) {
+        sum += other.sum;
+        count += other.count;
+        if (other.max > max) {
+            max = other.max;
+            max_count = other.max_count;
+        } else if (other.max == max) {
+            max_count += other.max_count;
+        }
+        return *this;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// РАЗБОР
+////////////////////////////////////////////////////////////////////////////////
+
+// Разделитель - любой байт <= ' ' (пробелы, переводы строк, нули)
+using file_io::is_space;
+
+// Одно число с p через from_chars (p уже на начале токена)
+inline bool parse_token(const char*& p, const char* end, int& value) {
+    const char* digits = p + (*p == '+');
+    if (digits < end && *digits == '-' && digits != p) return false;
+    auto [next, ec] = std::from_chars(digits, end, value);
+    if (ec != std::errc() || (next < end && !is_space(*next))) return false;
+    p = next;
+    return true;
+}
+
+// Разбор [p, end) по одному числу через from_chars
+// error - первый нераспознанный токен (не меняется, если ошибок нет)
+inline Partial parse_scalar(const char* p, const char* end, const char*& error) {
+    Partial partial;
+    while (true) {
+        while (p < end && is_space(*p)) ++p;
+        if (p >= end) break;
+        int value;
+        if (!parse_token(p, end, value)) {
+            error = p;
+            break;
+        }
+        partial.add(value);
+    }
+    return partial;
+}
+
+// Маски перестановки: L цифр из начала 16 байт -> в конец, остальное - нули
+struct AlignTable {
+    alignas(16) std::uint8_t masks[17][16];
+
+    constexpr AlignTable() : masks() {
+        for (int length = 0; length <= 16; ++length) {
+            for (int i = 0; i < 16; ++i) {
+                int source = i - (16 - length);
+                masks[length][i] = source >= 0 ? static_cast<std::uint8_t>(source) : 0x80;
+            }
+        }
+    }
+};
+
+inline constexpr AlignTable align_table;
+
+// Значение до 16 цифр ('0'..'9' уже вычтены), выровненных вправо
+__attribute__((target("avx2")))
+inline std::uint64_t fold_digits(__m128i digits) {
+    const __m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const __m128i packed = _mm_packus_epi32(quads, quads);
+    const __m128i octets = _mm_madd_epi16(packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_cvtsi128_si32(octets))) * 100000000
+         + static_cast<std::uint32_t>(_mm_extract_epi32(octets, 1));
+}
+
+// Запас для чтения за концом разбираемого диапазона (блок 64 байта + число)
+constexpr std::size_t simd_padding = 96;
+
+// Разбор [begin, end); begin - начало данных или разделитель, end - разделитель
+// или конец данных, за end доступно для чтения simd_padding байт
+//
+// Начала чисел берутся из маски разделителей блока 64 байта, поэтому числа
+// блока разбираются независимо друг от друга (нет цепочки через указатель)
+__attribute__((target("avx2")))
+inline Partial parse_simd(const char* begin, const char* end, const char*& error) {
+    Partial partial;
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m128i zero_char = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    std::uint64_t carry = 0;  // Последний байт предыдущего блока - часть числа
+    for (const char* block = begin; block < end; block += 64) {
+        const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+        const std::uint64_t spaces =
+            static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(low, space), low)))
+            | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(high, space), high)))) << 32;
+        const std::uint64_t tokens = ~spaces;
+        std::uint64_t starts = tokens & ~((tokens << 1) | carry);
+        carry = tokens >> 63;
+        if (end - block < 64) starts &= (std::uint64_t(1) << (end - block)) - 1;
+
+        for (; starts; starts &= starts - 1) {
+            const char* start = block + __builtin_ctzll(starts);
+            const bool negative = *start == '-';
+            const char* p = start + (negative | (*start == '+'));
+            const std::int64_t sign = -static_cast<std::int64_t>(negative);
+
+            const __m128i chunk = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), zero_char);
+            const unsigned digit_mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(chunk, nine), chunk));
+            const unsigned length = __builtin_ctz(~digit_mask | 0x10000);
+            const std::uint64_t magnitude = fold_digits(_mm_shuffle_epi8(chunk, _mm_load_si128(reinterpret_cast<const __m128i*>(align_table.masks[length]))));
+            if (length > 0 && length < 16 && is_space(p[length]) && p + length <= end
+                && magnitude <= 2147483647u + negative) [[likely]] {
+                partial.add(static_cast<int>((static_cast<std::int64_t>(magnitude) ^ sign) - sign));
+                continue;
+            }
+
+            // Редкие случаи (ведущие нули, переполнение, мусор) - как в parse_scalar
+            int value;
+            if (!parse_token(p = start, end, value)) {
+                error = start;
+                return partial;
+            }
+            partial.add(value);
+        }
+    }
+    return partial;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ПОТОКИ
+////////////////////////////////////////////////////////////////////////////////
+
+struct Result {
+    Partial partial;
+    std::size_t error = std::string_view::npos;   // Смещение первого нераспознанного токена
+};
+
+// Кусок [begin, end) данных text; SIMD разбор не читает за концом отображения:
+// последние байты данных копируются в буфер с запасом
+inline Result reduce_chunk(std::string_view text, std::size_t begin, std::size_t end, bool simd) {
+    const char* data = text.data();
+    const char* error = nullptr;
+    Result result;
+    if (!simd) {
+        result.partial = parse_scalar(data + begin, data + end, error);
+    } else {
+        // Быстрая часть заканчивается на разделителе не ближе simd_padding байт к концу данных
+        std::size_t fast_end = std::min(end, text.size() >= simd_padding ? text.size() - simd_padding : 0);
+        while (fast_end > begin && !is_space(data[fast_end])) --fast_end;
+        if (fast_end < begin) fast_end = begin;
+        result.partial = parse_simd(data + begin, data + fast_end, error);
+
+        if (!error && fast_end < end) {
+            std::string tail(data + fast_end, data + end);
+            tail.append(simd_padding, '\0');
+            const char* tail_error = nullptr;
+            result.partial.merge(parse_simd(tail.data(), tail.data() + (end - fast_end), tail_error));
+            if (tail_error) error = data + fast_end + (tail_error - tail.data());
+        }
+    }
+    if (error) result.error = error - data;
+    return result;
+}
+
+// Разбиение на threads кусков по границам чисел и слияние частичных состояний
+inline Result reduce(std::string_view text, unsigned threads, bool simd) {
+    threads = std::max(threads, 1u);
+    std::vector<std::size_t> bounds(threads + 1, text.size());
+    bounds[0] = 0;
+    for (unsigned k = 1; k < threads; ++k) {
+        std::size_t bound = std::max(bounds[k - 1], text.size() / threads * k);
+        while (bound < text.size() && !is_space(text[bound])) ++bound;
+        bounds[k] = bound;
+    }
+
+    std::vector<Result> results(threads);
+    std::vector<std::thread> workers;
+    for (unsigned k = 1; k < threads; ++k) {
+        workers.emplace_back([&, k] { results[k] = reduce_chunk(text, bounds[k], bounds[k + 1], simd); });
+    }
+    results[0] = reduce_chunk(text, bounds[0], bounds[1], simd);
+    for (std::thread& worker : workers) worker.join();
+
+    Result total;
+    for (const Result& result : results) {
+        total.partial.merge(result.partial);
+        total.error = std::min(total.error, result.error);
+    }
+    return total;
+}
+
+inline bool simd_supported() {
+    return __builtin_cpu_supports("avx2");
+}
+
+}
@@ -0,0 +1,117 @@
+// Пункт 2 (отрицательные по столбцам, столбец-победитель в -1) на больших
+// матрицах: матрица dp из lab4.cpp против column_negatives.hpp
+//
+// - dp: префиксные суммы dp[i][j] как в lab4.cpp (вторая матрица N x M)
+// - scalar: счетчики по столбцам, один поток, без SIMD
+// - avx2_t<N>: плитки строк, счетчики блока столбцов в регистрах, N потоков
+// - find_t<N>: только поиск столбца (по широким матрицам - без вектора
+//   счетчиков всех столбцов)
+// - fill_t<N>: перезапись выбранного столбца (проход с шагом строки)
+// Формы: высокая, широкая и квадратная, по ~256 МБ; счетчики всех режимов
+// сверяются между собой
+//
+// g++ -O2 bench/columns_bench.cpp -o bench_out && ./bench_out [млн элементов] [макс. потоков]
+
+#include "../column_negatives.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void report(const char* name, std::size_t bytes, double seconds) {
+    std::printf("  %-12s %9.3f ms %8.2f GB/s\n", name, seconds * 1e3, bytes / seconds / 1e9);
+}
+
+// Лучшее из трех прогонов
+template<typename Run>
+static double measure(Run&& run) {
+    double best = 1e30;
+    for (int k = 0; k < 3; ++k) {
+        auto start = Clock::now();
+        run();
+        best = std::min(best, seconds_since(start));
+    }
+    return best;
+}
+
+// Как в lab4.cpp: dp[i][j] - отрицательных в столбце j строк 0..i
+static std::vector<std::uint64_t> dp_counts(const columns::MatrixView& m, std::vector<int>& dp) {
+    for (std::size_t i = 0; i < m.rows; i++) {
+        for (std::size_t j = 0; j < m.cols; j++) {
+            dp[i * m.cols + j] = (m.row(i)[j] < 0) + ((i > 0) ? dp[(i - 1) * m.cols + j] : 0);
+        }
+    }
+    const auto last = dp.begin() + (m.rows - 1) * m.cols;
+    return std::vector<std::uint64_t>(last, last + m.cols);
+}
+
+int main(int argc, char** argv) {
+    std::size_t elements = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64) * 1000000;
+    unsigned max_threads = argc > 2 ? std::atoi(argv[2]) : std::max(std::thread::hardware_concurrency(), 1u);
+    std::printf("%u hardware threads, avx2: %s\n", std::thread::hardware_concurrency(),
+                columns::avx2_supported() ? "yes" : "no");
+
+    const std::size_t side = static_cast<std::size_t>(std::sqrt(static_cast<double>(elements)));
+    struct Shape { const char* name; std::size_t rows, cols; };
+    const Shape shapes[] = {
+        {"tall", elements / 4, 4},
+        {"tall", elements / 100, 100},
+        {"square", side, side},
+        {"wide", 16, elements / 16},
+        {"wide", 3, elements / 3},
+    };
+
+    bool consistent = true;
+    std::mt19937 rng(42);
+    std::vector<int> data(elements), dp(elements);
+    for (int& x : data) x = static_cast<int>(rng() % 201) - 100;
+
+    for (const Shape& shape : shapes) {
+        columns::MatrixView m{data.data(), shape.rows, shape.cols, shape.cols};
+        const std::size_t bytes = m.rows * m.cols * sizeof(int);
+        std::printf("%s %zu x %zu\n", shape.name, m.rows, m.cols);
+
+        std::vector<std::uint64_t> expected;
+        report("dp", bytes, measure([&] { expected = dp_counts(m, dp); }));
+
+        std::vector<std::uint64_t> counts;
+        report("scalar", bytes, measure([&] { counts = columns::negative_counts(m, 1, false); }));
+        consistent = consistent && counts == expected;
+        if (columns::avx2_supported()) {
+            for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+                report(("avx2_t" + std::to_string(threads)).c_str(), bytes,
+                       measure([&] { counts = columns::negative_counts(m, threads, true); }));
+                consistent = consistent && counts == expected;
+            }
+        }
+
+        const std::size_t column = columns::max_negative_column(expected);
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            std::size_t found = columns::none;
+            report(("find_t" + std::to_string(threads)).c_str(), bytes,
+                   measure([&] { found = columns::max_negative_column(m, threads); }));
+            consistent = consistent && found == column;
+        }
+
+        // Перезапись трогает по строке кэша на элемент столбца
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            double seconds = measure([&] { columns::fill_column(m, column, -1, threads); });
+            std::printf("  %-12s %9.3f ms %8.1f M rows/s\n", ("fill_t" + std::to_string(threads)).c_str(),
+                        seconds * 1e3, m.rows / seconds / 1e6);
+        }
+        // Столбец - целиком -1, остальные без изменений
+        expected[column] = m.rows;
+        consistent = consistent && columns::negative_counts(m) == expected;
+    }
+    std::printf("  results agree: %s\n", consistent ? "yes" : "NO");
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// Пункт 1 ("если все делятся на 5 - отсортировать") на массивах от 7 до 10^9
+// элементов: обменная сортировка из lab4.cpp против sort5.hpp
+//
+// - exchange: вложенные циклы как в lab4.cpp (только до 10^4 - O(n^2))
+// - std_sort: std::sort для сравнения
+// - radix_t<N>: sort5::radix_sort в N потоков (до 16 элементов - сеть)
+// - check_scalar / check_avx2: полная проверка делимости (все делятся)
+// - check_early: неделящийся элемент в начале - выход на первом блоке
+// Все сортировки сверяются с std::sort. Размеры, которым не хватает памяти
+// (массив, эталон и буфер radix - 12 байт на элемент), пропускаются
+//
+// g++ -O2 bench/lab4_bench.cpp -o bench_out && ./bench_out [макс. степень 10] [макс. потоков]
+
+#include "../sort5.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Повторы, пока не наберется ~0.2 с (малые размеры), время одного прогона
+template<typename Prepare, typename Run>
+static double measure(Prepare&& prepare, Run&& run) {
+    double total = 0;
+    std::size_t repeats = 0;
+    do {
+        prepare();
+        auto start = Clock::now();
+        run();
+        total += seconds_since(start);
+        ++repeats;
+    } while (total < 0.2 && repeats < 1000000);
+    return total / repeats;
+}
+
+static void report(const char* name, std::size_t n, double seconds) {
+    std::printf("  %-14s %12.3f us %10.2f ns/elem %10.1f M elem/s\n", name, seconds * 1e6, seconds * 1e9 / n, n / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+    int max_power = argc > 1 ? std::atoi(argv[1]) : 9;
+    unsigned max_threads = argc > 2 ? std::atoi(argv[2]) : std::max(std::thread::hardware_concurrency(), 1u);
+    const double memory = static_cast<double>(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGESIZE);
+    std::printf("%u hardware threads, %.1f GB memory, avx2: %s\n", std::thread::hardware_concurrency(), memory / 1e9,
+                __builtin_cpu_supports("avx2") ? "yes" : "no");
+
+    std::vector<std::size_t> sizes = {7};
+    for (int p = 3; p <= max_power; ++p) {
+        std::size_t n = 1;
+        for (int k = 0; k < p; ++k) n *= 10;
+        sizes.push_back(n);
+    }
+
+    bool consistent = true;
+    std::mt19937 rng(42);
+    for (std::size_t n : sizes) {
+        if (n * 12.0 > memory * 0.8) {
+            std::printf("n = %zu: skipped, needs %.1f GB\n", n, n * 12.0 / 1e9);
+            continue;
+        }
+        std::printf("n = %zu\n", n);
+
+        // Кратные 5 во всем диапазоне int
+        std::vector<int> source(n);
+        for (int& x : source) x = static_cast<int>(rng()) / 5 * 5;
+        std::vector<int> expected;
+        std::vector<int> work(n);
+        auto reset = [&] { std::copy(source.begin(), source.end(), work.begin()); };
+
+        report("std_sort", n, measure(reset, [&] { std::sort(work.begin(), work.end()); }));
+        expected = work;
+
+        if (n <= 10000) {
+            report("exchange", n, measure(reset, [&] {
+                for (std::size_t i = 0; i < n; i++) {
+                    for (std::size_t j = i + 1; j < n; j++) {
+                        if (work[i] > work[j]) std::swap(work[i], work[j]);
+                    }
+                }
+            }));
+            consistent = consistent && work == expected;
+        }
+
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            report(("radix_t" + std::to_string(threads)).c_str(), n,
+                   measure(reset, [&] { sort5::radix_sort(work, threads); }));
+            consistent = consistent && work == expected;
+        }
+
+        bool scalar = false, simd = false;
+        report("check_scalar", n, measure([] {}, [&] { scalar = sort5::all_divisible_scalar(source); }));
+        if (__builtin_cpu_supports("avx2")) {
+            report("check_avx2", n, measure([] {}, [&] { simd = sort5::all_divisible_avx2(source); }));
+            consistent = consistent && scalar && simd;
+        }
+        source[0] += 1;
+        report("check_early", n, measure([] {}, [&] { simd = sort5::all_divisible(source); }));
+        consistent = consistent && !simd;
+    }
+    std::printf("  results agree: %s\n", consistent ? "yes" : "NO");
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <immintrin.h>
+#include "../common/parallel.hpp"
+
+// Пункт 2 для матриц N x M любого размера (по строкам, с шагом строки):
+// "столбец с наибольшим числом отрицательных заполнить -1"
+//
+// - строки делятся между потоками, у каждого потока свой вектор счетчиков
+//   по столбцам (у низких широких матриц - столбцы); матрица читается
+//   ровно один раз
+// - столбцы идут кусками по chunk_columns (32-битные счетчики куска в L1),
+//   кусок - плитками по tile_rows строк, внутри плитки блоки по
+//   block_columns со счетчиками в регистрах AVX2 (x < 0 -> сдвиг знака
+//   дает -1, вычитание прибавляет 1); плитка читает tile_rows
+//   последовательных потоков памяти
+// - перезапись столбца - отдельный проход по строкам с шагом stride,
+//   тоже по потокам
+//
+// Вспомогательной матрицы N x M (dp из lab4.cpp) нет: память - M 64-битных
+// счетчиков на поток, а при поиске столбца по широкой матрице - только
+// счетчики куска. Выбор столбца как в lab4.cpp: первый с наибольшим
+// числом, если отрицательных нет совсем - ничего не меняется
+
+namespace columns {
+
+struct MatrixView {
+    int* data;
+    std::size_t rows;
+    std::size_t cols;
+    std::size_t stride;   // Элементов между началами строк (>= cols)
+
+    int* row(std::size_t r) const { return data + r * stride; }
+};
+
+constexpr std::size_t tile_rows = 16;
+constexpr std::size_t block_vectors = 8;                  // Регистров-счетчиков на блок
+constexpr std::size_t block_columns = block_vectors * 8;
+// Столбцов в куске: 32-битные счетчики куска (8 КБ) остаются в L1
+constexpr std::size_t chunk_columns = 2048;
+// Строк в куске: 32-битные счетчики не переполняются
+constexpr std::size_t chunk_rows = std::size_t(1) << 30;
+// Меньше этого числа элементов - один поток
+constexpr std::size_t parallel_threshold = std::size_t(1) << 18;
+
+////////////////////////////////////////////////////////////////////////////////
+// ПОДСЧЕТ
+////////////////////////////////////////////////////////////////////////////////
+
+// counts[c] += число отрицательных в столбце c подматрицы rows x cols от base
+inline void count_scalar(const int* base, std::size_t stride, std::size_t rows, std::size_t cols,
+                         std::uint32_t* counts) {
+    for (std::size_t r = 0; r < rows; ++r) {
+        const int* row = base + r * stride;
+        for (std::size_t c = 0; c < cols; ++c) counts[c] += row[c] < 0;
+    }
+}
+
+// Блок из V векторов (последний - по маске) на rows строках от base
+template<std::size_t V>
+__attribute__((target("avx2")))
+inline void count_block_avx2(const int* base, std::size_t stride, std::size_t rows, __m256i last_mask,
+                             std::uint32_t* counts) {
+    __m256i acc[V];
+    for (std::size_t v = 0; v < V; ++v) acc[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts + 8 * v));
+    for (std::size_t r = 0; r < rows; ++r) {
+        const int* row = base + r * stride;
+        for (std::size_t v = 0; v + 1 < V; ++v) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + 8 * v));
+            acc[v] = _mm256_sub_epi32(acc[v], _mm256_srai_epi32(x, 31));
+        }
+        const __m256i x = _mm256_maskload_epi32(row + 8 * (V - 1), last_mask);
+        acc[V - 1] = _mm256_sub_epi32(acc[V - 1], _mm256_srai_epi32(x, 31));
+    }
+    for (std::size_t v = 0; v < V; ++v) _mm256_storeu_si256(reinterpret_cast<__m256i*>(counts + 8 * v), acc[v]);
+}
+
+// То же, что count_scalar; counts - не меньше cols, округленного вверх до 8
+__attribute__((target("avx2")))
+inline void count_avx2(const int* base, std::size_t stride, std::size_t rows, std::size_t cols,
+                       std::uint32_t* counts) {
+    using Block = void (*)(const int*, std::size_t, std::size_t, __m256i, std::uint32_t*);
+    static constexpr Block blocks[block_vectors + 1] = {
+        nullptr, count_block_avx2<1>, count_block_avx2<2>, count_block_avx2<3>, count_block_avx2<4>,
+        count_block_avx2<5>, count_block_avx2<6>, count_block_avx2<7>, count_block_avx2<8>,
+    };
+    const __m256i all = _mm256_set1_epi32(-1);
+    const std::size_t rest = cols % block_columns;
+    const std::size_t rest_vectors = (rest + 7) / 8;
+    const int rest_lanes = static_cast<int>(rest - 8 * (rest_vectors - 1));
+    const __m256i rest_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(rest_lanes), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+    for (std::size_t r = 0; r < rows; r += tile_rows) {
+        const std::size_t tile = std::min(tile_rows, rows - r);
+        const int* row = base + r * stride;
+        std::size_t c = 0;
+        for (; c + block_columns <= cols; c += block_columns) {
+            count_block_avx2<block_vectors>(row + c, stride, tile, all, counts + c);
+        }
+        if (rest) blocks[rest_vectors](row + c, stride, tile, rest_mask, counts + c);
+    }
+}
+
+inline bool avx2_supported() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// Подматрица строк [row_begin, row_end) и столбцов [col_begin, col_end):
+// кусок столбцов проходится по всем строкам, затем
+// sink(первый столбец куска, отрицательных по столбцам куска, столбцов)
+template<typename Sink>
+void count_range(const MatrixView& m, std::size_t row_begin, std::size_t row_end,
+                 std::size_t col_begin, std::size_t col_end, bool simd, Sink&& sink) {
+    std::uint32_t counts[chunk_columns];
+    std::uint64_t total[chunk_columns];
+    for (std::size_t c = col_begin; c < col_end; c += chunk_columns) {
+        const std::size_t cols = std::min(chunk_columns, col_end - c);
+        std::fill(total, total + cols, 0);
+        for (std::size_t r = row_begin; r < row_end; r += chunk_rows) {
+            const std::size_t rows = std::min(chunk_rows, row_end - r);
+            std::fill(counts, counts + chunk_columns, 0);
+            if (simd) count_avx2(m.row(r) + c, m.stride, rows, cols, counts);
+            else count_scalar(m.row(r) + c, m.stride, rows, cols, counts);
+            for (std::size_t k = 0; k < cols; ++k) total[k] += counts[k];
+        }
+        sink(c, static_cast<const std::uint64_t*>(total), cols);
+    }
+}
+
+inline unsigned thread_count(const MatrixView& m, unsigned threads) {
+    return m.rows * m.cols < parallel_threshold ? 1 : std::max(threads, 1u);
+}
+
+// Отрицательных по столбцам (размер cols)
+// Строки делятся между потоками (у каждого свои счетчики, в конце сумма);
+// если строк меньше, чем по плитке на поток, делятся столбцы
+inline std::vector<std::uint64_t> negative_counts(const MatrixView& m,
+                                                  unsigned threads = std::thread::hardware_concurrency(),
+                                                  bool simd = avx2_supported()) {
+    std::vector<std::uint64_t> total(m.cols);
+    threads = thread_count(m, threads);
+    if (threads > 1 && m.rows >= threads * tile_rows) {
+        std::vector<std::vector<std::uint64_t>> partial(threads);
+        workers::parallel_for(threads, [&](unsigned t) {
+            partial[t].resize(m.cols);
+            count_range(m, m.rows * t / threads, m.rows * (t + 1) / threads, 0, m.cols, simd,
+                        [&](std::size_t c, const std::uint64_t* counts, std::size_t cols) {
+                            std::copy(counts, counts + cols, partial[t].begin() + c);
+                        });
+        });
+        for (const auto& counts : partial) {
+            for (std::size_t c = 0; c < m.cols; ++c) total[c] += counts[c];
+        }
+    } else {
+        workers::parallel_for(threads, [&](unsigned t) {
+            count_range(m, 0, m.rows, m.cols * t / threads, m.cols * (t + 1) / threads, simd,
+                        [&](std::size_t c, const std::uint64_t* counts, std::size_t cols) {
+                            std::copy(counts, counts + cols, total.begin() + c);
+                        });
+        });
+    }
+    return total;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ПУНКТ 2
+////////////////////////////////////////////////////////////////////////////////
+
+constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+// Первый столбец с наибольшим (ненулевым) числом отрицательных или none
+inline std::size_t max_negative_column(const std::vector<std::uint64_t>& counts) {
+    std::size_t column = none;
+    std::uint64_t best = 0;
+    for (std::size_t c = 0; c < counts.size(); ++c) {
+        if (counts[c] > best) {
+            best = counts[c];
+            column = c;
+        }
+    }
+    return column;
+}
+
+// То же прямо по матрице. Если столбцов хватает на кусок каждому потоку,
+// потоки делят столбцы и ищут лучший в своих кусках - счетчики всех M
+// столбцов не хранятся; иначе - через negative_counts
+inline std::size_t max_negative_column(const MatrixView& m,
+                                       unsigned threads = std::thread::hardware_concurrency(),
+                                       bool simd = avx2_supported()) {
+    threads = thread_count(m, threads);
+    if (threads > 1 && m.cols < threads * chunk_columns) return max_negative_column(negative_counts(m, threads, simd));
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> best(threads, {0, none});
+    workers::parallel_for(threads, [&](unsigned t) {
+        count_range(m, 0, m.rows, m.cols * t / threads, m.cols * (t + 1) / threads, simd,
+                    [&](std::size_t c, const std::uint64_t* counts, std::size_t cols) {
+                        for (std::size_t k = 0; k < cols; ++k) {
+                            if (counts[k] > best[t].first) best[t] = {counts[k], c + k};
+                        }
+                    });
+    });
+    // Потоки - по возрастанию столбцов: при равенстве остается первый
+    std::pair<std::uint64_t, std::size_t> result = best[0];
+    for (const auto& candidate : best) {
+        if (candidate.first > result.first) result = candidate;
+    }
+    return result.second;
+}
+
+inline void fill_column(const MatrixView& m, std::size_t column, int value,
+                        unsigned threads = std::thread::hardware_concurrency()) {
+    threads = m.rows < parallel_threshold ? 1 : std::max(1u, std::min<unsigned>(threads, m.rows));
+    workers::parallel_for(threads, [&](unsigned t) {
+        const std::size_t begin = m.rows * t / threads, end = m.rows * (t + 1) / threads;
+        for (std::size_t r = begin; r < end; ++r) m.row(r)[column] = value;
+    });
+}
+
+// Возвращает заполненный столбец или none
+inline std::size_t fill_max_negative_column(const MatrixView& m,
+                                            unsigned threads = std::thread::hardware_concurrency()) {
+    const std::size_t column = max_negative_column(m, threads);
+    if (column != none) fill_column(m, column, -1, threads);
+    return column;
+}
+
+}
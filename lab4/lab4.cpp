@@ -1,59 +1,124 @@
 #include <iostream>
+#include <optional>
+#include <span>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "sort5.hpp"
+#include "column_negatives.hpp"
+#include "../common/parallel.hpp"
+#include "../common/table_output.hpp"
 
 #define VARIANT 4
 
-int main(){
-    // лаба 4 вариант 4
+// Пункт 1 над файлом: ./out --sort <файл> [потоков] [дамп]
+// Файл - целые числа через пробельные символы (любое количество); вывод как
+// в пункте 1: числа через табуляцию одной строкой. С путем дампа - вместо
+// текста двоичный дамп 1 x N (table::write_binary)
+int sort_batch(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " --sort <input> [threads] [dump.bin]" << std::endl;
+        return 2;
+    }
+    std::vector<int> a;
+    {
+        file_io::InputFile input(argv[2]);
+        if (!input.ok()) {
+            std::cerr << "cannot read " << argv[2] << std::endl;
+            return 1;
+        }
+        a.reserve(input.text().size() / 2);
+        std::size_t error = sort5::parse_ints(input.text(), a);
+        if (error != std::string_view::npos) {
+            std::cerr << "bad number at byte " << error << std::endl;
+            return 1;
+        }
+    }
+    std::optional<unsigned> threads = argc > 3 ? workers::parse_thread_count(argv[3]) : workers::hardware_threads();
+    if (!threads) {
+        std::cerr << "bad thread count " << argv[3] << std::endl;
+        return 2;
+    }
 
-    ////////// 1 ////////// 
-    int a[VARIANT + 3];
+    sort5::sort_if_divisible(a, *threads);
 
-    bool all_nums_divisible_5 = true;
+    if (argc > 4) return table::write_binary(argv[4], a.data(), 1, a.size(), a.size()) ? 0 : 1;
+    return table::standard_output().row(std::span<const int>(a)).flush() ? 0 : 1;
+}
 
-    for(int i = 0; i < VARIANT + 3; i++){
-        std::cin>>a[i];
-        all_nums_divisible_5 = all_nums_divisible_5 && a[i]%5 == 0;
+// Пункт 2 над файлом: ./out --columns <файл> [потоков] [дамп]
+// Файл - "N M", затем N * M целых по строкам; вывод как в пункте 2:
+// строка матрицы - числа через табуляцию. С путем дампа - двоичный дамп N x M
+int columns_batch(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " --columns <input> [threads] [dump.bin]" << std::endl;
+        return 2;
     }
-
-    if (all_nums_divisible_5){
-        for(int i = 0; i < VARIANT+3; i++){
-            for(int j = i+1; j < VARIANT+3; j++){
-                if (a[i] > a[j]) std::swap(a[i], a[j]);
-            }
+    std::vector<int> values;
+    {
+        file_io::InputFile input(argv[2]);
+        if (!input.ok()) {
+            std::cerr << "cannot read " << argv[2] << std::endl;
+            return 1;
+        }
+        values.reserve(input.text().size() / 2);
+        std::size_t error = sort5::parse_ints(input.text(), values);
+        if (error != std::string_view::npos) {
+            std::cerr << "bad number at byte " << error << std::endl;
+            return 1;
         }
     }
+    if (values.size() < 2 || values[0] < 0 || values[1] < 0
+        || values.size() - 2 != static_cast<std::size_t>(values[0]) * static_cast<std::size_t>(values[1])) {
+        std::cerr << "expected N M and N * M numbers" << std::endl;
+        return 1;
+    }
+    const std::size_t n = values[0], m = values[1];
+    std::optional<unsigned> threads = argc > 3 ? workers::parse_thread_count(argv[3]) : workers::hardware_threads();
+    if (!threads) {
+        std::cerr << "bad thread count " << argv[3] << std::endl;
+        return 2;
+    }
 
-    for(int i = 0; i < VARIANT + 3; i++) std::cout<<a[i]<<"\t"; std::cout<<std::endl;
+    columns::fill_max_negative_column({values.data() + 2, n, m, m}, *threads);
 
-    ////////// 2 //////////
-    int b[3][4], dp[3][4];
-    for(int i = 0; i < 3; i++){
-        for(int j = 0; j < 4; j++){
-            std::cin>>b[i][j];
-            dp[i][j] = (b[i][j] < 0) + ((i > 0) ? dp[i-1][j] : 0);
-        }
-    }
+    if (argc > 4) return table::write_binary(argv[4], values.data() + 2, n, m, m) ? 0 : 1;
+    return table::standard_output().matrix(values.data() + 2, n, m, m).flush() ? 0 : 1;
+}
 
-    int max_negative_nums_col_indx = -1, max_negative_nums_col_value = 0;
-    for(int i = 0; i < 4; i++){
-        if(dp[2][i] > max_negative_nums_col_value) {
-            max_negative_nums_col_value = dp[2][i];
-            max_negative_nums_col_indx = i;
-        }
-    }
+int main(int argc, char** argv){
+    if (argc > 1 && std::strcmp(argv[1], "--sort") == 0) return sort_batch(argc, argv);
+    if (argc > 1 && std::strcmp(argv[1], "--columns") == 0) return columns_batch(argc, argv);
 
-    if (max_negative_nums_col_indx != -1) {
-        for (int i = 0; i < 3; i++){
-            b[i][max_negative_nums_col_indx] = -1;
-        }
-    }
+    // лаба 4 вариант 4
 
-    // std::cout<<max_negative_nums_col_indx<<" "<<max_negative_nums_col_value<<"\n";
+    ////////// 1 ////////// 
+    int a[VARIANT + 3];
 
+    for(int i = 0; i < VARIANT + 3; i++) std::cin>>a[i];
+
+    // Проверка делимости и сортировка (для 7 элементов - сортирующая сеть)
+    sort5::sort_if_divisible(a);
+
+    table::standard_output().row(std::span<const int>(a)).flush();
+
+    ////////// 2 //////////
+    int b[3][4];
     for(int i = 0; i < 3; i++){
-        for(int j = 0; j < 4; j++) std::cout<<b[i][j]<<"\t";
-        std::cout<<std::endl;
+        for(int j = 0; j < 4; j++) std::cin>>b[i][j];
     }
 
+    // Отрицательные по столбцам за один проход, столбец-победитель - в -1
+    columns::fill_max_negative_column({&b[0][0], 3, 4, 4});
+
+    table::standard_output().matrix(&b[0][0], 3, 4, 4).flush();
+
     return 0;
-}
\ No newline at end of file
+}
+
+// g++ lab4.cpp -o out && ./out < input.txt
+// g++ -O2 lab4.cpp -o out && ./out --sort numbers.txt 8 > sorted.txt
+// g++ -O2 lab4.cpp -o out && ./out --columns matrix.txt 8 > filled.txt
+// g++ -O2 lab4.cpp -o out && ./out --columns matrix.txt 8 filled.bin
+// ./build/bin/lab4
\ No newline at end of file
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <immintrin.h>
+#include "../common/file_io.hpp"
+#include "../common/parallel.hpp"
+
+// Пункт 1 для массивов любого размера: "если все элементы делятся на 5 -
+// отсортировать по возрастанию"
+//
+// - проверка делимости без деления: x % 5 == 0 <=> x * 5^-1 + c (mod 2^32) <= 2c,
+//   c = (2^31 - 1) / 5 (проверено на всех int32); AVX2 по 64 элемента
+//   с выходом на первом блоке, где есть неделящийся
+// - сортировка: до network_size элементов - сортирующая сеть Бэтчера,
+//   дальше - LSD radix по байтам (4 прохода, проход пропускается, если
+//   все элементы в нем попадают в одну корзину); гистограммы и раскладка
+//   по потокам, каждый поток пишет в свои заранее посчитанные смещения
+//
+// Результат тот же, что у обменной сортировки lab4.cpp: возрастающий порядок
+
+namespace sort5 {
+
+////////////////////////////////////////////////////////////////////////////////
+// ДЕЛИМОСТЬ НА 5
+////////////////////////////////////////////////////////////////////////////////
+
+constexpr std::uint32_t inverse5 = 0xCCCCCCCDu;   // 5 * inverse5 == 1 (mod 2^32)
+constexpr std::uint32_t bias = 429496729u;         // (2^31 - 1) / 5
+
+inline bool divisible_by_5(int x) {
+    return static_cast<std::uint32_t>(x) * inverse5 + bias <= 2 * bias;
+}
+
+inline bool all_divisible_scalar(std::span<const int> a) {
+    for (int x : a) {
+        if (!divisible_by_5(x)) return false;
+    }
+    return true;
+}
+
+__attribute__((target("avx2")))
+inline bool all_divisible_avx2(std::span<const int> a) {
+    const __m256i inverse = _mm256_set1_epi32(static_cast<int>(inverse5));
+    const __m256i offset = _mm256_set1_epi32(static_cast<int>(bias));
+    const __m256i limit = _mm256_set1_epi32(static_cast<int>(2 * bias));
+    const int* data = a.data();
+    std::size_t i = 0;
+    // Блок 64 элемента (8 векторов) - проверка выхода раз на блок
+    for (; i + 64 <= a.size(); i += 64) {
+        __m256i failed = _mm256_setzero_si256();
+        for (int k = 0; k < 8; ++k) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8 * k));
+            const __m256i test = _mm256_add_epi32(_mm256_mullo_epi32(x, inverse), offset);
+            failed = _mm256_or_si256(failed, _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_min_epu32(test, limit), test),
+                                                              _mm256_set1_epi32(-1)));
+        }
+        if (!_mm256_testz_si256(failed, failed)) return false;
+    }
+    return all_divisible_scalar(a.subspan(i));
+}
+
+inline bool all_divisible(std::span<const int> a) {
+    return __builtin_cpu_supports("avx2") ? all_divisible_avx2(a) : all_divisible_scalar(a);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// СОРТИРУЮЩАЯ СЕТЬ
+////////////////////////////////////////////////////////////////////////////////
+
+constexpr std::size_t network_size = 16;
+
+// Компараторы сети Бэтчера (odd-even merge sort) для n входов; для n не
+// степени двойки - сеть следующей степени без компараторов за n-1
+struct Network {
+    std::array<std::pair<std::uint8_t, std::uint8_t>, 63> pairs{};
+    std::size_t size = 0;
+
+    constexpr explicit Network(std::size_t n = 0) {
+        for (std::size_t p = 1; p < n; p <<= 1) {
+            for (std::size_t k = p; k >= 1; k >>= 1) {
+                for (std::size_t j = k % p; j + k < n; j += 2 * k) {
+                    for (std::size_t i = 0; i < std::min(k, n - j - k); ++i) {
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                            pairs[size++] = {static_cast<std::uint8_t>(i + j), static_cast<std::uint8_t>(i + j + k)};
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+inline constexpr auto networks = [] {
+    std::array<Network, network_size + 1> all;
+    for (std::size_t n = 0; n <= network_size; ++n) all[n] = Network(n);
+    return all;
+}();
+static_assert(networks[network_size].size == 63 && networks[7].size == 16);
+
+// До network_size элементов: min/max без ветвлений, на месте
+inline void network_sort(std::span<int> a) {
+    const Network& network = networks[a.size()];
+    int* v = a.data();
+    for (std::size_t c = 0; c < network.size; ++c) {
+        auto [i, j] = network.pairs[c];
+        const int low = std::min(v[i], v[j]);
+        const int high = std::max(v[i], v[j]);
+        v[i] = low;
+        v[j] = high;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// RADIX
+////////////////////////////////////////////////////////////////////////////////
+
+// Меньше этого - один поток (запуск потоков дороже самой работы)
+constexpr std::size_t parallel_threshold = 1 << 18;
+
+// Байт pass ключа; у старшего инвертирован знаковый бит, чтобы
+// отрицательные шли раньше положительных
+inline unsigned digit(int x, unsigned pass) {
+    return ((static_cast<std::uint32_t>(x) >> (8 * pass)) & 0xff) ^ (pass == 3 ? 0x80 : 0);
+}
+
+inline void radix_sort(std::span<int> a, unsigned threads = std::thread::hardware_concurrency()) {
+    const std::size_t n = a.size();
+    if (n <= network_size) {
+        network_sort(a);
+        return;
+    }
+    threads = n < parallel_threshold ? 1 : std::max(threads, 1u);
+
+    std::vector<int> buffer(n);
+    int* source = a.data();
+    int* target = buffer.data();
+    std::vector<std::array<std::size_t, 256>> counts(threads);
+    auto slice = [&](unsigned t) { return std::pair(n * t / threads, n * (t + 1) / threads); };
+
+    for (unsigned pass = 0; pass < 4; ++pass) {
+        workers::parallel_for(threads, [&](unsigned t) {
+            auto& count = counts[t];
+            count.fill(0);
+            auto [begin, end] = slice(t);
+            for (std::size_t i = begin; i < end; ++i) ++count[digit(source[i], pass)];
+        });
+
+        // Все в одной корзине - порядок по этому байту уже есть
+        std::size_t total_first = 0;
+        for (unsigned t = 0; t < threads; ++t) total_first += counts[t][digit(source[0], pass)];
+        if (total_first == n) continue;
+
+        // Смещения: корзина за корзиной, внутри корзины - по потокам (устойчиво)
+        std::size_t offset = 0;
+        for (unsigned d = 0; d < 256; ++d) {
+            for (unsigned t = 0; t < threads; ++t) {
+                std::size_t count = counts[t][d];
+                counts[t][d] = offset;
+                offset += count;
+            }
+        }
+
+        workers::parallel_for(threads, [&](unsigned t) {
+            auto& position = counts[t];
+            auto [begin, end] = slice(t);
+            for (std::size_t i = begin; i < end; ++i) target[position[digit(source[i], pass)]++] = source[i];
+        });
+        std::swap(source, target);
+    }
+
+    if (source != a.data()) {
+        workers::parallel_for(threads, [&](unsigned t) {
+            auto [begin, end] = slice(t);
+            std::memcpy(a.data() + begin, source + begin, (end - begin) * sizeof(int));
+        });
+    }
+}
+
+// Пункт 1 целиком; true - массив был отсортирован
+inline bool sort_if_divisible(std::span<int> a, unsigned threads = std::thread::hardware_concurrency()) {
+    if (!all_divisible(a)) return false;
+    radix_sort(a, threads);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ВВОД
+////////////////////////////////////////////////////////////////////////////////
+
+// Целые через пробельные символы; возвращает смещение первого
+// нераспознанного токена или npos
+inline std::size_t parse_ints(std::string_view text, std::vector<int>& out) {
+    const char* pos = text.data();
+    const char* end = pos + text.size();
+    while (true) {
+        while (pos < end && file_io::is_space(*pos)) ++pos;
+        if (pos == end) return std::string_view::npos;
+        int value;
+        auto [last, ec] = std::from_chars(pos, end, value);
+        if (ec != std::errc() || (last < end && !file_io::is_space(*last))) return pos - text.data();
+        out.push_back(value);
+        pos = last;
+    }
+}
+
+}
@@ -0,0 +1,112 @@
+// Команды меню lab5 в секунду: интерактивный цикл (синхронизированные
+// std::cin / std::cout, меню и подсказки) против режима скрипта (разбор по
+// тексту в памяти, буферизованный вывод) - одна и та же таблица options
+//
+// - iostream: stdin - файл команд, stdout - файл (как ./out < команды)
+// - script: тот же файл через ScriptText, вывод в файл
+// Вывод скрипта сверяется с интерактивным, из которого убраны меню и подсказки
+//
+// g++ -O2 bench/lab5_bench.cpp -o bench_out && ./bench_out [млн команд]
+
+#include "../options.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+static void erase_all(std::string& text, std::string_view what) {
+    std::string result;
+    std::size_t pos = 0, found;
+    while ((found = text.find(what, pos)) != std::string::npos) {
+        result.append(text, pos, found - pos);
+        pos = found + what.size();
+    }
+    result.append(text, pos);
+    text = std::move(result);
+}
+
+int main(int argc, char** argv) {
+    std::size_t commands = (argc > 1 ? std::strtod(argv[1], nullptr) : 2) * 1000000;
+    std::string base = "/tmp/lab5-bench-" + std::to_string(getpid());
+    std::string input_path = base + ".in", interactive_path = base + ".iostream", script_path = base + ".script";
+
+    // Вперемешку: повторы цифр (1 n 0 0), среднее (1 a b c), сфера (2 R)
+    {
+        std::mt19937 rng(42);
+        std::FILE* file = std::fopen(input_path.c_str(), "wb");
+        for (std::size_t i = 0; i < commands; ++i) {
+            switch (rng() % 3) {
+            case 0: std::fprintf(file, "1 %d 0 0\n", static_cast<int>(rng())); break;
+            case 1: std::fprintf(file, "1 %d %d %d\n", static_cast<int>(rng() % 20001) - 10000,
+                                 static_cast<int>(rng() % 201) - 100, static_cast<int>(rng() % 2001) - 1000); break;
+            default: std::fprintf(file, "2 %.4f\n", (rng() % 1000000) / 1000.0); break;
+            }
+        }
+        std::fprintf(file, "0\n");
+        std::fclose(file);
+    }
+    std::size_t input_bytes = read_file(input_path).size();
+    std::printf("%zu commands, %.1f MB\n", commands, input_bytes / 1e6);
+
+    auto report = [&](const char* name, double seconds) {
+        std::printf("  %-10s %8.3f s %10.2f M commands/s %8.1f MB/s\n", name, seconds, commands / seconds / 1e6,
+                    input_bytes / seconds / 1e6);
+    };
+
+    // Интерактивный цикл: подменяются дескрипторы 0 и 1
+    {
+        std::fflush(stdout);
+        int saved_in = dup(STDIN_FILENO), saved_out = dup(STDOUT_FILENO);
+        int in = open(input_path.c_str(), O_RDONLY);
+        int out = open(interactive_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(in, STDIN_FILENO);
+        dup2(out, STDOUT_FILENO);
+        auto start = Clock::now();
+        script::Session session;
+        run(session);
+        std::cout.flush();
+        std::fflush(stdout);
+        double seconds = seconds_since(start);
+        dup2(saved_in, STDIN_FILENO);
+        dup2(saved_out, STDOUT_FILENO);
+        for (int fd : {in, out, saved_in, saved_out}) close(fd);
+        report("iostream", seconds);
+    }
+
+    {
+        int out = open(script_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        auto start = Clock::now();
+        script::ScriptText input(input_path.c_str());
+        script::Session session(input.text(), out);
+        run(session);
+        session.flush();
+        double seconds = seconds_since(start);
+        close(out);
+        report("script", seconds);
+    }
+
+    std::string expected = read_file(interactive_path);
+    erase_all(expected, "\nChoose option:\n0 - exit\n1 - first option\n2 - second option\n");
+    erase_all(expected, "You picked 1st option. Enter 3 numbers (eq 0 => ignore): ");
+    erase_all(expected, "You picked 2nd option. Enter one double number: ");
+    bool same = expected == read_file(script_path);
+    std::printf("  results agree: %s (%.1f MB of results)\n", same ? "yes" : "NO", expected.size() / 1e6);
+
+    for (const std::string& path : {input_path, interactive_path, script_path}) std::remove(path.c_str());
+    return same ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <charconv>
+#include "session.hpp"
+#include "../common/digit_stats.hpp"
+
+// Пункты меню lab5 и их таблица: общие для интерактивного режима и
+// скрипта (см. session.hpp)
+
+inline void exit(script::Session& session){
+    session.stop();
+}
+
+
+inline float handle_option1(int n){
+    // Повторы наибольшей цифры - по десятичной записи, без деления на 10
+    // (знак пропускается, поэтому и для отрицательных n)
+    char text[16];
+    char* end = std::to_chars(text, text + sizeof(text), n).ptr;
+    return digits::max_digit(std::string_view(text, end - text)).max_count;
+};
+
+inline float handle_option1(int a, int b, int c){
+    if( a == b && b == c){
+        return a;
+    } else {
+        return abs(a + b + c)/3.f;
+    }
+};
+
+inline void option1(script::Session& session){
+    session.prompt("You picked 1st option. Enter 3 numbers (eq 0 => ignore): ");
+    int a, b, c; if (!session.read(a) || !session.read(b) || !session.read(c)) return;
+    int arg_cout = (a != 0) + (b != 0) + (c != 0);
+
+    if (arg_cout == 1){
+        session<<"Biggest digit repeats is: "<<static_cast<int>(handle_option1(a+b+c))<<script::endl;
+    } else if (arg_cout == 3){
+        session<<"Absolute middle valule of numbers is: "<<handle_option1(a, b, c)<<script::endl;
+    } else {
+        session<<"Unsupported input for option 1!\n";
+    }
+}
+
+inline void L1(script::Session& session, double R) {
+    #define PI 13.1415
+    // Строка о типе от R не зависит - форматируется один раз (тем же
+    // потоком, что и std::cout, поэтому вывод прежний)
+    static const std::string type_info = []{
+        std::ostringstream text;
+        text
+            << "Type \"double\" has size "
+            << sizeof(double)
+            << " bytes and has value range from "
+            << std::numeric_limits<double>::min()
+            << " to "<<std::numeric_limits<double>::max()
+        ;
+        return text.str();
+    }();
+    session<<type_info<<script::endl;
+    session<<"V= "<< (4/3) * PI * pow(R, 3)<<script::endl;
+    session<<"S= "<< 4 * PI * pow(R, 2)<<script::endl;
+}
+
+inline void option2(script::Session& session){
+    session.prompt("You picked 2nd option. Enter one double number: ");
+    double R; if (!session.read(R)) return;
+    L1(session, R);
+}
+
+using option_t = void (*)(script::Session&);
+const size_t options_count = 2;
+
+const option_t options[] = {exit, option1, option2};
+
+// Цикл меню до пункта 0 или конца ввода
+inline void run(script::Session& session){
+    while(session.running()){
+        session.prompt("\nChoose option:\n0 - exit\n1 - first option\n2 - second option\n");
+        int option; if (!session.read(option)) break; if (option < 0 || option > options_count) continue;
+        options[option](session);
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../common/file_io.hpp"
+
+// Ввод-вывод пунктов меню lab5: одни и те же функции пунктов работают
+// в двух режимах
+// - интерактивный: std::cin / std::cout, меню и подсказки печатаются
+// - скрипт: команды (номер пункта и его аргументы) из файла или канала,
+//   разбор без копирования прямо по тексту (from_chars), подсказки
+//   подавляются, результаты копятся в буфере и пишутся большими кусками
+//
+// Числа в скрипте форматируются to_chars с точностью 6 (как std::cout по
+// умолчанию), поэтому строки результатов совпадают с интерактивными
+
+namespace script {
+
+////////////////////////////////////////////////////////////////////////////////
+// ТЕКСТ СКРИПТА
+////////////////////////////////////////////////////////////////////////////////
+
+// Обычный файл отображается в память (file_io::InputFile), канал
+// ("-" - стандартный ввод) читается целиком
+class ScriptText {
+public:
+    explicit ScriptText(const char* path) {
+        const bool is_stdin = std::string_view(path) == "-";
+        struct stat st;
+        if (!is_stdin && stat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+            file_.emplace(path);
+            ok_ = file_->ok();
+            return;
+        }
+        int fd = is_stdin ? STDIN_FILENO : open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        char chunk[1 << 16];
+        ssize_t got;
+        while ((got = read(fd, chunk, sizeof(chunk))) > 0) copy_.append(chunk, got);
+        ok_ = got == 0;
+        if (!is_stdin) close(fd);
+    }
+
+    bool ok() const { return ok_; }
+    std::string_view text() const { return file_ ? file_->text() : std::string_view(copy_); }
+
+private:
+    std::optional<file_io::InputFile> file_;
+    std::string copy_;
+    bool ok_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// СЕАНС
+////////////////////////////////////////////////////////////////////////////////
+
+// Конец строки: std::endl в интерактивном режиме, '\n' в буфер в скрипте
+struct EndLine {};
+inline constexpr EndLine endl;
+
+class Session {
+public:
+    // Интерактивный режим
+    Session() = default;
+
+    // Скрипт: команды из text, результаты - в fd
+    Session(std::string_view text, int fd)
+        : interactive_(false), text_(text), out_(std::make_unique<file_io::OutputBuffer>(fd)) {}
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    ~Session() { flush(); }
+
+    bool interactive() const { return interactive_; }
+    bool running() const { return running_; }
+    void stop() { running_ = false; }
+
+    // Смещение нераспознанного токена скрипта или npos
+    std::size_t error() const { return error_; }
+    bool write_failed() const { return write_failed_; }
+
+    // Неудачное чтение (конец ввода, не число) завершает сеанс
+    template<typename T>
+    bool read(T& value) {
+        if (interactive_) {
+            if (std::cin >> value) return true;
+        } else {
+            while (pos_ < text_.size() && static_cast<unsigned char>(text_[pos_]) <= ' ') ++pos_;
+            if (pos_ == text_.size()) {
+                stop();
+                return false;
+            }
+            // Знак '+' допускается, как и у std::cin
+            const char* first = text_.data() + pos_ + (text_[pos_] == '+');
+            const char* end = text_.data() + text_.size();
+            auto [last, ec] = std::from_chars(first, end, value);
+            if (ec == std::errc() && (last == end || static_cast<unsigned char>(*last) <= ' ')) {
+                pos_ = last - text_.data();
+                return true;
+            }
+            error_ = pos_;
+        }
+        stop();
+        return false;
+    }
+
+    // Меню и подсказки - только в интерактивном режиме
+    void prompt(std::string_view text) {
+        if (interactive_) std::cout << text;
+    }
+
+    Session& operator<<(std::string_view text) {
+        if (interactive_) {
+            std::cout << text;
+        } else {
+            // Текст длиннее буфера уходит кусками по размеру буфера
+            while (!text.empty()) {
+                const std::size_t size = std::min(text.size(), file_io::OutputBuffer::capacity);
+                char* first = out_->reserve(size);
+                std::memcpy(first, text.data(), size);
+                out_->commit(first + size);
+                text.remove_prefix(size);
+            }
+        }
+        return *this;
+    }
+
+    Session& operator<<(const char* text) { return *this << std::string_view(text); }
+    Session& operator<<(int value) { return format(value); }
+    Session& operator<<(std::size_t value) { return format(value); }
+    Session& operator<<(float value) { return format(value); }
+    Session& operator<<(double value) { return format(value); }
+
+    Session& operator<<(EndLine) {
+        if (interactive_) std::cout << std::endl;
+        else *this << "\n";
+        return *this;
+    }
+
+    void flush() {
+        if (!interactive_ && !out_->flush()) write_failed_ = true;
+    }
+
+private:
+    static constexpr std::size_t max_number = 32;
+
+    template<typename T>
+    Session& format(T value) {
+        if (interactive_) {
+            std::cout << value;
+            return *this;
+        }
+        char* first = out_->reserve(max_number);
+        std::to_chars_result result;
+        if constexpr (std::is_floating_point_v<T>) {
+            result = std::to_chars(first, first + max_number, value, std::chars_format::general, 6);
+        } else {
+            result = std::to_chars(first, first + max_number, value);
+        }
+        out_->commit(result.ptr);
+        return *this;
+    }
+
+    bool interactive_ = true;
+    bool running_ = true;
+    std::string_view text_;
+    std::size_t pos_ = 0;
+    std::size_t error_ = std::string_view::npos;
+    std::unique_ptr<file_io::OutputBuffer> out_;  // Только в скрипте
+    bool write_failed_ = false;
+};
+
+}
@@ -0,0 +1,150 @@
+// Удаление строк с нулями из матрицы lab6: прежний путь (индексы строк в
+// массиве, который растет realloc на каждую найденную строку, и сдвиг всех
+// следующих строк на каждое удаление - O(k * N)) против RowMask + compact
+//
+// - detect: поиск строк с нулями; прежний - скалярный проход с realloc,
+//   rows_with_zero - скалярно и AVX2, 1..T потоков
+// - exclude: прежний сдвиг указателей строк (T**) на каждое удаление и
+//   Matrix::erase_row на каждое удаление (сдвиг данных) - только для малых
+//   N, иначе квадратичное время; compact - один проход
+// Доля строк с нулем 0%, 50%, 90% (один 0 в случайном месте строки).
+// Оставшиеся строки всех способов сверяются
+//
+// g++ -O2 -pthread bench/filter_bench.cpp -o bench_out && ./bench_out [строк] [столбцов]
+
+#include "../row_filter.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Прежний get_rows_contains_zero: [0] - число найденных строк, дальше номера
+static int* legacy_rows_contains_zero(dense::MatrixView<const int> matrix) {
+    int* indexes = static_cast<int*>(malloc(sizeof(int)));
+    indexes[0] = 0;
+    for (size_t i = 0; i < matrix.rows; i++) {
+        for (size_t j = 0; j < matrix.cols; j++) {
+            if (matrix[i][j] == 0) {
+                indexes[0]++;
+                indexes = static_cast<int*>(realloc(indexes, (indexes[0] + 1) * sizeof(int)));
+                indexes[indexes[0]] = i;
+                break;
+            }
+        }
+    }
+    return indexes;
+}
+
+// Прежний exclude_row по указателям строк; номер поправлен на число уже
+// удаленных строк (в lab6 он оставался исходным)
+static void legacy_exclude(const int** pointers, size_t& n, const int* indexes) {
+    for (int k = 1; k <= indexes[0]; k++) {
+        const size_t row = indexes[k] - (k - 1);
+        for (size_t i = row; i < n - 1; i++) pointers[i] = pointers[i + 1];
+        --n;
+    }
+}
+
+static void fill(dense::Matrix<int>& matrix, double density, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution has_zero(density);
+    for (std::size_t i = 0; i < matrix.rows(); i++) {
+        for (int& x : matrix[i]) x = static_cast<int>(rng() % 1000) + 1;
+        if (has_zero(rng)) matrix[i][rng() % matrix.cols()] = 0;
+    }
+}
+
+static void report(const char* name, double seconds, std::size_t elements) {
+    std::printf("    %-24s %9.3f ms %8.2f G elements/s\n", name, seconds * 1e3, elements / seconds / 1e9);
+}
+
+static bool same_rows(dense::MatrixView<const int> a, dense::MatrixView<const int> b) {
+    if (a.rows != b.rows || a.cols != b.cols) return false;
+    for (std::size_t i = 0; i < a.rows; i++) {
+        if (std::memcmp(a.row(i), b.row(i), a.cols * sizeof(int))) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t big_rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t cols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    const std::size_t small_rows = std::min<std::size_t>(big_rows, 20000);
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    const bool avx2 = rows::avx2_supported();
+    bool same = true;
+
+    for (double density : {0.0, 0.5, 0.9}) {
+        for (std::size_t n : {small_rows, big_rows}) {
+            std::printf("%zu x %zu, %.0f%% rows with zero\n", n, cols, density * 100);
+            dense::Matrix<int> matrix(n, cols);
+            fill(matrix, density, 42);
+            const std::size_t elements = n * cols;
+
+            // detect
+            auto start = Clock::now();
+            int* indexes = legacy_rows_contains_zero(matrix.view());
+            report("legacy detect", seconds_since(start), elements);
+
+            rows::RowMask zero;
+            for (bool simd : {false, true}) {
+                if (simd && !avx2) continue;
+                for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+                    start = Clock::now();
+                    zero = rows::rows_with_zero(matrix.view(), threads, simd);
+                    char name[64];
+                    std::snprintf(name, sizeof(name), "rows_with_zero %s x%u", simd ? "avx2" : "scalar", threads);
+                    report(name, seconds_since(start), elements);
+                    same = same && zero.count() == static_cast<std::size_t>(indexes[0]);
+                }
+            }
+
+            // exclude
+            dense::Matrix<int> expected(0, cols);
+            {
+                rows::RowMask keep(n, true);
+                keep -= zero;
+                expected.resize(keep.count(), cols);
+                std::size_t target = 0;
+                keep.for_each([&](std::size_t i) { std::memcpy(expected[target++].data(), matrix[i].data(), cols * sizeof(int)); });
+            }
+
+            if (n == small_rows) {
+                std::vector<const int*> pointers(n);
+                for (std::size_t i = 0; i < n; i++) pointers[i] = matrix[i].data();
+                std::size_t left = n;
+                start = Clock::now();
+                legacy_exclude(pointers.data(), left, indexes);
+                report("legacy pointer shift", seconds_since(start), elements);
+                same = same && left == expected.rows();
+                for (std::size_t i = 0; same && i < left; i++) same = !std::memcmp(pointers[i], expected[i].data(), cols * sizeof(int));
+
+                dense::Matrix<int> copy(n, cols);
+                std::memcpy(copy.data(), matrix.data(), n * matrix.stride() * sizeof(int));
+                start = Clock::now();
+                for (int k = indexes[0]; k >= 1; k--) copy.erase_row(indexes[k]);
+                report("erase_row per row", seconds_since(start), elements);
+                same = same && same_rows(copy.view(), expected.view());
+            }
+            free(indexes);
+
+            start = Clock::now();
+            rows::RowMask keep(n, true);
+            keep -= zero;
+            rows::compact(matrix, keep);
+            report("RowMask + compact", seconds_since(start), elements);
+            same = same && same_rows(matrix.view(), expected.view());
+            if (small_rows == big_rows) break;
+        }
+    }
+
+    std::printf("  results agree: %s\n", same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
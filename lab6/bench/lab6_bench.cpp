@@ -0,0 +1,148 @@
+// Раскладка матрицы lab6: T** (malloc на строку, realloc каждой строки)
+// против dense::Matrix<T> (один выровненный блок с шагом строки)
+//
+// - alloc: матрица N x M целиком (T**: N + 1 выделений); Matrix заполняет
+//   нулями и сразу трогает страницы, T** платит за них в fill - сравнивать
+//   стоит сумму alloc + fill
+// - grow: рост по одной строке до N строк (T**: realloc_matrix из lab6
+//   перевыделяет каждую строку на каждом шаге)
+// - fill: заполнение формулой из lab6 (C * i + D * j)
+// - sum: обход всех элементов по строкам (пропускная способность)
+// Для T** - функции из прежнего lab6.cpp со счетчиком вызовов (alloc_matrix
+// с исправленной границей цикла: n, а не m); для Matrix считаются вызовы
+// выровненного operator new. Суммы обеих раскладок сверяются
+//
+// g++ -O2 bench/lab6_bench.cpp -o bench_out && ./bench_out
+
+#include "../matrix.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static std::size_t allocations = 0;
+
+// Выделения Matrix
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++allocations;
+    if (void* p = std::aligned_alloc(static_cast<std::size_t>(alignment), size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+////////////////////////////////////////////////////////////////////////////////
+// T** ИЗ LAB6
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+T** alloc_matrix(size_t n, size_t m) {
+    T** matrix = static_cast<T**>(malloc(sizeof(T*)*n)); ++allocations;
+    for(size_t i = 0; i < n; i++) { matrix[i] = static_cast<T*>(malloc(sizeof(T)*m)); ++allocations; }
+    return matrix;
+}
+
+// Как в lab6, но указатели новых строк обнуляются до realloc
+template <typename T>
+void realloc_matrix(T*** matrix_ptr, size_t old_n, size_t n, size_t m) {
+    T**& matrix = *matrix_ptr;
+    matrix = static_cast<T**>(realloc(matrix, sizeof(T*) * n)); ++allocations;
+    for (size_t i = old_n; i < n; i++) matrix[i] = nullptr;
+    for (size_t i = 0; i < n; i++) { matrix[i] = static_cast<T*>(realloc(matrix[i], sizeof(T) * m)); ++allocations; }
+}
+
+template <typename T>
+void free_matrix(T** matrix, size_t n) {
+    for (size_t i = 0; i < n; i++) free(matrix[i]);
+    free(matrix);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct Stats { double seconds; std::size_t allocations; };
+
+template<typename Run>
+static Stats measure(Run&& run) {
+    allocations = 0;
+    auto start = Clock::now();
+    run();
+    return {seconds_since(start), allocations};
+}
+
+static void report(const char* name, const Stats& pointers, const Stats& dense, std::size_t bytes = 0) {
+    std::printf("  %-6s T** %9.3f ms %9zu allocs | Matrix %9.3f ms %6zu allocs", name, pointers.seconds * 1e3,
+                pointers.allocations, dense.seconds * 1e3, dense.allocations);
+    if (bytes) std::printf(" | %6.2f vs %6.2f GB/s", bytes / pointers.seconds / 1e9, bytes / dense.seconds / 1e9);
+    std::printf("\n");
+}
+
+int main() {
+    struct Shape { std::size_t n, m; };
+    const Shape shapes[] = {{4096, 4096}, {1000000, 16}, {16, 1000000}, {100000, 3}};
+    const int C = 3, D = -7;
+    bool same = true;
+
+    for (const Shape& shape : shapes) {
+        const std::size_t n = shape.n, m = shape.m, bytes = n * m * sizeof(int);
+        std::printf("%zu x %zu\n", n, m);
+
+        int** pointers = nullptr;
+        dense::Matrix<int> matrix;
+        Stats a = measure([&] { pointers = alloc_matrix<int>(n, m); });
+        Stats b = measure([&] { matrix.resize(n, m); });
+        report("alloc", a, b);
+
+        a = measure([&] {
+            for (std::size_t i = 0; i < n; i++) {
+                for (std::size_t j = 0; j < m; j++) pointers[i][j] = C * i + D * j;
+            }
+        });
+        b = measure([&] {
+            for (std::size_t i = 0; i < n; i++) {
+                for (std::size_t j = 0; j < m; j++) matrix[i][j] = C * i + D * j;
+            }
+        });
+        report("fill", a, b, bytes);
+
+        long long sum_pointers = 0, sum_dense = 0;
+        a = measure([&] {
+            for (std::size_t i = 0; i < n; i++) {
+                for (std::size_t j = 0; j < m; j++) sum_pointers += pointers[i][j];
+            }
+        });
+        b = measure([&] {
+            for (std::size_t i = 0; i < n; i++) {
+                for (int x : matrix[i]) sum_dense += x;
+            }
+        });
+        report("sum", a, b, bytes);
+        same = same && sum_pointers == sum_dense;
+        free_matrix(pointers, n);
+    }
+
+    // Рост по строке: T** перевыделяет все строки на каждом шаге (O(N^2))
+    for (std::size_t n : {1000, 4000}) {
+        const std::size_t m = 16;
+        std::printf("grow to %zu x %zu by one row\n", n, m);
+        int** pointers = nullptr;
+        dense::Matrix<int> matrix;
+        Stats a = measure([&] {
+            for (std::size_t rows = 1; rows <= n; ++rows) realloc_matrix(&pointers, rows - 1, rows, m);
+        });
+        Stats b = measure([&] {
+            for (std::size_t rows = 1; rows <= n; ++rows) matrix.resize(rows, m);
+        });
+        report("grow", a, b);
+        free_matrix(pointers, n);
+    }
+
+    std::printf("  results agree: %s\n", same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
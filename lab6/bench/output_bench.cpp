@@ -0,0 +1,108 @@
+// Вывод матрицы в файл, элементов в секунду (common/table_output.hpp):
+// - cout-style: std::ofstream, элемент << "\t", в конце строки std::endl
+//   (как прежние print_matrix / print_arr / циклы lab4)
+// - text: table::Writer (to_chars в буфер 1 МБ, один flush в конце)
+// - binary: table::write_binary (заголовок и строки подряд)
+// - mmap back: table::MappedMatrix и сумма всех элементов
+// Текст обоих способов и прочитанный обратно дамп сверяются с матрицей
+//
+// g++ -O2 bench/output_bench.cpp -o bench_out && ./bench_out [каталог]
+
+#include "../matrix.hpp"
+#include "../../common/table_output.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+static void report(const char* name, double seconds, std::size_t elements, std::size_t bytes) {
+    std::printf("    %-12s %9.3f ms %8.1f M elements/s %8.1f MB/s\n", name, seconds * 1e3, elements / seconds / 1e6,
+                bytes / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+    const std::string base = std::string(argc > 1 ? argv[1] : "/tmp") + "/output-bench-" + std::to_string(getpid());
+    const std::string legacy_path = base + ".cout", text_path = base + ".txt", binary_path = base + ".bin";
+
+    struct Shape { std::size_t n, m; };
+    const Shape shapes[] = {{4096, 4096}, {1000000, 4}, {1, 10000000}};
+    std::mt19937 rng(7);
+    bool same = true;
+
+    for (const Shape& shape : shapes) {
+        const std::size_t n = shape.n, m = shape.m, elements = n * m;
+        dense::Matrix<int> matrix(n, m);
+        for (std::size_t i = 0; i < n; i++) {
+            for (int& x : matrix[i]) x = static_cast<int>(rng() % 2000001) - 1000000;
+        }
+        std::printf("%zu x %zu\n", n, m);
+
+        auto start = Clock::now();
+        {
+            std::ofstream out(legacy_path);
+            for (std::size_t i = 0; i < n; i++) {
+                for (std::size_t j = 0; j < m; j++) out << matrix[i][j] << "\t";
+                out << std::endl;
+            }
+        }
+        double seconds = seconds_since(start);
+        const std::string legacy = read_file(legacy_path);
+        report("cout-style", seconds, elements, legacy.size());
+
+        start = Clock::now();
+        {
+            const int fd = open(text_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            {
+                table::Writer out(fd);
+                same = out.matrix(matrix.data(), n, m, matrix.stride()).flush() && same;
+            }
+            close(fd);
+        }
+        seconds = seconds_since(start);
+        same = same && read_file(text_path) == legacy;
+        report("text", seconds, elements, legacy.size());
+
+        start = Clock::now();
+        same = table::write_binary(binary_path.c_str(), matrix.data(), n, m, matrix.stride()) && same;
+        seconds = seconds_since(start);
+        report("binary", seconds, elements, sizeof(table::BinaryHeader) + elements * sizeof(int));
+
+        start = Clock::now();
+        long long sum = 0;
+        {
+            table::MappedMatrix<int> dump(binary_path.c_str());
+            same = same && dump.ok() && dump.rows() == n && dump.cols() == m;
+            for (std::size_t k = 0; same && k < elements; k++) sum += dump.data()[k];
+            seconds = seconds_since(start);
+            for (std::size_t i = 0; same && i < n; i++) same = std::memcmp(dump.row(i).data(), matrix[i].data(), m * sizeof(int)) == 0;
+        }
+        report("mmap back", seconds, elements, elements * sizeof(int));
+
+        long long expected = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            for (int x : matrix[i]) expected += x;
+        }
+        same = same && sum == expected;
+    }
+
+    for (const std::string& path : {legacy_path, text_path, binary_path}) std::remove(path.c_str());
+    std::printf("  results agree: %s\n", same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
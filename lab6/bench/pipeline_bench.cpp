@@ -0,0 +1,164 @@
+// Матрица lab6 целиком по шагам (заполнение, вывод, маска строк с нулями,
+// compact, вывод - как ветка A или B = 0 в lab6.cpp) против ленивого
+// выражения lazy::variant4 | without_zero_rows (одна строка в памяти)
+//
+// Каждый способ идет в отдельном процессе: пиковая память - ru_maxrss
+// дочернего процесса (wait4), время - внутри процесса. Вывод не пишется на
+// диск, а хэшируется (FNV-1a); хэши обоих способов сверяются
+//
+// g++ -O2 -pthread bench/pipeline_bench.cpp -o bench_out && ./bench_out [A B C D]
+
+#include "../pipeline.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Вывод, который только хэширует и считает байты: FNV-1a по 8 байт
+// (неполное слово ждет следующей записи - хэш не зависит от того, как
+// вывод порезан на write). Writer пишет в канал, поток читает и хэширует
+class Hash {
+public:
+    std::size_t bytes = 0;
+
+    std::uint64_t value() const {
+        std::uint64_t word = 0;
+        std::memcpy(&word, pending_, bytes % 8);
+        return (hash_ ^ word) * 1099511628211ull;
+    }
+
+    void update(const char* s, std::size_t count) {
+        std::size_t k = 0;
+        while (k < count) {
+            const std::size_t used = bytes % 8;
+            if (used == 0 && count - k >= 8) {
+                std::uint64_t word;
+                std::memcpy(&word, s + k, 8);
+                hash_ = (hash_ ^ word) * 1099511628211ull;
+                k += 8;
+                bytes += 8;
+                continue;
+            }
+            pending_[used] = s[k++];
+            if (++bytes % 8 == 0) {
+                std::uint64_t word;
+                std::memcpy(&word, pending_, 8);
+                hash_ = (hash_ ^ word) * 1099511628211ull;
+            }
+        }
+    }
+
+    // Дескриптор для записи; -1 при ошибке
+    int open() {
+        int channel[2];
+        if (pipe(channel)) return -1;
+        reader_ = std::thread([this, fd = channel[0]] {
+            char chunk[1 << 16];
+            ssize_t got;
+            while ((got = read(fd, chunk, sizeof(chunk))) > 0) update(chunk, got);
+            ::close(fd);
+        });
+        return channel[1];
+    }
+
+    // Конец вывода: канал закрывается, хэш дочитывается
+    void close(int fd) {
+        ::close(fd);
+        reader_.join();
+    }
+
+private:
+    std::thread reader_;
+    std::uint64_t hash_ = 14695981039346656037ull;
+    char pending_[8] = {};
+};
+
+struct Result { double seconds; std::uint64_t hash; std::size_t bytes; };
+
+static void eager(int a, int b, int c, int d, table::Writer& out) {
+    dense::Matrix<int> matrix(2, 2);
+    matrix[0][0] = a; matrix[0][1] = b; matrix[1][0] = c; matrix[1][1] = d;
+    const std::size_t n = a + 2, m = b + 2;
+    matrix.resize(n, m);
+    for (std::size_t i = n; i-- > 0;) {
+        for (std::size_t j = m; j-- > 0;) {
+            if (i > n - 3 && j > m - 3) matrix[i][j] = matrix[i - n + 2][j - m + 2];
+            else matrix[i][j] = matrix[n - 1][m - 2] * static_cast<int>(i) + matrix[n - 1][m - 1] * static_cast<int>(j);
+        }
+    }
+    lazy::print(lazy::rows_of(matrix.view()), out);
+    rows::RowMask keep(matrix.rows(), true);
+    keep -= rows::rows_with_zero(matrix.view());
+    rows::compact(matrix, keep);
+    lazy::print(lazy::rows_of(matrix.view()), out);
+}
+
+static void fused(int a, int b, int c, int d, table::Writer& out) {
+    auto generated = lazy::variant4(a, b, c, d);
+    lazy::print(generated, out);
+    lazy::print(generated | lazy::without_zero_rows(), out);
+}
+
+// Запуск в дочернем процессе: результат через pipe, пиковая память - из wait4
+template<typename Run>
+static Result in_child(const char* name, Run&& run, long& peak_kb) {
+    int channel[2];
+    if (pipe(channel)) std::exit(2);
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        Hash hash;
+        const int fd = hash.open();
+        if (fd < 0) _exit(2);
+        auto start = Clock::now();
+        {
+            table::Writer out(fd);
+            run(out);
+        }
+        hash.close(fd);
+        Result result{seconds_since(start), hash.value(), hash.bytes};
+        if (write(channel[1], &result, sizeof(result)) != sizeof(result)) _exit(2);
+        _exit(0);
+    }
+    close(channel[1]);
+    Result result{};
+    if (read(channel[0], &result, sizeof(result)) != sizeof(result)) std::printf("  %s failed\n", name);
+    close(channel[0]);
+    int status;
+    rusage usage{};
+    wait4(pid, &status, 0, &usage);
+    peak_kb = usage.ru_maxrss;
+    std::printf("  %-6s %9.3f s %8.1f MB peak RSS %8.1f MB of text\n", name, result.seconds, peak_kb / 1024.0,
+                result.bytes / 1e6);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    int a = 20000, b = 4998, c = 3, d = -2;
+    if (argc > 4) a = std::atoi(argv[1]), b = std::atoi(argv[2]), c = std::atoi(argv[3]), d = std::atoi(argv[4]);
+    if (a < 1 || b < 1) {
+        std::printf("A, B >= 1\n");
+        return 2;
+    }
+    std::printf("%d x %d (A=%d B=%d C=%d D=%d), matrix %.1f MB\n", a + 2, b + 2, a, b, c, d,
+                (a + 2.0) * (b + 2.0) * sizeof(int) / 1e6);
+
+    long eager_kb, fused_kb;
+    Result e = in_child("eager", [&](table::Writer& out) { eager(a, b, c, d, out); }, eager_kb);
+    Result f = in_child("fused", [&](table::Writer& out) { fused(a, b, c, d, out); }, fused_kb);
+    std::printf("  speedup %.2fx, peak memory %.1fx lower\n", e.seconds / f.seconds, double(eager_kb) / fused_kb);
+
+    bool same = e.bytes == f.bytes && e.hash == f.hash;
+    std::printf("  results agree: %s\n", same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Матрица одним выровненным (64 байта) блоком вместо T** со своим malloc на
+// каждую строку:
+// - строки идут подряд с шагом stride (>= cols); если 64 делится на
+//   sizeof(T), шаг кратен строке кэша и каждая строка начинается с ее
+//   границы (узкие строки - шаг степень двойки, см. round_stride)
+// - resize растет с запасом (в 1.5 раза по строкам и по шагу), поэтому
+//   серия увеличений стоит амортизированно O(1) выделений; при том же шаге
+//   строки переносятся одним memcpy
+// - matrix[i] - std::span строки, view() - MatrixView (указатель, размеры,
+//   шаг) для функций, которым не нужно владение; оба ничего не копируют
+//
+// Элементы - тривиально копируемые (переносятся memcpy / memmove), новые
+// ячейки заполняются нулями
+
+namespace dense {
+
+template<typename T>
+struct MatrixView {
+    T* data = nullptr;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::size_t stride = 0;   // Элементов между началами строк
+
+    T* row(std::size_t i) const { return data + i * stride; }
+    std::span<T> operator[](std::size_t i) const { return {row(i), cols}; }
+
+    // Строки [first, first + count)
+    MatrixView rows_range(std::size_t first, std::size_t count) const { return {row(first), count, cols, stride}; }
+
+    operator MatrixView<const T>() const { return {data, rows, cols, stride}; }
+};
+
+template<typename T>
+class Matrix {
+    static_assert(std::is_trivially_copyable_v<T>, "rows are moved with memcpy");
+
+public:
+    static constexpr std::size_t alignment = 64;
+
+    Matrix() = default;
+    Matrix(std::size_t rows, std::size_t cols) { resize(rows, cols); }
+
+    Matrix(const Matrix&) = delete;
+    Matrix& operator=(const Matrix&) = delete;
+
+    Matrix(Matrix&& other) noexcept { swap(other); }
+    Matrix& operator=(Matrix&& other) noexcept {
+        Matrix(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~Matrix() { deallocate(data_); }
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t stride() const { return stride_; }
+    std::size_t capacity() const { return capacity_; }   // Строк без перевыделения
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    std::span<T> operator[](std::size_t i) { return {data_ + i * stride_, cols_}; }
+    std::span<const T> operator[](std::size_t i) const { return {data_ + i * stride_, cols_}; }
+
+    MatrixView<T> view() { return {data_, rows_, cols_, stride_}; }
+    MatrixView<const T> view() const { return {data_, rows_, cols_, stride_}; }
+
+    // Левый верхний угол min(rows) x min(cols) сохраняется, новое - нули
+    void resize(std::size_t rows, std::size_t cols) {
+        const std::size_t keep_rows = std::min(rows, rows_);
+        const std::size_t keep_cols = std::min(cols, cols_);
+        if (cols > stride_ || rows > capacity_) {
+            const std::size_t stride = cols > stride_ ? round_stride(std::max(cols, stride_ + stride_ / 2)) : stride_;
+            const std::size_t capacity = rows > capacity_ ? std::max(rows, capacity_ + capacity_ / 2) : capacity_;
+            T* fresh = allocate(capacity * stride);
+            if (keep_rows && stride == stride_) {
+                std::memcpy(fresh, data_, keep_rows * stride * sizeof(T));
+            } else {
+                for (std::size_t i = 0; i < keep_rows; ++i) {
+                    std::memcpy(fresh + i * stride, data_ + i * stride_, keep_cols * sizeof(T));
+                }
+            }
+            deallocate(data_);
+            data_ = fresh;
+            stride_ = stride;
+            capacity_ = capacity;
+        }
+        if (cols > keep_cols) {
+            for (std::size_t i = 0; i < keep_rows; ++i) {
+                std::memset(data_ + i * stride_ + keep_cols, 0, (cols - keep_cols) * sizeof(T));
+            }
+        }
+        if (rows > keep_rows) std::memset(data_ + keep_rows * stride_, 0, (rows - keep_rows) * stride_ * sizeof(T));
+        rows_ = rows;
+        cols_ = cols;
+    }
+
+    // Удаляет строку i: следующие строки сдвигаются одним memmove
+    void erase_row(std::size_t i) {
+        if (i >= rows_) return;
+        std::memmove(data_ + i * stride_, data_ + (i + 1) * stride_, (rows_ - i - 1) * stride_ * sizeof(T));
+        --rows_;
+    }
+
+    void swap(Matrix& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(rows_, other.rows_);
+        std::swap(cols_, other.cols_);
+        std::swap(stride_, other.stride_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+private:
+    // Шаг в целых строках кэша, если элемент укладывается в нее без остатка;
+    // строки короче строки кэша - степень двойки (строка не пересекает
+    // границу строки кэша, а узкая матрица не раздувается)
+    static std::size_t round_stride(std::size_t cols) {
+        if constexpr (alignment % sizeof(T) == 0) {
+            constexpr std::size_t per_line = alignment / sizeof(T);
+            if (cols < per_line) return std::bit_ceil(cols);
+            return (cols + per_line - 1) / per_line * per_line;
+        } else {
+            return cols;
+        }
+    }
+
+    static T* allocate(std::size_t count) {
+        const std::size_t bytes = (std::max<std::size_t>(count * sizeof(T), 1) + alignment - 1) / alignment * alignment;
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(alignment)));
+    }
+
+    static void deallocate(T* data) {
+        if (data) ::operator delete(data, std::align_val_t(alignment));
+    }
+
+    T* data_ = nullptr;
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::size_t stride_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "matrix.hpp"
+#include "row_filter.hpp"
+#include "../common/table_output.hpp"
+
+// Ленивые выражения над строками матрицы: источник (готовая матрица или
+// формула ячейки) | фильтры строк -> вывод. Выражение - только тип и
+// параметры, ничего не считается до вывода; тогда все стадии идут одним
+// проходом по строкам:
+// - generate считает очередную строку в буфер на одну строку, поэтому
+//   матрица N x M целиком в памяти не появляется
+// - отброшенные фильтром строки никуда не копируются
+// - print форматирует строки в буфер table::Writer (to_chars)
+//
+// Стадия - тип с each(sink): sink(std::span<const T>) по строкам по порядку
+
+namespace lazy {
+
+////////////////////////////////////////////////////////////////////////////////
+// ИСТОЧНИКИ
+////////////////////////////////////////////////////////////////////////////////
+
+// Строки готовой матрицы (без копирования)
+template<typename T>
+struct Rows {
+    using value_type = std::remove_const_t<T>;
+    dense::MatrixView<T> matrix;
+
+    std::size_t cols() const { return matrix.cols; }
+
+    template<typename Sink>
+    void each(Sink&& sink) const {
+        for (std::size_t i = 0; i < matrix.rows; ++i) sink(std::span<const value_type>(matrix.row(i), matrix.cols));
+    }
+};
+
+template<typename T>
+Rows<T> rows_of(dense::MatrixView<T> matrix) { return {matrix}; }
+
+// rows x cols ячеек cell(i, j) -> T
+template<typename T, typename Cell>
+struct Generate {
+    using value_type = T;
+    std::size_t rows;
+    std::size_t cols_;
+    Cell cell;
+
+    std::size_t cols() const { return cols_; }
+
+    template<typename Sink>
+    void each(Sink&& sink) const {
+        std::vector<T> row(cols_);
+        for (std::size_t i = 0; i < rows; ++i) {
+            for (std::size_t j = 0; j < cols_; ++j) row[j] = cell(i, j);
+            sink(std::span<const T>(row));
+        }
+    }
+};
+
+template<typename T, typename Cell>
+Generate<T, Cell> generate(std::size_t rows, std::size_t cols, Cell cell) { return {rows, cols, std::move(cell)}; }
+
+// Матрица lab6 (вариант 4) по углу A B / C D: (A + 2) x (B + 2), правый
+// нижний угол 2x2 - A B / C D, остальное C * i + D * j. Совпадает с
+// заполнением в lab6.cpp при A, B >= 1 (при 0 там угол не переносится)
+template<typename T>
+auto variant4(T a, T b, T c, T d) {
+    const std::size_t n = a + 2, m = b + 2;
+    return generate<T>(n, m, [=](std::size_t i, std::size_t j) {
+        if (i >= n - 2 && j >= m - 2) return i == n - 2 ? (j == m - 2 ? a : b) : (j == m - 2 ? c : d);
+        return c * static_cast<T>(i) + d * static_cast<T>(j);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ФИЛЬТРЫ СТРОК
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename Source, typename Keep>
+struct Filter {
+    using value_type = typename Source::value_type;
+    Source source;
+    Keep keep;
+
+    std::size_t cols() const { return source.cols(); }
+
+    template<typename Sink>
+    void each(Sink&& sink) const {
+        source.each([&](std::span<const value_type> row) {
+            if (keep(row)) sink(row);
+        });
+    }
+};
+
+// Аргумент справа от |: keep(строка) -> оставить ли строку
+template<typename Keep>
+struct FilterArg { Keep keep; };
+
+template<typename Keep>
+FilterArg<Keep> filter(Keep keep) { return {std::move(keep)}; }
+
+template<typename Source, typename Keep>
+Filter<Source, Keep> operator|(Source source, FilterArg<Keep> arg) { return {std::move(source), std::move(arg.keep)}; }
+
+// Строки без нулей (проверка строки - rows::has_zero)
+inline auto without_zero_rows(bool simd = rows::avx2_supported()) {
+    return filter([simd](auto row) { return !rows::has_zero(row.data(), row.size(), simd); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ВЫВОД
+////////////////////////////////////////////////////////////////////////////////
+
+// Как прежний print_matrix: элементы через "\t" (и после последнего),
+// строки - "\n", в конце "-----\n" и flush
+template<typename Expr>
+void print(const Expr& expr, table::Writer& out = table::standard_output()) {
+    expr.each([&](auto row) { out.row(row); });
+    out.text("-----\n");
+    out.flush();
+}
+
+}
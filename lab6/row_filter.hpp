@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <immintrin.h>
+#include "matrix.hpp"
+#include "../common/parallel.hpp"
+
+// Исключение строк матрицы lab6 без сдвига строк на каждое удаление:
+// - RowMask - битовая маска строк в исходной нумерации: удаление строки -
+//   сброс бита (O(1)), номера остальных строк не меняются
+// - compact переносит оставшиеся строки за один проход (подряд идущие
+//   оставшиеся строки - одним memmove)
+// - rows_with_zero - маска строк, где есть 0: строка сканируется AVX2 по
+//   32 элемента с выходом на первом нуле, строки делятся между потоками
+//   по 64 (слово маски пишет один поток)
+
+namespace rows {
+
+////////////////////////////////////////////////////////////////////////////////
+// МАСКА СТРОК
+////////////////////////////////////////////////////////////////////////////////
+
+class RowMask {
+public:
+    RowMask() = default;
+    RowMask(std::size_t rows, bool value) : rows_(rows), words_((rows + 63) / 64, value ? ~std::uint64_t(0) : 0) {
+        // Биты за последней строкой всегда нули
+        if (value && rows % 64) words_.back() = (std::uint64_t(1) << (rows % 64)) - 1;
+    }
+
+    std::size_t rows() const { return rows_; }
+    bool test(std::size_t row) const { return words_[row / 64] >> (row % 64) & 1; }
+    void set(std::size_t row) { words_[row / 64] |= std::uint64_t(1) << (row % 64); }
+    void reset(std::size_t row) { words_[row / 64] &= ~(std::uint64_t(1) << (row % 64)); }
+
+    std::size_t count() const {
+        std::size_t total = 0;
+        for (std::uint64_t word : words_) total += std::popcount(word);
+        return total;
+    }
+
+    // Сбросить все строки, отмеченные в other
+    RowMask& operator-=(const RowMask& other) {
+        for (std::size_t w = 0; w < words_.size(); ++w) words_[w] &= ~other.words_[w];
+        return *this;
+    }
+
+    std::uint64_t* words() { return words_.data(); }
+    const std::uint64_t* words() const { return words_.data(); }
+    std::size_t word_count() const { return words_.size(); }
+
+    // f(строка) для отмеченных строк по возрастанию
+    template<typename F>
+    void for_each(F&& f) const {
+        for (std::size_t w = 0; w < words_.size(); ++w) {
+            for (std::uint64_t word = words_[w]; word; word &= word - 1) f(w * 64 + std::countr_zero(word));
+        }
+    }
+
+private:
+    std::size_t rows_ = 0;
+    std::vector<std::uint64_t> words_;
+};
+
+// Оставляет строки, отмеченные в keep (keep.rows() == matrix.rows()),
+// в прежнем порядке
+template<typename T>
+void compact(dense::Matrix<T>& matrix, const RowMask& keep) {
+    const std::size_t stride = matrix.stride();
+    T* data = matrix.data();
+    std::size_t target = 0;
+    std::size_t row = 0;
+    while (row < matrix.rows()) {
+        // Следующий отрезок оставляемых строк [first, row)
+        while (row < matrix.rows() && !keep.test(row)) ++row;
+        const std::size_t first = row;
+        while (row < matrix.rows() && keep.test(row)) ++row;
+        if (first != target && row > first) {
+            std::memmove(data + target * stride, data + first * stride, (row - first) * stride * sizeof(T));
+        }
+        target += row - first;
+    }
+    matrix.resize(target, matrix.cols());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ПОИСК НУЛЕЙ
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+bool has_zero_scalar(const T* row, std::size_t size) {
+    for (std::size_t j = 0; j < size; ++j) {
+        if (row[j] == 0) return true;
+    }
+    return false;
+}
+
+// 32 элемента за шаг, хвост - маскированными загрузками по 8
+__attribute__((target("avx2")))
+inline bool has_zero_avx2(const int* row, std::size_t size) {
+    const __m256i zero = _mm256_setzero_si256();
+    std::size_t j = 0;
+    for (; j + 32 <= size; j += 32) {
+        const __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j)), zero);
+        const __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j + 8)), zero);
+        const __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j + 16)), zero);
+        const __m256i d = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j + 24)), zero);
+        const __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        if (!_mm256_testz_si256(any, any)) return true;
+    }
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (; j < size; j += 8) {
+        const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(std::min<std::size_t>(size - j, 8))), lanes);
+        // Маскированные дорожки читаются как 0 - отсекаются той же маской
+        const __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_maskload_epi32(row + j, mask), zero), mask);
+        if (!_mm256_testz_si256(hit, hit)) return true;
+    }
+    return false;
+}
+
+inline bool avx2_supported() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+template<typename T>
+bool has_zero(const T* row, std::size_t size, bool simd) {
+    if constexpr (std::is_same_v<std::remove_const_t<T>, int>) {
+        if (simd) return has_zero_avx2(row, size);
+    }
+    return has_zero_scalar(row, size);
+}
+
+// Меньше этого числа элементов - один поток
+constexpr std::size_t parallel_threshold = std::size_t(1) << 18;
+
+// Строки, в которых есть 0
+template<typename T>
+RowMask rows_with_zero(dense::MatrixView<T> matrix, unsigned threads = workers::hardware_threads(),
+                       bool simd = avx2_supported()) {
+    RowMask zero(matrix.rows, false);
+    const std::size_t words = zero.word_count();
+    threads = matrix.rows * matrix.cols < parallel_threshold ? 1 : std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(words, 1));
+
+    auto scan = [&](unsigned t) {
+        std::uint64_t* out = zero.words();
+        for (std::size_t w = words * t / threads; w < words * (t + 1) / threads; ++w) {
+            std::uint64_t word = 0;
+            const std::size_t last = std::min(matrix.rows, (w + 1) * 64);
+            for (std::size_t i = w * 64; i < last; ++i) {
+                word |= std::uint64_t(has_zero(matrix.row(i), matrix.cols, simd)) << (i % 64);
+            }
+            out[w] = word;
+        }
+    };
+    workers::parallel_for(threads, scan);
+    return zero;
+}
+
+}
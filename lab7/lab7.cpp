@@ -1,4 +1,6 @@
 #include <iostream>
+#include <span>
+#include "../common/table_output.hpp"
 
 // лаба 7 вариант 4
 #define USE_VECTOR false// переключить вектор-массив
@@ -23,7 +25,7 @@ int main(){
 
     option options[] = {
         {"Exit", [](){exit(0);}},
-        {"Show array", [](){for(const data_t& el: arr) std::cout<<el<<"\t"; std::cout<<std::endl;}},
+        {"Show array", [](){table::standard_output().row(std::span<const data_t>(arr)).flush();}},
         {"Add element to begin", [](){data_t el; std::cin>>el; arr.insert(arr.begin(), 1);}},
         {"Add element to end", [](){data_t el; std::cin>>el; arr.push_back(el);}},
         {"Clear array", [](){arr.clear();}},
@@ -82,7 +84,8 @@ void sort_arr(std::array<int, 10>* arr){
 }
 
 void print_arr(const std::array<int, 10>& arr){
-    for(auto el: arr) std::cout<<el<<"\t"; std::cout<<std::endl;
+    // Элементы через "\t" одной записью в буфер, flush - как прежний std::endl
+    table::standard_output().row(std::span<const int>(arr)).flush();
 }
 
 int main(){
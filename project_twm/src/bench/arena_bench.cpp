@@ -0,0 +1,106 @@
+// Бенчмарк арены итерации: выделения на событие и пропускная способность
+//
+// Событие несет строку (длиннее SSO) и вектор; обработчик строит временную
+// строку. Сравниваются payload на std::string/std::vector (глобальная куча)
+// и на std::pmr с FrameArena, которая сбрасывается после пачки событий
+// (как CompositorRunner после итерации цикла).
+//
+// Запуск: ./build/bench/arena_bench [кол-во событий] [событий за итерацию]
+
+#include <core/arena.hpp>
+#include <core/event.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+std::size_t heap_allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+    ++heap_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+struct HeapPayload {
+    std::string title;
+    std::vector<int> rects;
+};
+
+struct ArenaPayload {
+    std::pmr::string title;
+    std::pmr::vector<int> rects;
+};
+
+using HeapEvent = event<HeapPayload>;
+using ArenaEvent = event<ArenaPayload>;
+
+std::size_t checksum = 0;
+
+void on_heap(const HeapEvent& e) {
+    std::string label = "window: " + e.payload.title;
+    checksum += label.size() + e.payload.rects.size();
+}
+
+void on_arena(const ArenaEvent& e) {
+    std::pmr::string label("window: ", frame_resource());
+    label += e.payload.title;
+    checksum += label.size() + e.payload.rects.size();
+}
+
+constexpr auto heap_bus = EventBus<>{}.subscribe<HeapEvent, on_heap>();
+constexpr auto arena_bus = EventBus<>{}.subscribe<ArenaEvent, on_arena>();
+
+const char* title = "Mozilla Firefox - A rather long window title that does not fit SSO";
+
+struct Result {
+    double events_per_second;
+    double allocations_per_event;
+};
+
+template<typename F>
+Result measure(std::size_t events, F&& body) {
+    const std::size_t allocations_before = heap_allocations;
+    auto start = std::chrono::steady_clock::now();
+    body();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {events / seconds, static_cast<double>(heap_allocations - allocations_before) / events};
+}
+}
+
+int main(int argc, char** argv) {
+    const std::size_t events = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t per_iteration = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+
+    Result heap = measure(events, [&] {
+        for (std::size_t i = 0; i < events; ++i) {
+            HeapEvent e{.payload = {title, std::vector<int>(8, static_cast<int>(i))}};
+            heap_bus.publish(e);
+        }
+    });
+
+    FrameArena arena;
+    Result pmr = measure(events, [&] {
+        FrameArenaScope scope(arena);
+        for (std::size_t i = 0; i < events; ++i) {
+            if (i % per_iteration == 0) arena.reset();
+            ArenaEvent e{.payload = {std::pmr::string(title, frame_resource()),
+                                     std::pmr::vector<int>(8, static_cast<int>(i), frame_resource())}};
+            arena_bus.publish(e);
+        }
+    });
+
+    std::printf("global heap: %.0f events/s, %.2f allocations/event\n",
+                heap.events_per_second, heap.allocations_per_event);
+    std::printf("frame arena: %.0f events/s, %.4f allocations/event (%zu events/iteration, peak %zu bytes)\n",
+                pmr.events_per_second, pmr.allocations_per_event, per_iteration, arena.peak());
+    return checksum == 0;
+}
@@ -0,0 +1,124 @@
+// Бенчмарк времени компиляции: сгенерированный композитор с большим числом
+// модулей и привязок (по умолчанию 50 модулей, 5000 привязок, 500 событий)
+//
+// Генерирует исходник в build/, компилирует его тем же компилятором, что и
+// проект, и печатает JSON: время компиляции и пиковую память компилятора
+// (ru_maxrss дочернего процесса).
+//
+// Запуск: make compile-bench
+//         ./build/bench/compile_bench [--cxx g++] [--flags "-std=c++23 -O2 -Isrc"]
+//                                     [--modules 50] [--bindings 5000] [--events 500]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+struct Options {
+    std::string cxx = "g++";
+    std::string flags = "-std=c++23 -O2 -Isrc";
+    std::string output = "build/bench/compile_bench_generated.cpp";
+    int modules = 50;
+    int bindings = 5000;
+    int events = 500;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string_view name = argv[i];
+        if (name == "--cxx") options.cxx = argv[i + 1];
+        else if (name == "--flags") options.flags = argv[i + 1];
+        else if (name == "--output") options.output = argv[i + 1];
+        else if (name == "--modules") options.modules = std::atoi(argv[i + 1]);
+        else if (name == "--bindings") options.bindings = std::atoi(argv[i + 1]);
+        else if (name == "--events") options.events = std::atoi(argv[i + 1]);
+    }
+    return options;
+}
+
+// Модуль m подписывает bindings/modules обработчиков на события по кругу
+void generate(const Options& o) {
+    std::ofstream out(o.output);
+    out << "// Generated by compile_bench\n#include <core/compositor.hpp>\n\n";
+    for (int e = 0; e < o.events; ++e) {
+        out << "struct Payload" << e << " { int value; };\n"
+            << "using Event" << e << " = event<Payload" << e << ">;\n";
+    }
+
+    const int per_module = o.bindings / o.modules;
+    for (int m = 0; m < o.modules; ++m) {
+        out << "\nstruct Module" << m << " : ModuleBase<Module" << m << "> {\n"
+            << "    static inline int hits = 0;\n";
+        for (int b = 0; b < per_module; ++b) {
+            const int e = (m * per_module + b) % o.events;
+            out << "    static void on" << b << "(const Event" << e << "& e) { hits += e.payload.value; }\n";
+        }
+        out << "    template<auto... Bindings>\n"
+            << "    constexpr auto register_impl(EventBus<Bindings...> bus) const {\n"
+            << "        return bus";
+        for (int b = 0; b < per_module; ++b) {
+            const int e = (m * per_module + b) % o.events;
+            out << "\n            .template subscribe_event<Event" << e << ", on" << b << ">()";
+        }
+        out << ";\n    }\n";
+        if (m % 10 == 0) out << "    int event_fd() const { return -1; }\n    bool handle_event() { return true; }\n";
+        out << "};\n";
+    }
+
+    out << "\nint main() {\n    auto compositor = Compositor<";
+    for (int m = 0; m < o.modules; ++m) out << (m ? ", " : "") << "Module" << m;
+    out << ">{";
+    for (int m = 0; m < o.modules; ++m) out << (m ? ", " : "") << "Module" << m << "{}";
+    out << "};\n";
+    for (int e = 0; e < o.events; e += std::max(1, o.events / 20)) {
+        out << "    compositor.publish(Event" << e << "{.payload = {" << e << "}});\n";
+    }
+    out << "    compositor.initialize();\n"
+        << "    CompositorRunner runner(compositor);\n"
+        << "    runner.stop();\n"
+        << "    compositor.cleanup();\n"
+        << "    return Module0::hits == 0;\n}\n";
+}
+
+// Компиляция в /dev/null: время и пиковая память дочернего процесса
+bool compile(const Options& o, double& seconds, long& max_rss_kb) {
+    const std::string command = o.cxx + " " + o.flags + " -c " + o.output + " -o /dev/null";
+    const auto start = std::chrono::steady_clock::now();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    rusage usage{};
+    if (pid < 0 || wait4(pid, &status, 0, &usage) < 0) return false;
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // wait4 учитывает только sh; компилятор - его потомок
+    rusage children{};
+    getrusage(RUSAGE_CHILDREN, &children);
+    max_rss_kb = std::max(usage.ru_maxrss, children.ru_maxrss);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+}
+
+int main(int argc, char** argv) {
+    const Options options = parse_options(argc, argv);
+    generate(options);
+
+    double seconds = 0;
+    long max_rss_kb = 0;
+    const bool ok = compile(options, seconds, max_rss_kb);
+    std::printf("{\"modules\": %d, \"bindings\": %d, \"events\": %d, \"compiled\": %s, "
+                "\"seconds\": %.2f, \"max_rss_mb\": %.1f}\n",
+                options.modules, options.bindings, options.events, ok ? "true" : "false",
+                seconds, max_rss_kb / 1024.0);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+// Сквозной бенчмарк задержки ввода: нажатие клавиши -> обработка в twm
+//
+// 1) Запускает Xvfb на свободном дисплее (-displayfd)
+// 2) Запускает twm с TWM_PROBE_FD (см. modules/probe.hpp)
+// 3) Вводит нажатия через XTest с заданной частотой (0 - без пауз)
+// 4) Задержка - от отправки нажатия X серверу до записи пробника в канал
+//
+// Результат - JSON в stdout (для сравнения до/после изменений цикла и шины).
+// Нужны Xvfb и libXtst; сборка и запуск: make e2e-bench
+//
+// Запуск: ./build/bench/input_latency [--wm build/twm] [--count 2000] [--rates 100,1000,0]
+
+#include <modules/probe.hpp>
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XTest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+struct Options {
+    std::string wm = "build/twm";
+    std::size_t count = 2000;
+    std::vector<long> rates = {100, 1000, 0};
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string_view name = argv[i];
+        if (name == "--wm") options.wm = argv[i + 1];
+        else if (name == "--count") options.count = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (name == "--rates") {
+            options.rates.clear();
+            for (const char* p = argv[i + 1]; *p;) {
+                char* end;
+                options.rates.push_back(std::strtol(p, &end, 10));
+                p = *end == ',' ? end + 1 : end;
+            }
+        }
+    }
+    return options;
+}
+
+// Ожидание готовности дескриптора на чтение
+bool wait_readable(int fd, int timeout_ms) {
+    pollfd pfd{fd, POLLIN, 0};
+    return poll(&pfd, 1, timeout_ms) > 0;
+}
+
+// Xvfb печатает номер дисплея в -displayfd, когда готов принимать клиентов
+pid_t start_xvfb(std::string& display) {
+    int fds[2];
+    if (pipe(fds) < 0) return -1;
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        const std::string displayfd = std::to_string(fds[1]);
+        const int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDERR_FILENO);
+        execlp("Xvfb", "Xvfb", "-displayfd", displayfd.c_str(), "-screen", "0", "1280x800x24",
+               "-nolisten", "tcp", static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    close(fds[1]);
+
+    char buffer[32] = {};
+    if (pid < 0 || !wait_readable(fds[0], 10000) || read(fds[0], buffer, sizeof(buffer) - 1) <= 0) {
+        close(fds[0]);
+        return -1;
+    }
+    close(fds[0]);
+    display = ":" + std::to_string(std::atoi(buffer));
+    return pid;
+}
+
+pid_t start_wm(const std::string& wm, const std::string& display, int probe_fd) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+        setenv("DISPLAY", display.c_str(), 1);
+        setenv("TWM_PROBE_FD", std::to_string(probe_fd).c_str(), 1);
+        setenv("XDG_CONFIG_HOME", "/nonexistent", 1); // Встроенные привязки
+        const int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        execl(wm.c_str(), wm.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    return pid;
+}
+
+void stop_process(pid_t pid) {
+    if (pid <= 0) return;
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+}
+
+// Чтение записей пробника в отдельном потоке: время получения по номеру
+class ProbeReader {
+public:
+    ProbeReader(int fd, std::size_t capacity)
+        : fd_(fd), received_(capacity)
+    {
+        thread_ = std::thread([this] { loop(); });
+    }
+
+    ~ProbeReader() {
+        stopping_ = true;
+        thread_.join();
+    }
+
+    // Количество полученных записей
+    std::uint64_t count() const { return count_.load(std::memory_order_acquire); }
+
+    clock_type::time_point received(std::uint64_t sequence) const { return received_[sequence]; }
+
+    bool wait_for(std::uint64_t target, std::chrono::milliseconds timeout) const {
+        const auto deadline = clock_type::now() + timeout;
+        while (count() < target) {
+            if (clock_type::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return true;
+    }
+
+private:
+    void loop() {
+        ProbeRecord records[256];
+        std::size_t buffered = 0;
+        auto* bytes = reinterpret_cast<char*>(records);
+        while (!stopping_) {
+            if (!wait_readable(fd_, 50)) continue;
+            const ssize_t n = read(fd_, bytes + buffered, sizeof(records) - buffered);
+            if (n <= 0) return;
+            const auto now = clock_type::now();
+            buffered += static_cast<std::size_t>(n);
+            const std::size_t complete = buffered / sizeof(ProbeRecord);
+            for (std::size_t i = 0; i < complete; ++i) {
+                if (records[i].sequence < received_.size()) received_[records[i].sequence] = now;
+            }
+            count_.fetch_add(complete, std::memory_order_release);
+            buffered -= complete * sizeof(ProbeRecord);
+            std::memmove(bytes, bytes + complete * sizeof(ProbeRecord), buffered);
+        }
+    }
+
+    int fd_;
+    std::vector<clock_type::time_point> received_;
+    std::atomic<std::uint64_t> count_ = 0;
+    std::atomic<bool> stopping_ = false;
+    std::thread thread_;
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(p * sorted.size()))];
+}
+
+void press(Display* display, KeyCode keycode) {
+    XTestFakeKeyEvent(display, keycode, True, 0);
+    XTestFakeKeyEvent(display, keycode, False, 0);
+}
+}
+
+int main(int argc, char** argv) {
+    const Options options = parse_options(argc, argv);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::string display_name;
+    const pid_t xvfb = start_xvfb(display_name);
+    if (xvfb < 0) {
+        std::fprintf(stderr, "failed to start Xvfb\n");
+        return 1;
+    }
+
+    int probe[2];
+    if (pipe(probe) < 0) {
+        stop_process(xvfb);
+        return 1;
+    }
+    fcntl(probe[0], F_SETFD, FD_CLOEXEC);
+    const pid_t wm = start_wm(options.wm, display_name, probe[1]);
+    close(probe[1]);
+
+    Display* display = XOpenDisplay(display_name.c_str());
+    int event_base, error_base, major, minor;
+    if (!display || !XTestQueryExtension(display, &event_base, &error_base, &major, &minor)) {
+        std::fprintf(stderr, "XTest is not available on %s\n", display_name.c_str());
+        stop_process(wm);
+        stop_process(xvfb);
+        return 1;
+    }
+    const KeyCode keycode = XKeysymToKeycode(display, XK_a); // Без привязки: только путь доставки
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < options.rates.size(); ++i) total += options.count;
+    ProbeReader reader(probe[0], total + 1000);
+
+    // Прогрев: ждем, пока twm захватит клавиатуру и начнет отвечать
+    std::uint64_t sent = 0;
+    bool ready = false;
+    for (int attempt = 0; attempt < 100 && !ready; ++attempt) {
+        press(display, keycode);
+        XFlush(display);
+        ++sent;
+        ready = reader.wait_for(1, std::chrono::milliseconds(100));
+    }
+    if (!ready) {
+        std::fprintf(stderr, "twm did not report key presses (is %s built with the probe?)\n", options.wm.c_str());
+        XCloseDisplay(display);
+        stop_process(wm);
+        stop_process(xvfb);
+        return 1;
+    }
+    reader.wait_for(sent, std::chrono::milliseconds(1000));
+    sent = reader.count();
+
+    std::printf("{\n  \"display\": \"%s\",\n  \"wm\": \"%s\",\n  \"runs\": [", display_name.c_str(), options.wm.c_str());
+    std::vector<clock_type::time_point> send_times(total + 1000);
+    for (std::size_t r = 0; r < options.rates.size(); ++r) {
+        const long rate = options.rates[r];
+        const std::uint64_t first = sent;
+
+        // Отправка по расписанию с абсолютными сроками (без накопления дрейфа)
+        timespec next;
+        clock_gettime(CLOCK_MONOTONIC, &next);
+        const long period_ns = rate > 0 ? 1000000000L / rate : 0;
+        for (std::size_t i = 0; i < options.count; ++i) {
+            if (period_ns > 0) {
+                next.tv_nsec += period_ns;
+                while (next.tv_nsec >= 1000000000L) {
+                    next.tv_nsec -= 1000000000L;
+                    ++next.tv_sec;
+                }
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+            }
+            press(display, keycode);
+            send_times[sent] = clock_type::now();
+            XFlush(display);
+            ++sent;
+        }
+        const bool complete = reader.wait_for(sent, std::chrono::milliseconds(5000));
+        const std::uint64_t received = std::min<std::uint64_t>(reader.count(), sent) - first;
+
+        std::vector<double> latencies;
+        latencies.reserve(received);
+        for (std::uint64_t s = first; s < first + received; ++s) {
+            latencies.push_back(std::chrono::duration<double, std::micro>(reader.received(s) - send_times[s]).count());
+        }
+        std::sort(latencies.begin(), latencies.end());
+        const double seconds = received > 0
+            ? std::chrono::duration<double>(reader.received(first + received - 1) - send_times[first]).count()
+            : 0;
+
+        std::printf("%s\n    {\"target_rate\": %ld, \"sent\": %zu, \"received\": %llu, \"complete\": %s, "
+                    "\"throughput\": %.0f, \"p50_us\": %.1f, \"p99_us\": %.1f, \"p999_us\": %.1f}",
+                    r ? "," : "", rate, options.count, static_cast<unsigned long long>(received),
+                    complete ? "true" : "false", seconds > 0 ? received / seconds : 0.0,
+                    percentile(latencies, 0.50), percentile(latencies, 0.99), percentile(latencies, 0.999));
+        if (!complete) break; // Потерянные нажатия сбили бы нумерацию следующих прогонов
+    }
+    std::printf("\n  ]\n}\n");
+
+    XCloseDisplay(display);
+    stop_process(wm);
+    stop_process(xvfb);
+    return 0;
+}
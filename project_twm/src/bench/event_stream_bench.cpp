@@ -0,0 +1,271 @@
+// Бенчмарк трансляции событий IPC подписчикам (EventStreamModule)
+//
+// 100 подписчиков, из них несколько "медленных" (не читают сокет).
+// Композитор публикует события пачками и после каждой пачки вызывает
+// handle_event() модуля, как главный цикл после итерации. Быстрые
+// подписчики читаются в отдельном потоке через epoll.
+//
+// Сравниваются:
+// - naive: сериализация и write() каждому подписчику на каждое событие
+//   (неблокирующие сокеты; кадры, не поместившиеся в сокет, теряются)
+// - stream drop_oldest / disconnect: одна сериализация в общий буфер,
+//   очередь на клиента и один sendmsg() на клиента за итерацию
+//
+// Отчет: стоимость публикации для композитора (мкс на событие), системные
+// вызовы записи, задержка доставки быстрым подписчикам (p50/p99), пропуски
+// у быстрых подписчиков и счетчики политики медленных клиентов.
+//
+// Запуск: ./build/bench/event_stream_bench [событий] [подписчиков] [медленных] [пачка]
+
+#include <core/compositor.hpp>
+#include <modules/event_stream.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+struct TickPayload {
+    std::int64_t sent_ns;
+    std::uint64_t index;
+};
+
+using TickEvent = event<TickPayload>;
+using Stream = EventStreamModule<TickEvent>;
+using StreamClient = EventStreamClient<TickEvent>;
+
+struct Options {
+    std::size_t events = 200000;
+    std::size_t subscribers = 100;
+    std::size_t slow = 5;
+    std::size_t batch = 64;
+};
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+}
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<std::size_t>(p * values.size()))];
+}
+
+struct Result {
+    double publish_us_per_event = 0;
+    std::uint64_t write_calls = 0;
+    std::uint64_t fast_received = 0;
+    std::uint64_t fast_gaps = 0;      // Пропуски номеров у быстрых подписчиков
+    std::vector<double> latency_us;
+    ipc::StreamStats stats;
+};
+
+// Чтение быстрых подписчиков: номер следующего ожидаемого события на каждого
+class FastReaders {
+public:
+    explicit FastReaders(std::vector<StreamClient*> clients) : clients_(std::move(clients)), expected_(clients_.size(), 0) {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        for (std::size_t i = 0; i < clients_.size(); ++i) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = i;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, clients_[i]->fd(), &ev);
+        }
+        thread_ = std::thread([this] { loop(); });
+    }
+
+    ~FastReaders() {
+        close(epoll_fd_);
+    }
+
+    // Ожидание, пока все быстрые подписчики получат total событий
+    void finish(std::size_t total, Result& result) {
+        const auto deadline = clock_type::now() + std::chrono::seconds(10);
+        while (received_.load() < total * clients_.size() && clock_type::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        stop_ = true;
+        thread_.join();
+        result.fast_received = received_.load();
+        result.fast_gaps = gaps_;
+        result.latency_us = std::move(latency_us_);
+    }
+
+private:
+    void loop() {
+        epoll_event events[128];
+        while (!stop_) {
+            const int count = epoll_wait(epoll_fd_, events, 128, 10);
+            for (int i = 0; i < count; ++i) {
+                const std::size_t index = events[i].data.u64;
+                StreamClient& client = *clients_[index];
+                do {
+                    if (!client.receive([&](const TickEvent& tick) { on_tick(index, tick); })) break;
+                } while (client.buffered());
+            }
+        }
+    }
+
+    void on_tick(std::size_t index, const TickEvent& tick) {
+        if (tick.payload.index != expected_[index]) ++gaps_;
+        expected_[index] = tick.payload.index + 1;
+        if (tick.payload.index % 64 == 0) latency_us_.push_back((now_ns() - tick.payload.sent_ns) / 1e3);
+        received_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::vector<StreamClient*> clients_;
+    std::vector<std::uint64_t> expected_;
+    std::vector<double> latency_us_;
+    std::uint64_t gaps_ = 0;
+    std::atomic<std::uint64_t> received_ = 0;
+    std::atomic<bool> stop_ = false;
+    int epoll_fd_ = -1;
+    std::thread thread_;
+};
+
+Result run_stream(const Options& options, ipc::SlowConsumerPolicy policy) {
+    const std::string path = "/tmp/twm-stream-bench-" + std::to_string(getpid()) + ".sock";
+    auto compositor = Compositor<Stream>{Stream{path, ipc::StreamConfig{.policy = policy}}};
+    compositor.initialize();
+    Stream& stream = compositor.module<Stream>();
+
+    std::vector<std::unique_ptr<StreamClient>> clients;
+    for (std::size_t i = 0; i < options.subscribers; ++i) {
+        clients.push_back(std::make_unique<StreamClient>());
+        clients.back()->connect(path);
+    }
+    while (stream.client_count() < options.subscribers) stream.handle_event();
+
+    std::vector<StreamClient*> fast;
+    for (std::size_t i = options.slow; i < clients.size(); ++i) fast.push_back(clients[i].get());
+    FastReaders readers(fast);
+
+    Result result;
+    const auto start = clock_type::now();
+    for (std::size_t i = 0; i < options.events;) {
+        for (const std::size_t end = std::min(options.events, i + options.batch); i < end; ++i) {
+            compositor.publish(TickEvent{.payload = {now_ns(), i}});
+        }
+        stream.handle_event();
+    }
+    const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    // Досылка хвостов очередей быстрым подписчикам
+    const auto deadline = clock_type::now() + std::chrono::seconds(5);
+    while (stream.stats().frames_sent < options.events * fast.size() && clock_type::now() < deadline) {
+        stream.handle_event();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    readers.finish(options.events, result);
+
+    result.publish_us_per_event = seconds * 1e6 / options.events;
+    result.stats = stream.stats();
+    result.write_calls = result.stats.send_calls;
+    clients.clear();
+    compositor.cleanup();
+    return result;
+}
+
+// Базовый вариант: запись каждому подписчику на каждое событие
+Result run_naive(const Options& options) {
+    std::vector<int> server_fds;
+    std::vector<int> client_fds;
+    for (std::size_t i = 0; i < options.subscribers; ++i) {
+        int fds[2];
+        socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds);
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        server_fds.push_back(fds[0]);
+        client_fds.push_back(fds[1]);
+    }
+
+    // Быстрые подписчики вычитывают все данные
+    std::atomic<bool> stop = false;
+    std::uint64_t bytes_read = 0;
+    std::thread reader([&] {
+        const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        for (std::size_t i = options.slow; i < client_fds.size(); ++i) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = client_fds[i];
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fds[i], &ev);
+        }
+        char buffer[64 * 1024];
+        epoll_event events[128];
+        while (!stop) {
+            const int count = epoll_wait(epoll_fd, events, 128, 10);
+            for (int i = 0; i < count; ++i) {
+                ssize_t n;
+                do {
+                    n = read(events[i].data.fd, buffer, sizeof(buffer));
+                    if (n > 0) bytes_read += static_cast<std::uint64_t>(n);
+                } while (n == static_cast<ssize_t>(sizeof(buffer)));
+            }
+        }
+        close(epoll_fd);
+    });
+
+    Result result;
+    const auto start = clock_type::now();
+    for (std::size_t i = 0; i < options.events; ++i) {
+        const TickEvent tick{.payload = {now_ns(), i}};
+        for (int fd : server_fds) {
+            char frame[sizeof(ipc::Header) + sizeof(TickPayload)];
+            const ipc::Header header{.size = sizeof(TickPayload), .type = 0, .flags = ipc::flag_event,
+                                     .seq = static_cast<std::uint32_t>(i)};
+            std::memcpy(frame, &header, sizeof(header));
+            std::memcpy(frame + sizeof(header), &tick.payload, sizeof(tick.payload));
+            if (write(fd, frame, sizeof(frame)) < 0) ++result.stats.dropped;
+            ++result.write_calls;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    stop = true;
+    reader.join();
+    result.fast_received = bytes_read / (sizeof(ipc::Header) + sizeof(TickPayload));
+
+    result.publish_us_per_event = seconds * 1e6 / options.events;
+    for (int fd : server_fds) close(fd);
+    for (int fd : client_fds) close(fd);
+    return result;
+}
+
+void print(const char* name, Result result, bool last) {
+    std::printf("    {\"mode\": \"%s\", \"publish_us_per_event\": %.2f, \"write_calls\": %llu, "
+                "\"fast_received\": %llu, \"fast_gaps\": %llu, \"latency_us_p50\": %.1f, \"latency_us_p99\": %.1f, "
+                "\"dropped\": %llu, \"disconnected\": %llu}%s\n",
+                name, result.publish_us_per_event, static_cast<unsigned long long>(result.write_calls),
+                static_cast<unsigned long long>(result.fast_received), static_cast<unsigned long long>(result.fast_gaps),
+                percentile(result.latency_us, 0.5), percentile(result.latency_us, 0.99),
+                static_cast<unsigned long long>(result.stats.dropped),
+                static_cast<unsigned long long>(result.stats.disconnected), last ? "" : ",");
+}
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (argc > 1) options.events = std::strtoull(argv[1], nullptr, 10);
+    if (argc > 2) options.subscribers = std::strtoull(argv[2], nullptr, 10);
+    if (argc > 3) options.slow = std::min<std::size_t>(std::strtoull(argv[3], nullptr, 10), options.subscribers);
+    if (argc > 4) options.batch = std::max<std::size_t>(std::strtoull(argv[4], nullptr, 10), 1);
+
+    std::printf("{\n  \"events\": %zu, \"subscribers\": %zu, \"slow\": %zu, \"batch\": %zu,\n  \"runs\": [\n",
+                options.events, options.subscribers, options.slow, options.batch);
+    print("naive", run_naive(options), false);
+    print("stream_drop_oldest", run_stream(options, ipc::SlowConsumerPolicy::drop_oldest), false);
+    print("stream_disconnect", run_stream(options, ipc::SlowConsumerPolicy::disconnect), true);
+    std::printf("  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Бенчмарк IPC канала: запросы в секунду и задержка round-trip
+//
+// Сервер (Compositor + CompositorRunner с IpcModule) работает в отдельном потоке,
+// клиент подключается к нему через Unix socket.
+//
+// Запуск: ./build/bench/ipc_bench [кол-во запросов] [размер пачки]
+
+#include <core/compositor.hpp>
+#include <modules/ipc.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+struct NumPayload {
+    int num;
+};
+
+struct GetNumPayload {};
+
+using SetNumCommand = command<NumPayload>;
+using GetNumRequest = request<GetNumPayload, int>;
+
+struct CounterModule : ModuleBase<CounterModule> {
+    static void handle_set(const SetNumCommand& cmd) { value = cmd.payload.num; }
+    static int handle_get(const GetNumRequest&) { return value; }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus
+            .template bind_command<SetNumCommand, handle_set>()
+            .template bind_request<GetNumRequest, handle_get>();
+    }
+
+    static inline int value = 0;
+};
+
+using Ipc = IpcModule<SetNumCommand, GetNumRequest>;
+using Client = IpcClient<SetNumCommand, GetNumRequest>;
+using clock_type = std::chrono::steady_clock;
+
+double percentile(std::vector<double>& sorted, double p) {
+    return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(p * sorted.size()))];
+}
+}
+
+int main(int argc, char** argv) {
+    const std::size_t total = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const std::size_t batch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+    const std::string path = "/tmp/twm-ipc-bench-" + std::to_string(getpid()) + ".sock";
+
+    auto compositor = Compositor<CounterModule, Ipc>{CounterModule{}, Ipc{path}};
+    compositor.module<Ipc>().set_dispatcher([&compositor](const auto& msg) {
+        return compositor.dispatch(msg);
+    });
+    compositor.initialize();
+
+    std::atomic<bool> stop = false;
+    std::thread server([&] {
+        CompositorRunner runner(compositor);
+        runner.run([&] { return stop.load(std::memory_order_relaxed); });
+    });
+
+    Client client;
+    if (!client.connect(path)) {
+        std::fprintf(stderr, "connect failed: %s\n", path.c_str());
+        stop = true;
+        server.join();
+        return 1;
+    }
+
+    const GetNumRequest request{};
+
+    // 1) Задержка одиночного запроса
+    std::vector<double> latencies;
+    latencies.reserve(total / 4);
+    for (std::size_t i = 0; i < total / 4; ++i) {
+        auto start = clock_type::now();
+        client.call(request);
+        latencies.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    // 2) Пропускная способность при конвейерной отправке пачками
+    auto start = clock_type::now();
+    std::size_t done = 0;
+    while (done < total) {
+        const std::size_t n = std::min(batch, total - done);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 2) client.send(request);
+            else client.send(make_command<NumPayload>({static_cast<int>(i)}));
+        }
+        client.flush();
+        ipc::Header header;
+        const char* body;
+        for (std::size_t i = 0; i < n; ++i) client.receive(header, body);
+        done += n;
+    }
+    const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+
+    std::printf("round-trip latency (us): p50=%.2f p99=%.2f p999=%.2f (%zu samples)\n",
+                percentile(latencies, 0.50), percentile(latencies, 0.99),
+                percentile(latencies, 0.999), latencies.size());
+    std::printf("pipelined throughput: %.0f req/s (batch %zu, %zu requests)\n",
+                total / seconds, batch, total);
+
+    client.disconnect();
+    stop = true;
+    server.join();
+    compositor.cleanup();
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Бенчмарк обработки мыши: воспроизведение трассы 1 кГц
+//
+// Трасса: наведение без перетаскивания и несколько перетаскиваний окна
+// (движение по окружности, событие каждую миллисекунду). Главный цикл
+// моделируется пачками: итерация забирает события, пришедшие за period мс.
+// Сравниваются наивная обработка (событие и запрос X на каждое движение)
+// и PointerModule (сжатие движений за итерацию, кадр геометрии не чаще 60 Гц).
+// X сервер не нужен: считаются запросы, которые выдал бы модуль.
+//
+// Запуск: ./build/bench/pointer_bench [кол-во перетаскиваний] [длительность, мс]
+
+#include <modules/pointer.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+using pointer_utils::clock;
+
+enum class TraceKind { motion, press, release };
+
+struct TraceEvent {
+    TraceKind kind;
+    long time_ms;
+    int x, y;
+};
+
+std::vector<TraceEvent> make_trace(int drags, int drag_ms) {
+    std::vector<TraceEvent> trace;
+    long t = 0;
+    auto circle = [&](int duration_ms, int cx, int cy, int radius) {
+        for (int i = 0; i < duration_ms; ++i, ++t) {
+            const double angle = i * 0.01;
+            trace.push_back({TraceKind::motion, t,
+                             cx + static_cast<int>(radius * std::cos(angle)),
+                             cy + static_cast<int>(radius * std::sin(angle))});
+        }
+    };
+
+    circle(500, 400, 300, 100); // Наведение
+    for (int d = 0; d < drags; ++d) {
+        trace.push_back({TraceKind::press, t, 500, 300});
+        circle(drag_ms, 400, 300, 100);
+        trace.push_back({TraceKind::release, t++, 500, 300});
+        circle(200, 400, 300, 100);
+    }
+    return trace;
+}
+
+struct Result {
+    std::size_t published = 0;  // Событий мыши в шину
+    std::size_t requests = 0;   // Запросов X (геометрия + начальная геометрия окна)
+    std::size_t iterations = 0; // Итераций главного цикла
+};
+
+// Событие и запрос X на каждое движение
+Result replay_naive(const std::vector<TraceEvent>& trace) {
+    Result result;
+    bool dragging = false;
+    for (const TraceEvent& e : trace) {
+        ++result.published;
+        ++result.iterations;
+        if (e.kind == TraceKind::press) {
+            dragging = true;
+            ++result.requests;
+        } else if (e.kind == TraceKind::release) {
+            dragging = false;
+        } else if (dragging) {
+            ++result.requests;
+        }
+    }
+    return result;
+}
+
+// Та же логика, что в PointerModule::handle_event
+Result replay_compressed(const std::vector<TraceEvent>& trace, long period_ms, clock::duration frame_interval) {
+    Result result;
+    pointer_utils::MotionCompressor motion;
+    pointer_utils::DragController drag(frame_interval);
+    const clock::time_point origin{};
+    auto at = [&](long ms) { return origin + std::chrono::milliseconds(ms); };
+
+    auto flush = [&] {
+        if (motion.take()) ++result.published;
+    };
+    auto frame = [&](clock::time_point now) {
+        if (drag.frame(now)) ++result.requests;
+    };
+
+    std::size_t i = 0;
+    while (i < trace.size()) {
+        // Итерация забирает все события до конца своего периода
+        const long batch_end = (trace[i].time_ms / period_ms + 1) * period_ms;
+        const clock::time_point now = at(batch_end);
+        ++result.iterations;
+        for (; i < trace.size() && trace[i].time_ms < batch_end; ++i) {
+            const TraceEvent& e = trace[i];
+            switch (e.kind) {
+                case TraceKind::motion:
+                    motion.add(e.x, e.y, 0, static_cast<Time>(e.time_ms));
+                    drag.motion(e.x, e.y);
+                    break;
+                case TraceKind::press:
+                    flush();
+                    ++result.published;
+                    ++result.requests; // XGetWindowAttributes
+                    drag.begin(pointer_utils::DragMode::move, e.x, e.y, {1, 100, 100, 640, 480}, now);
+                    break;
+                case TraceKind::release:
+                    flush();
+                    if (drag.end()) ++result.requests;
+                    ++result.published;
+                    break;
+            }
+        }
+        flush();
+        frame(now);
+
+        // Таймер кадра срабатывает раньше следующей пачки событий
+        if (drag.pending() && i < trace.size() && drag.next_frame() < at(trace[i].time_ms)) {
+            ++result.iterations;
+            frame(drag.next_frame());
+        }
+    }
+    return result;
+}
+}
+
+int main(int argc, char** argv) {
+    const int drags = argc > 1 ? std::atoi(argv[1]) : 5;
+    const int drag_ms = argc > 2 ? std::atoi(argv[2]) : 2000;
+    const auto trace = make_trace(drags, drag_ms);
+    const PointerConfig config;
+
+    const Result naive = replay_naive(trace);
+    std::printf("trace: %zu events at 1 kHz, %d drags x %d ms\n", trace.size(), drags, drag_ms);
+    std::printf("%-22s %10s %12s %12s\n", "mode", "published", "X requests", "iterations");
+    std::printf("%-22s %10zu %12zu %12zu\n", "naive", naive.published, naive.requests, naive.iterations);
+
+    for (long period : {1L, 4L, 16L}) {
+        const auto start = std::chrono::steady_clock::now();
+        const Result compressed = replay_compressed(trace, period, config.frame_interval);
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        char mode[32];
+        std::snprintf(mode, sizeof(mode), "compressed (%ld ms)", period);
+        std::printf("%-22s %10zu %12zu %12zu   x%.1f fewer requests, %.1f ns/event\n",
+                    mode, compressed.published, compressed.requests, compressed.iterations,
+                    static_cast<double>(naive.requests) / compressed.requests, ns / trace.size());
+    }
+    return 0;
+}
@@ -0,0 +1,324 @@
+// Бенчмарк перезапуска на месте с передачей состояния (core/restart.hpp)
+//
+// Процесс держит таблицу управляемых окон (геометрия, рабочий стол,
+// заголовок), дерево раскладки и таблицу шорткатов, сериализует их,
+// выполняет exec самого себя и восстанавливает состояние из memfd.
+// Время перезапуска - от начала сериализации до конца restore_state()
+// в новом процессе (CLOCK_MONOTONIC не сбрасывается при exec).
+// Перезапуск повторяется --rounds раз; замеры передаются дальше в том же образе.
+//
+// Для сравнения при доступном X сервере (DISPLAY) измеряется восстановление
+// опросом сервера: XQueryTree + XGetWindowAttributes + XFetchName для тех же окон.
+//
+// Запуск: ./build/bench/restart_bench [--windows 1000] [--rounds 20]
+
+#include <core/compositor.hpp>
+#include <core/restart.hpp>
+#include <modules/shortcuts.hpp>
+#include <X11/Xlib.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ctime>
+
+namespace {
+struct Options {
+    std::size_t windows = 1000;
+    std::size_t rounds = 20;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string_view name = argv[i];
+        if (name == "--windows") options.windows = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (name == "--rounds") options.rounds = std::strtoull(argv[i + 1], nullptr, 10);
+    }
+    return options;
+}
+
+std::uint64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+struct ManagedWindow {
+    std::uint64_t window;
+    std::int32_t x, y;
+    std::uint32_t width, height;
+    std::uint32_t workspace;
+    std::uint32_t flags;
+    std::uint32_t title_offset;  // Заголовок в WindowTableModule::titles
+    std::uint32_t title_size;
+
+    bool operator==(const ManagedWindow&) const = default;
+};
+
+// Узел дерева раскладки: разбиение или лист с окном
+struct LayoutNode {
+    std::uint32_t first_child;   // Индекс в массиве узлов (0 - нет)
+    std::uint32_t next_sibling;
+    std::uint64_t window;        // Для листа
+    float ratio;
+    std::uint32_t split;         // 0 - лист, 1 - по горизонтали, 2 - по вертикали
+
+    bool operator==(const LayoutNode&) const = default;
+};
+
+constexpr std::uint32_t workspace_count = 10;
+
+// Окна, рассаженные по рабочим столам; у каждого стола корень-разбиение
+class WindowTableModule : public ModuleBase<WindowTableModule> {
+public:
+    static constexpr std::string_view state_tag = "windows";
+    static constexpr std::uint32_t state_version = 1;
+
+    WindowTableModule() : state_(std::make_shared<State>()) {}
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+
+    void generate(std::size_t count) {
+        State& s = *state_;
+        s.windows.clear();
+        s.titles.clear();
+        s.layout.assign(1 + workspace_count, LayoutNode{});
+        std::vector<std::uint32_t> last_child(workspace_count, 0);
+        for (std::uint32_t w = 0; w < workspace_count; ++w) {
+            s.layout[1 + w] = {.first_child = 0, .next_sibling = w + 1 < workspace_count ? w + 2 : 0,
+                               .window = 0, .ratio = 0.5f, .split = 1 + w % 2};
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::string title = "xterm - ~/src/project-" + std::to_string(i) + " (" + std::to_string(i * 7919 % 1000) + ")";
+            const auto workspace = static_cast<std::uint32_t>(i % workspace_count);
+            const std::uint64_t window = 0x1a00001 + i * 0x10;
+            s.windows.push_back({
+                .window = window,
+                .x = static_cast<std::int32_t>(i % 32 * 20), .y = static_cast<std::int32_t>(i % 24 * 20),
+                .width = 640 + static_cast<std::uint32_t>(i % 7) * 10, .height = 480,
+                .workspace = workspace, .flags = static_cast<std::uint32_t>(i % 3),
+                .title_offset = static_cast<std::uint32_t>(s.titles.size()),
+                .title_size = static_cast<std::uint32_t>(title.size())
+            });
+            s.titles += title;
+
+            const auto node = static_cast<std::uint32_t>(s.layout.size());
+            s.layout.push_back({.first_child = 0, .next_sibling = 0, .window = window, .ratio = 1.0f, .split = 0});
+            if (last_child[workspace]) s.layout[last_child[workspace]].next_sibling = node;
+            else s.layout[1 + workspace].first_child = node;
+            last_child[workspace] = node;
+        }
+    }
+
+    void serialize(RestartWriter& out) const {
+        out.write_array(std::span(state_->windows));
+        out.write_string(state_->titles);
+        out.write_array(std::span(state_->layout));
+    }
+
+    bool restore(RestartReader& in) {
+        State& s = *state_;
+        const auto windows = in.read_array<ManagedWindow>();
+        s.windows.assign(windows.begin(), windows.end());
+        s.titles = in.read_string();
+        const auto layout = in.read_array<LayoutNode>();
+        s.layout.assign(layout.begin(), layout.end());
+        return in.ok();
+    }
+
+    bool same_state(const WindowTableModule& other) const {
+        return state_->windows == other.state_->windows && state_->titles == other.state_->titles
+            && state_->layout == other.state_->layout;
+    }
+
+private:
+    struct State {
+        std::vector<ManagedWindow> windows;
+        std::string titles;
+        std::vector<LayoutNode> layout;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+// Таблица шорткатов в формате ShortcutsModule (без глобальной таблицы)
+class ShortcutTableModule : public ModuleBase<ShortcutTableModule> {
+public:
+    static constexpr std::string_view state_tag = "shortcuts";
+    static constexpr std::uint32_t state_version = 1;
+
+    ShortcutTableModule() : table_(std::make_shared<ShortcutTable>()) {}
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+
+    void generate() {
+        for (KeySym key = XK_a; key <= XK_z; ++key) {
+            for (unsigned int modifiers : {Mod4Mask, Mod4Mask | ShiftMask, Mod1Mask, ControlMask}) {
+                table_->add(key, modifiers, ShortcutAction::spawn, "xterm -e tmux new-session -A -s main");
+            }
+        }
+        table_->finalize();
+    }
+
+    void serialize(RestartWriter& out) const { table_->serialize(out); }
+    bool restore(RestartReader& in) { return table_->restore(in); }
+    std::size_t size() const { return table_->shortcuts.size(); }
+
+private:
+    std::shared_ptr<ShortcutTable> table_;
+};
+
+// Замеры предыдущих перезапусков (передаются через образ)
+struct BenchStats {
+    std::uint64_t started_ns = 0;     // Начало текущего перезапуска
+    std::uint64_t image_bytes = 0;
+    double x_rebuild_ms = -1;         // Восстановление опросом X (-1 - нет сервера)
+};
+
+class BenchStatsModule : public ModuleBase<BenchStatsModule> {
+public:
+    static constexpr std::string_view state_tag = "bench";
+    static constexpr std::uint32_t state_version = 1;
+
+    BenchStatsModule() : state_(std::make_shared<State>()) {}
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+
+    void serialize(RestartWriter& out) const {
+        out.write(state_->stats);
+        out.write_array(std::span(state_->restart_us));
+        out.write_array(std::span(state_->serialize_us));
+    }
+
+    bool restore(RestartReader& in) {
+        State& s = *state_;
+        in.read(s.stats);
+        const auto restart_us = in.read_array<double>();
+        s.restart_us.assign(restart_us.begin(), restart_us.end());
+        const auto serialize_us = in.read_array<double>();
+        s.serialize_us.assign(serialize_us.begin(), serialize_us.end());
+        return in.ok();
+    }
+
+    BenchStats& stats() { return state_->stats; }
+    std::vector<double>& restart_us() { return state_->restart_us; }
+    std::vector<double>& serialize_us() { return state_->serialize_us; }
+
+private:
+    struct State {
+        BenchStats stats;
+        std::vector<double> restart_us;
+        std::vector<double> serialize_us;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+// Восстановление опросом сервера, как при обычном запуске оконного менеджера
+double measure_x_rebuild(std::size_t count) {
+    Display* display = XOpenDisplay(nullptr);
+    if (!display) return -1;
+    const Window root = DefaultRootWindow(display);
+    std::vector<Window> created;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Window window = XCreateSimpleWindow(display, root, static_cast<int>(i % 32 * 20),
+                                                  static_cast<int>(i % 24 * 20), 640, 480, 0, 0, 0);
+        XStoreName(display, window, ("xterm - ~/src/project-" + std::to_string(i)).c_str());
+        created.push_back(window);
+    }
+    XSync(display, False);
+
+    const std::uint64_t start = now_ns();
+    Window root_return, parent_return;
+    Window* children = nullptr;
+    unsigned int child_count = 0;
+    std::size_t adopted = 0;
+    if (XQueryTree(display, root, &root_return, &parent_return, &children, &child_count)) {
+        for (unsigned int i = 0; i < child_count; ++i) {
+            XWindowAttributes attributes;
+            char* name = nullptr;
+            if (!XGetWindowAttributes(display, children[i], &attributes)) continue;
+            if (XFetchName(display, children[i], &name) && name) XFree(name);
+            ++adopted;
+        }
+        XFree(children);
+    }
+    const double ms = (now_ns() - start) / 1e6;
+
+    for (Window window : created) XDestroyWindow(display, window);
+    XCloseDisplay(display);
+    return adopted >= count ? ms : -1;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<std::size_t>(p * values.size()))];
+}
+}
+
+int main(int argc, char** argv) {
+    const Options options = parse_options(argc, argv);
+    auto compositor = Compositor<WindowTableModule, ShortcutTableModule, BenchStatsModule>{
+        WindowTableModule{}, ShortcutTableModule{}, BenchStatsModule{}};
+    auto& stats = compositor.module<BenchStatsModule>();
+
+    if (auto image = RestartImage::from_environment()) {
+        const std::size_t restored = compositor.restore_state(*image);
+        const std::uint64_t finished = now_ns();
+        WindowTableModule expected;
+        expected.generate(options.windows);
+        if (restored != 3 || !compositor.module<WindowTableModule>().same_state(expected)) {
+            std::fprintf(stderr, "restored state does not match (%zu modules restored)\n", restored);
+            return 1;
+        }
+        stats.restart_us().push_back((finished - stats.stats().started_ns) / 1e3);
+    } else {
+        compositor.module<WindowTableModule>().generate(options.windows);
+        compositor.module<ShortcutTableModule>().generate();
+        stats.stats().x_rebuild_ms = measure_x_rebuild(options.windows);
+    }
+
+    if (stats.restart_us().size() < options.rounds) {
+        // Отдельный замер сериализации (сам образ должен содержать его результат)
+        const std::uint64_t serialize_start = now_ns();
+        RestartWriter probe;
+        compositor.serialize_state(probe);
+        stats.serialize_us().push_back((now_ns() - serialize_start) / 1e3);
+        stats.stats().image_bytes = probe.size();
+
+        stats.stats().started_ns = now_ns();
+        RestartWriter image;
+        compositor.serialize_state(image);
+        restart_image::exec(image, argv);
+        std::perror("exec");
+        return 1;
+    }
+
+    const BenchStats& s = stats.stats();
+    std::printf("{\"windows\": %zu, \"shortcuts\": %zu, \"rounds\": %zu, \"image_bytes\": %llu, "
+                "\"serialize_us_p50\": %.1f, \"restart_us_p50\": %.1f, \"restart_us_min\": %.1f, "
+                "\"restart_us_max\": %.1f, ",
+                options.windows, compositor.module<ShortcutTableModule>().size(), stats.restart_us().size(),
+                static_cast<unsigned long long>(s.image_bytes),
+                percentile(stats.serialize_us(), 0.5), percentile(stats.restart_us(), 0.5),
+                percentile(stats.restart_us(), 0.0), percentile(stats.restart_us(), 1.0));
+    if (s.x_rebuild_ms >= 0) std::printf("\"x_rebuild_ms\": %.2f}\n", s.x_rebuild_ms);
+    else std::printf("\"x_rebuild_ms\": null}\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Бенчмарк шардированной обработки событий: масштабирование от 1 до N потоков
+//
+// Синтетические события окон (Configure/Damage) для 4096 окон; обработчик
+// выполняет немного вычислений и проверяет, что события каждого окна
+// приходят в порядке публикации (FIFO по ключу).
+//
+// Запуск: ./build/bench/shard_bench [кол-во событий] [макс. потоков]
+
+#include <core/sharded.hpp>
+#include <modules/window_events.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr std::size_t window_count = 4096;
+
+// Состояние окна изменяется только потоком шарда этого окна
+struct alignas(64) WindowState {
+    unsigned int last_sequence = 0;
+    std::uint64_t accumulator = 0;
+};
+
+std::vector<WindowState> windows(window_count);
+std::atomic<std::size_t> order_violations = 0;
+
+// Полезная нагрузка обработчика (~сотни наносекунд: пересчет геометрии и т.п.)
+std::uint64_t simulate_work(std::uint64_t seed) {
+    for (int i = 0; i < 200; ++i) seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return seed;
+}
+
+// Порядковый номер события окна передается в поле y
+void on_configure(const WindowConfigureEvent& e) {
+    WindowState& state = windows[e.payload.window];
+    if (static_cast<unsigned int>(e.payload.y) != state.last_sequence + 1) ++order_violations;
+    state.last_sequence = static_cast<unsigned int>(e.payload.y);
+    state.accumulator += simulate_work(e.payload.width);
+}
+
+void on_damage(const WindowDamageEvent& e) {
+    WindowState& state = windows[e.payload.window];
+    if (static_cast<unsigned int>(e.payload.y) != state.last_sequence + 1) ++order_violations;
+    state.last_sequence = static_cast<unsigned int>(e.payload.y);
+    state.accumulator += simulate_work(e.payload.height);
+}
+
+constexpr auto bus = EventBus<>{}
+    .subscribe<WindowConfigureEvent, on_configure>()
+    .subscribe<WindowDamageEvent, on_damage>();
+using Bus = std::remove_const_t<decltype(bus)>;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t events = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t max_threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                                             : std::max(4u, std::thread::hardware_concurrency());
+
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    double baseline = 0;
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        for (auto& w : windows) w = WindowState{};
+        order_violations = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            ShardedPublisher<Bus, WindowConfigureEvent, WindowDamageEvent> sharded(threads);
+            for (std::size_t i = 0; i < events; ++i) {
+                const Window window = i % window_count;
+                const int sequence = static_cast<int>(i / window_count + 1);
+                if (i % 3) {
+                    sharded.publish(WindowDamageEvent{.payload = {window, 0, sequence, 10, 10}});
+                } else {
+                    sharded.publish(WindowConfigureEvent{.payload = {window, 0, sequence, 640, 480}});
+                }
+            }
+            sharded.flush();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double rate = events / seconds;
+        if (threads == 1) baseline = rate;
+
+        std::printf("%2zu shard(s): %10.0f events/s  speedup x%.2f  order violations: %zu\n",
+                    threads, rate, rate / baseline, order_violations.load());
+    }
+    return order_violations != 0;
+}
@@ -0,0 +1,81 @@
+// Бенчмарк seqlock снимка состояния: один писатель и N читателей
+//
+// Писатель обновляет снимок с максимальной скоростью (худший случай для
+// читателей), читатели непрерывно читают через StateSnapshotReader.
+// Отчет: чтений в секунду на читателя, доля повторов и неудачных чтений.
+//
+// Запуск: ./build/bench/snapshot_bench [кол-во читателей] [секунд]
+
+#include <modules/state_snapshot.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const unsigned int readers = argc > 1 ? std::atoi(argv[1]) : 4;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+
+    StateSnapshotModule snapshot("/twm-state-bench-" + std::to_string(getpid()));
+    snapshot.initialize();
+
+    std::atomic<bool> stop = false;
+    std::atomic<bool> torn = false;
+    std::vector<std::uint64_t> reads(readers), failures(readers);
+    std::vector<std::thread> threads;
+
+    for (unsigned int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            StateSnapshotReader reader;
+            if (!reader.open(snapshot.name())) return;
+            StateSnapshotData data;
+            std::uint64_t count = 0, failed = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!reader.read(data)) {
+                    ++failed;
+                    continue;
+                }
+                // Писатель записывает одно и то же значение во все поля
+                if (data.workspace != data.layouts[0] || data.focused_window != data.window_counts[15]) {
+                    torn = true;
+                }
+                ++count;
+            }
+            reads[r] = count;
+            failures[r] = failed;
+        });
+    }
+
+    std::uint64_t writes = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+        for (int i = 0; i < 1000; ++i) {
+            const auto value = static_cast<std::uint32_t>(++writes);
+            snapshot.update([value](StateSnapshotData& data) {
+                data.focused_window = value;
+                data.workspace = value;
+                for (auto& layout : data.layouts) layout = value;
+                for (auto& count : data.window_counts) count = value;
+            });
+        }
+    }
+    stop = true;
+    for (auto& thread : threads) thread.join();
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::uint64_t total_reads = 0, total_failures = 0;
+    for (unsigned int r = 0; r < readers; ++r) {
+        total_reads += reads[r];
+        total_failures += failures[r];
+    }
+
+    std::printf("writes: %.0f/s\n", writes / elapsed);
+    std::printf("reads: %.0f/s per reader (%u readers), failed reads: %llu, torn snapshots: %s\n",
+                readers ? total_reads / elapsed / readers : 0.0, readers,
+                static_cast<unsigned long long>(total_failures), torn ? "YES" : "no");
+
+    snapshot.cleanup();
+    return torn ? 1 : 0;
+}
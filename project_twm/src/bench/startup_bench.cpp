@@ -0,0 +1,72 @@
+// Бенчмарк времени запуска: последовательная и параллельная инициализация
+//
+// Синтетические модули имитируют медленную инициализацию (подключение к X,
+// загрузка шрифтов и конфига, открытие сокетов) через sleep и объявляют
+// зависимости через depends_on.
+//
+// Граф:  XConn(40) -> Fonts(30) -> Bar(10)
+//        XConn(40) -> Keys(20)
+//        Config(30), Socket(20), Snapshot(20) - независимые
+//
+// Запуск: ./build/bench/startup_bench
+
+#include <core/compositor.hpp>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace {
+template<int Millis, typename... Deps>
+struct SlowModule : ModuleBase<SlowModule<Millis, Deps...>> {
+    using depends_on = type_list<Deps...>;
+
+    void initialize() { std::this_thread::sleep_for(std::chrono::milliseconds(Millis)); }
+    void cleanup() { std::this_thread::sleep_for(std::chrono::milliseconds(Millis / 4)); }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+};
+
+// Разные типы для модулей с одинаковым временем
+template<int Id, int Millis, typename... Deps>
+struct Tagged : SlowModule<Millis, Deps...> {
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+};
+
+using XConn = Tagged<0, 40>;
+using Fonts = Tagged<1, 30, XConn>;
+using Bar = Tagged<2, 10, Fonts>;
+using Keys = Tagged<3, 20, XConn>;
+using Config = Tagged<4, 30>;
+using Socket = Tagged<5, 20>;
+using Snapshot = Tagged<6, 20>;
+
+using TestCompositor = Compositor<Bar, Fonts, Keys, XConn, Config, Socket, Snapshot>;
+
+template<typename F>
+double measure_ms(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+int main() {
+    TestCompositor compositor{Bar{}, Fonts{}, Keys{}, XConn{}, Config{}, Socket{}, Snapshot{}};
+
+    const double serial_init = measure_ms([&] { compositor.initialize(1); });
+    const double serial_cleanup = measure_ms([&] { compositor.cleanup(1); });
+    const double parallel_init = measure_ms([&] { compositor.initialize(); });
+    const double parallel_cleanup = measure_ms([&] { compositor.cleanup(); });
+
+    std::printf("initialize: serial %.1f ms, parallel %.1f ms (x%.2f, critical path 80 ms)\n",
+                serial_init, parallel_init, serial_init / parallel_init);
+    std::printf("cleanup:    serial %.1f ms, parallel %.1f ms (x%.2f)\n",
+                serial_cleanup, parallel_cleanup, serial_cleanup / parallel_cleanup);
+    return 0;
+}
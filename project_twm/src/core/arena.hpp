@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// FRAME ARENA
+////////////////////////////////////////////////////////////////////////////////
+
+// Монотонная арена для временных данных одной итерации главного цикла
+// - Выделение - сдвиг указателя, deallocate() ничего не делает
+// - reset() в конце итерации освобождает все разом
+// - Если итерации не хватило первого блока, при reset() блоки
+//   объединяются в один большой, и в установившемся режиме арена
+//   не обращается к глобальной куче
+//
+// CompositorRunner владеет ареной и сбрасывает ее после каждой итерации;
+// обработчики и публикаторы получают ее через frame_resource():
+//   struct PrintMsgPayload { std::pmr::string msg; };
+//   publish(PrintMsgEvent{.payload = {std::pmr::string("text", frame_resource())}});
+//
+// Объекты, выделенные в арене, не должны переживать итерацию цикла.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(std::size_t initial_size = 64 * 1024,
+                        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream)
+    {
+        add_block(initial_size);
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    ~FrameArena() override {
+        for (const Block& block : blocks_) upstream_->deallocate(block.data, block.size, alignof(std::max_align_t));
+    }
+
+    // Освобождение всего выделенного за итерацию
+    void reset() {
+        if (blocks_.size() > 1) {
+            // Итерации не хватило первого блока: заменяем все одним блоком
+            // суммарного размера, чтобы следующая итерация поместилась в него
+            std::size_t total = 0;
+            for (const Block& block : blocks_) {
+                total += block.size;
+                upstream_->deallocate(block.data, block.size, alignof(std::max_align_t));
+            }
+            blocks_.clear();
+            add_block(total);
+        }
+        current_ = blocks_.front().data;
+        end_ = current_ + blocks_.front().size;
+        peak_ = std::max(peak_, used_);
+        used_ = 0;
+    }
+
+    std::size_t used() const { return used_; }          // Байт выделено в текущей итерации
+    std::size_t peak() const { return std::max(peak_, used_); }
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (const Block& block : blocks_) total += block.size;
+        return total;
+    }
+    std::size_t upstream_allocations() const { return upstream_allocations_; }
+
+private:
+    struct Block {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::byte* aligned = align_up(current_, alignment);
+        if (aligned + bytes > end_) {
+            add_block(std::max(bytes + alignment, blocks_.back().size * 2));
+            aligned = align_up(current_, alignment);
+        }
+        current_ = aligned + bytes;
+        used_ += bytes;
+        return aligned;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    static std::byte* align_up(std::byte* ptr, std::size_t alignment) {
+        const auto value = reinterpret_cast<std::uintptr_t>(ptr);
+        return ptr + ((alignment - value % alignment) % alignment);
+    }
+
+    void add_block(std::size_t size) {
+        auto* data = static_cast<std::byte*>(upstream_->allocate(size, alignof(std::max_align_t)));
+        blocks_.push_back(Block{data, size});
+        current_ = data;
+        end_ = data + size;
+        ++upstream_allocations_;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::vector<Block> blocks_;
+    std::byte* current_ = nullptr;
+    std::byte* end_ = nullptr;
+    std::size_t used_ = 0;
+    std::size_t peak_ = 0;
+    std::size_t upstream_allocations_ = 0;
+};
+
+namespace frame_arena_detail {
+    inline thread_local FrameArena* current = nullptr;
+}
+
+// Арена текущей итерации главного цикла в этом потоке
+// Вне CompositorRunner::run() - ресурс по умолчанию (глобальная куча)
+inline std::pmr::memory_resource* frame_resource() {
+    if (frame_arena_detail::current) return frame_arena_detail::current;
+    return std::pmr::get_default_resource();
+}
+
+// Назначение арены текущему потоку на время жизни объекта
+class FrameArenaScope {
+public:
+    explicit FrameArenaScope(FrameArena& arena) : previous_(frame_arena_detail::current) {
+        frame_arena_detail::current = &arena;
+    }
+
+    FrameArenaScope(const FrameArenaScope&) = delete;
+    FrameArenaScope& operator=(const FrameArenaScope&) = delete;
+
+    ~FrameArenaScope() {
+        frame_arena_detail::current = previous_;
+    }
+
+private:
+    FrameArena* previous_;
+};
@@ -1,8 +1,18 @@
 #pragma once
 
+#include <core/arena.hpp>
 #include <core/event.hpp>
 #include <core/module.hpp>
+#include <core/restart.hpp>
+#include <core/type_list.hpp>
+#include <algorithm>
+#include <array>
 #include <concepts>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <type_traits>
 #include <tuple>
 #include <utility>
@@ -11,6 +21,94 @@
 #include <unistd.h>
 #include <cerrno>
 
+////////////////////////////////////////////////////////////////////////////////
+// DEPENDENCY GRAPH SCHEDULER (для инициализации и очистки модулей)
+////////////////////////////////////////////////////////////////////////////////
+
+template<std::size_t N>
+using dependency_matrix_t = std::array<std::array<bool, N>, N>;
+
+// Проверка отсутствия циклов (алгоритм Кана), вычисляется при компиляции
+template<std::size_t N>
+constexpr bool is_acyclic(const dependency_matrix_t<N>& depends) {
+    std::array<std::size_t, N> pending{};
+    for (std::size_t i = 0; i < N; ++i)
+        for (std::size_t j = 0; j < N; ++j) pending[i] += depends[i][j];
+
+    std::array<bool, N> finished{};
+    for (std::size_t step = 0; step < N; ++step) {
+        std::size_t next = N;
+        for (std::size_t i = 0; i < N && next == N; ++i) {
+            if (!finished[i] && pending[i] == 0) next = i;
+        }
+        if (next == N) return false;
+        finished[next] = true;
+        for (std::size_t i = 0; i < N; ++i) pending[i] -= depends[i][next];
+    }
+    return true;
+}
+
+// Выполнение задач графа на max_threads потоках (включая вызывающий)
+// depends[i][j] - задача i выполняется после задачи j;
+// при reverse порядок обратный (j после i).
+// Задача запускается, как только завершены все ее предшественники.
+// После первого исключения новые задачи не запускаются, исключение
+// пробрасывается после завершения уже начатых задач.
+template<std::size_t N, typename Task>
+void run_dependency_graph(const dependency_matrix_t<N>& depends, bool reverse,
+                          std::size_t max_threads, Task&& task) {
+    auto edge = [&](std::size_t before, std::size_t after) {
+        return reverse ? depends[before][after] : depends[after][before];
+    };
+
+    std::array<std::size_t, N> pending{};
+    std::vector<std::size_t> ready;
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j < N; ++j) pending[i] += edge(j, i);
+        if (pending[i] == 0) ready.push_back(i);
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t done = 0;
+    std::exception_ptr error;
+
+    auto worker = [&] {
+        std::unique_lock lock(mutex);
+        while (true) {
+            cv.wait(lock, [&] { return error || done == N || !ready.empty(); });
+            if (error || done == N) return;
+
+            const std::size_t current = ready.back();
+            ready.pop_back();
+            lock.unlock();
+            try {
+                task(current);
+            } catch (...) {
+                lock.lock();
+                if (!error) error = std::current_exception();
+                cv.notify_all();
+                return;
+            }
+            lock.lock();
+
+            ++done;
+            for (std::size_t next = 0; next < N; ++next) {
+                if (edge(current, next) && --pending[next] == 0) ready.push_back(next);
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    const std::size_t thread_count = std::clamp<std::size_t>(max_threads, 1, std::max<std::size_t>(N, 1));
+    for (std::size_t i = 1; i < thread_count; ++i) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+
+    if (error) std::rethrow_exception(error);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // COMPOSITOR/WINDOW MANAGER INTERFACE
 ////////////////////////////////////////////////////////////////////////////////
@@ -21,8 +119,12 @@
 // Архитектура:
 // - Содержит центральный EventBus для связи между модулями
 // - Регистрирует модули и их привязки в EventBus
-// - Управляет инициализацией и очисткой модулей
-// - Предоставляет интерфейс для публикации событий и отправки команд/запросов
+// - Управляет инициализацией и очисткой модулей с учетом зависимостей
+//   (M::depends_on): независимые модули инициализируются параллельно,
+//   очистка выполняется в обратном топологическом порядке
+// - Предоставляет интерфейс для публикации событий и отправки команд/запросов;
+//   обработчики-члены модулей (&M::on_event) вызываются на экземплярах
+//   модулей этого композитора, поэтому у каждого композитора свое состояние
 //
 // Пример использования:
 //   struct InputModule : ModuleBase<InputModule> { ... };
@@ -42,77 +144,130 @@ public:
         , bus_(register_modules_impl(EventBus<>{}, std::make_index_sequence<sizeof...(Modules)>{}))
     {}
 
-    void initialize() {
-        (initialize_module<Modules>(), ...);
+    // Инициализация модулей; модуль запускается после всех своих зависимостей,
+    // независимые модули выполняются одновременно на max_threads потоках
+    // (max_threads = 1 - последовательно в топологическом порядке).
+    // По умолчанию поток на модуль: инициализация обычно ждет ввода-вывода
+    void initialize(std::size_t max_threads = sizeof...(Modules)) {
+        run_dependency_graph<sizeof...(Modules)>(dependencies_, false,
+            std::min(max_threads, initializable_count_), [this](std::size_t index) {
+                initializers_[index](*this);
+            });
+    }
+
+    // Очистка модулей в обратном порядке зависимостей
+    void cleanup(std::size_t max_threads = sizeof...(Modules)) {
+        run_dependency_graph<sizeof...(Modules)>(dependencies_, true,
+            std::min(max_threads, cleanup_count_), [this](std::size_t index) {
+                cleanups_[index](*this);
+            });
+    }
+
+    // Запись разделов модулей с serialize() в образ перезапуска
+    void serialize_state(RestartWriter& writer) const {
+        (serialize_module<Modules>(writer), ...);
     }
 
-    void cleanup() {
-        (cleanup_module<Modules>(), ...);
+    // Восстановление модулей из образа предыдущего процесса (до initialize());
+    // модуль без своего раздела или с другой версией формата стартует с нуля.
+    // Возвращает количество восстановленных модулей
+    std::size_t restore_state(const RestartImage& image) {
+        return (std::size_t{0} + ... + restore_module<Modules>(image));
     }
 
     template<Event E>
     inline void publish(const E& event) {
-        bus_.template publish<E>(event);
+        bus_.publish(event, *this);
     }
 
-    inline template<Command C>
-    void dispatch(const C& command) {
-        bus_.template dispatch<C>(command);
+    template<Command C>
+    inline void dispatch(const C& command) {
+        bus_.dispatch(command, *this);
     }
 
     template<Request R>
     inline auto dispatch(const R& request) -> response_t<R> {
-        return bus_.template dispatch<R>(request);
+        return bus_.dispatch(request, *this);
     }
 
     constexpr const BusType& bus() const { return bus_; }
     constexpr BusType& bus() { return bus_; }
 
     template<Module M>
-    requires (std::disjunction_v<std::is_same<M, Modules>...>)
+    requires (contains_v<M, Modules...>)
     constexpr const M& module() const {
-        return std::get<module_index_v<M>>(modules_);
+        return std::get<index_of_v<M, Modules...>>(modules_);
     }
 
     template<Module M>
-    requires (std::disjunction_v<std::is_same<M, Modules>...>)
+    requires (contains_v<M, Modules...>)
     constexpr M& module() {
-        return std::get<module_index_v<M>>(modules_);
+        return std::get<index_of_v<M, Modules...>>(modules_);
     }
 
 protected:
     template<Module M>
     void initialize_module() {
         if constexpr (InitializableModule<M>) {
-            std::get<module_index_v<M>>(modules_).initialize();
+            module<M>().initialize();
         }
     }
 
     template<Module M>
     void cleanup_module() {
         if constexpr (CleanupModule<M>) {
-            std::get<module_index_v<M>>(modules_).cleanup();
+            module<M>().cleanup();
+        }
+    }
+
+    template<Module M>
+    void serialize_module(RestartWriter& writer) const {
+        if constexpr (SerializableModule<M>) {
+            writer.begin_section(M::state_tag, M::state_version);
+            module<M>().serialize(writer);
+            writer.end_section();
+        }
+    }
+
+    template<Module M>
+    bool restore_module(const RestartImage& image) {
+        if constexpr (SerializableModule<M>) {
+            std::optional<RestartReader> reader = image.section(M::state_tag, M::state_version);
+            return reader && module<M>().restore(*reader) && reader->ok();
+        } else {
+            return false;
         }
     }
 
 private:
-    // Вспомогательный шаблон для получения индекса модуля в tuple
-    template<Module M, Module... AllModules>
-    struct module_index_helper;
-    
-    template<Module M, Module First, Module... Rest>
-    struct module_index_helper<M, First, Rest...> {
-        static constexpr std::size_t value = 
-            std::is_same_v<M, First> ? 0 : 1 + module_index_helper<M, Rest...>::value;
+    // Таблицы функций по индексу модуля (для планировщика графа зависимостей)
+    using module_action_t = void (*)(Compositor&);
+
+    static constexpr std::array<module_action_t, sizeof...(Modules)> initializers_ = {
+        [](Compositor& compositor) { compositor.template initialize_module<Modules>(); }...
     };
-    
-    template<Module M>
-    struct module_index_helper<M> {
-        static constexpr std::size_t value = 0; // не должно быть достигнуто
+
+    static constexpr std::array<module_action_t, sizeof...(Modules)> cleanups_ = {
+        [](Compositor& compositor) { compositor.template cleanup_module<Modules>(); }...
     };
-    
-    template<Module M>
-    static constexpr std::size_t module_index_v = module_index_helper<M, Modules...>::value;
+
+    // Строка матрицы зависимостей модуля
+    template<typename... Deps>
+    static constexpr std::array<bool, sizeof...(Modules)> dependency_row(type_list<Deps...>) {
+        static_assert((contains_v<Deps, Modules...> && ...),
+                      "Module dependency is not part of the compositor");
+        std::array<bool, sizeof...(Modules)> row{};
+        ((row[index_of_v<Deps, Modules...>] = true), ...);
+        return row;
+    }
+
+    static constexpr dependency_matrix_t<sizeof...(Modules)> dependencies_ = {
+        dependency_row(module_dependencies_t<Modules>{})...
+    };
+    static_assert(is_acyclic<sizeof...(Modules)>(dependencies_), "Cyclic module dependencies");
+
+    static constexpr std::size_t initializable_count_ = (std::size_t{0} + ... + InitializableModule<Modules>);
+    static constexpr std::size_t cleanup_count_ = (std::size_t{0} + ... + CleanupModule<Modules>);
 
     template<auto... Bindings, std::size_t... Indices>
     constexpr auto register_modules_impl(EventBus<Bindings...> bus, std::index_sequence<Indices...>) {
@@ -122,9 +277,6 @@ private:
     std::tuple<Modules...> modules_;
 
     BusType bus_;
-
-    template<Module... M>
-    friend class CompositorRunner;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -138,7 +290,9 @@ concept EventSourceModule = requires(M module) {
     { module.handle_event() } -> std::same_as<bool>; // возвращает false для остановки
 };
 
-// Концепт для модулей, которые требуют выполнения в главном цикле
+// Концепт для модулей, которые требуют выполнения в главном цикле:
+// run() вызывается раз за итерацию в точке покоя, когда ни один обработчик
+// не выполняется (например, освобождение версий RcuPointer)
 template<typename M>
 concept RunnableModule = requires(M module) {
     { module.run() } -> std::same_as<void>;
@@ -146,11 +300,15 @@ concept RunnableModule = requires(M module) {
 
 // Единый главный цикл композитора
 // Использует poll() для мониторинга всех источников событий
+// Владеет ареной итерации (FrameArena): на время run() она доступна
+// обработчикам и публикаторам через frame_resource() и сбрасывается
+// перед каждой следующей итерацией цикла
 template<Module... Modules>
 class CompositorRunner {
 public:
-    CompositorRunner(Compositor<Modules...>& compositor) 
-        : compositor_(compositor) {
+    CompositorRunner(Compositor<Modules...>& compositor, std::size_t arena_size = 64 * 1024) 
+        : compositor_(compositor)
+        , arena_(arena_size) {
         setup_event_sources();
     }
 
@@ -158,7 +316,12 @@ public:
     // Использует poll() для мониторинга всех источников событий
     template<typename ExitCheck = std::nullptr_t>
     void run(ExitCheck exit_check = nullptr) {
+        FrameArenaScope arena_scope(arena_);
         while (running_) {
+            // Все временные данные предыдущей итерации освобождаются разом
+            arena_.reset();
+            (run_module<Modules>(), ...);
+
             // Проверка условия выхода (если предоставлена)
             if constexpr (!std::is_same_v<ExitCheck, std::nullptr_t>) {
                 if (exit_check()) {
@@ -205,6 +368,11 @@ public:
         return running_;
     }
 
+    // Арена итерации (для статистики)
+    const FrameArena& arena() const {
+        return arena_;
+    }
+
 private:
     // Настройка источников событий от модулей
     void setup_event_sources() {
@@ -218,66 +386,33 @@ private:
             int fd = compositor_.template module<M>().event_fd();
             if (fd >= 0) {
                 poll_fds_.push_back({fd, POLLIN | POLLPRI, 0});
-                event_source_indices_.push_back(module_index_v<M>);
+                event_handlers_.push_back([](Compositor<Modules...>& compositor) {
+                    return compositor.template module<M>().handle_event();
+                });
             }
         }
     }
 
-    // Обработка события от источника
-    bool handle_event_source(size_t index) {
-        if (index >= event_source_indices_.size()) {
-            return true;
+    // Работа модуля в точке покоя (см. RunnableModule)
+    template<Module M>
+    void run_module() {
+        if constexpr (RunnableModule<M>) {
+            compositor_.template module<M>().run();
         }
-        
-        size_t module_index = event_source_indices_[index];
-        return handle_module_event_by_index(module_index);
-    }
-
-    // Обработка события модуля по индексу
-    bool handle_module_event_by_index(size_t target_index) {
-        return handle_module_event_impl(target_index, std::make_index_sequence<sizeof...(Modules)>{});
-    }
-
-    // Реализация обработки события модуля
-    template<std::size_t... Indices>
-    bool handle_module_event_impl(size_t target_index, std::index_sequence<Indices...>) {
-        bool result = true;
-        ((Indices == target_index ? 
-            (result = handle_module_event_at<Indices>(), true) : false) || ...);
-        return result;
     }
 
-    // Обработка события модуля по позиции в кортеже
-    template<std::size_t Index>
-    bool handle_module_event_at() {
-        using ModuleType = std::tuple_element_t<Index, std::tuple<Modules...>>;
-        if constexpr (EventSourceModule<ModuleType>) {
-            return std::get<Index>(compositor_.modules_).handle_event();
+    // Обработка события от источника
+    bool handle_event_source(size_t index) {
+        if (index >= event_handlers_.size()) {
+            return true;
         }
-        return true;
+        return event_handlers_[index](compositor_);
     }
 
-    // Вспомогательный шаблон для получения индекса модуля
-    template<Module M, Module... AllModules>
-    struct module_index_helper;
-    
-    template<Module M, Module First, Module... Rest>
-    struct module_index_helper<M, First, Rest...> {
-        static constexpr std::size_t value = 
-            std::is_same_v<M, First> ? 0 : 1 + module_index_helper<M, Rest...>::value;
-    };
-    
-    template<Module M>
-    struct module_index_helper<M> {
-        static constexpr std::size_t value = 0;
-    };
-    
-    template<Module M>
-    static constexpr std::size_t module_index_v = module_index_helper<M, Modules...>::value;
-
     Compositor<Modules...>& compositor_;
+    FrameArena arena_;
     std::vector<pollfd> poll_fds_;
-    std::vector<size_t> event_source_indices_; // Индексы модулей для каждого fd
+    std::vector<bool (*)(Compositor<Modules...>&)> event_handlers_; // Обработчик модуля для каждого fd
     bool running_ = true;
 };
 
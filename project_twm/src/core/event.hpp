@@ -1,7 +1,13 @@
 #pragma once
 
-#include <type_traits>
+#include <core/type_list.hpp>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,6 +59,24 @@ struct response_type<T> {
 template<typename T>
 using response_t = typename response_type<T>::type;
 
+// Ключ шарда события (окно, клиент и т.п.) для параллельной обработки
+// (см. core/sharded.hpp); объявляется специализацией для типа payload:
+//   template<> struct shard_key<MyPayload> {
+//       static std::uint64_t get(const MyPayload& p) { return p.window; }
+//   };
+template<typename P>
+struct shard_key {};
+
+template<typename E>
+concept ShardedEvent = Event<E> && requires(const payload_t<E>& payload) {
+    { shard_key<payload_t<E>>::get(payload) } -> std::convertible_to<std::uint64_t>;
+};
+
+template<ShardedEvent E>
+std::uint64_t shard_key_of(const E& event) {
+    return static_cast<std::uint64_t>(shard_key<payload_t<E>>::get(event.payload));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // MESSAGE TYPE IMPLEMENTATIONS
 ////////////////////////////////////////////////////////////////////////////////
@@ -105,18 +129,214 @@ concept Subscription = Event<E>
                     && std::invocable<S, E>
                     && std::same_as<std::invoke_result_t<S, E>, void>;
 
+////////////////////////////////////////////////////////////////////////////////
+// BINDING
+////////////////////////////////////////////////////////////////////////////////
+
+// Класс, которому принадлежит указатель на член: void (Owner::*)(const M&) -> Owner
+template<typename F>
+struct member_owner;
+
+template<typename T, typename Owner>
+struct member_owner<T Owner::*> {
+    using type = Owner;
+};
+
+template<auto F>
+using member_owner_t = typename member_owner<decltype(F)>::type;
+
+// Контекст вызова без экземпляров модулей (допускает только статические обработчики)
+struct static_context {};
+
+// Экземпляр модуля Owner в контексте вызова: сам модуль
+// или хранилище модулей с module<Owner>() (Compositor)
+template<typename Owner, typename Context>
+constexpr decltype(auto) bound_instance(Context& context) {
+    if constexpr (std::is_base_of_v<Owner, std::remove_const_t<Context>>) {
+        return static_cast<Owner&>(context);
+    } else {
+        return context.template module<Owner>();
+    }
+}
+
+// Привязка обработчика к типу сообщения
+// HandlerOrSubscription - функция, лямбда без захвата или указатель на
+// функцию-член модуля (&MyModule::on_event). Функция-член вызывается на
+// экземпляре модуля из контекста вызова; указатель известен при компиляции,
+// поэтому вызов прямой и встраивается так же, как вызов статической функции
 template<Message M, auto HandlerOrSubscription>
 struct Binding {
     using message_type = M;
-    
-    constexpr auto operator()(const M& message) const -> response_t<M> {
+    static constexpr bool instance_bound = std::is_member_function_pointer_v<decltype(HandlerOrSubscription)>;
+
+    constexpr auto operator()(const M& message) const -> response_t<M>
+    requires (!instance_bound) {
         return HandlerOrSubscription(message);
     }
+
+    template<typename Context>
+    constexpr auto operator()(Context& context, const M& message) const -> response_t<M> {
+        if constexpr (instance_bound) {
+            static_assert(!std::is_same_v<std::remove_const_t<Context>, static_context>,
+                          "Member function handler needs a module instance: publish/dispatch through Compositor");
+            using Owner = member_owner_t<HandlerOrSubscription>;
+            return (bound_instance<Owner>(context).*HandlerOrSubscription)(message);
+        } else {
+            return HandlerOrSubscription(message);
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// REQUEST MEMOIZATION
+////////////////////////////////////////////////////////////////////////////////
+
+// Кэширование ответов на запросы на уровне шины
+// Запрос включает кэширование специализацией request_cache_traits,
+// в которой перечислены команды и события, делающие ответы устаревшими:
+//
+//   using GetLayoutRequest = request<WorkspacePayload, Layout>;
+//   template<> struct request_cache_traits<GetLayoutRequest> {
+//       using invalidated_by = type_list<SetLayoutCommand, LayoutChangedEvent>;
+//   };
+//
+// Повторный dispatch с тем же payload между изменениями не вызывает
+// обработчик. Кэш очищается после обработки любой команды/события из
+// invalidated_by. Ключ - payload: используется operator== и std::hash,
+// если они есть, иначе побайтовое сравнение (для типов без заполнителей).
+// Кэш не потокобезопасен: запросы выполняются в главном потоке.
+template<typename R>
+struct request_cache_traits {};
+
+template<typename R>
+concept CachedRequest = Request<R> && requires {
+    typename request_cache_traits<R>::invalidated_by;
+};
+
+struct RequestCacheStats {
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t invalidations;
+    std::size_t size;
+};
+
+namespace request_cache_detail {
+    template<typename P>
+    constexpr bool bytewise_key = std::is_empty_v<P> || std::has_unique_object_representations_v<P>;
+
+    template<typename P>
+    struct key_hash {
+        std::size_t operator()(const P& payload) const {
+            if constexpr (requires { std::hash<P>{}(payload); }) {
+                return std::hash<P>{}(payload);
+            } else if constexpr (std::is_empty_v<P>) {
+                return 0;
+            } else {
+                static_assert(bytewise_key<P>, "Cached request payload needs std::hash or a padding-free layout");
+                // FNV-1a по байтам payload
+                const auto* bytes = reinterpret_cast<const unsigned char*>(&payload);
+                std::size_t hash = 14695981039346656037ull;
+                for (std::size_t i = 0; i < sizeof(P); ++i) hash = (hash ^ bytes[i]) * 1099511628211ull;
+                return hash;
+            }
+        }
+    };
+
+    template<typename P>
+    struct key_equal {
+        bool operator()(const P& a, const P& b) const {
+            if constexpr (std::equality_comparable<P>) {
+                return a == b;
+            } else if constexpr (std::is_empty_v<P>) {
+                return true;
+            } else {
+                static_assert(bytewise_key<P>, "Cached request payload needs operator== or a padding-free layout");
+                return std::memcmp(&a, &b, sizeof(P)) == 0;
+            }
+        }
+    };
+}
+
+// Хранилище ответов запроса R (одно на тип, как и обработчики шины)
+template<CachedRequest R>
+class RequestCache {
+public:
+    using key_type = payload_t<R>;
+    using value_type = response_t<R>;
+
+    template<typename Compute>
+    static value_type get(const R& request, Compute&& compute) {
+        auto it = entries_.find(request.payload);
+        if (it != entries_.end()) {
+            ++hits_;
+            return it->second;
+        }
+        ++misses_;
+        value_type value = std::forward<Compute>(compute)();
+        entries_.insert_or_assign(request.payload, value);
+        return value;
+    }
+
+    static void invalidate() {
+        if (entries_.empty()) return;
+        ++invalidations_;
+        entries_.clear();
+    }
+
+    static RequestCacheStats stats() {
+        return {hits_, misses_, invalidations_, entries_.size()};
+    }
+
+    static void reset_stats() {
+        hits_ = misses_ = invalidations_ = 0;
+    }
+
+private:
+    static inline std::unordered_map<key_type, value_type,
+                                      request_cache_detail::key_hash<key_type>,
+                                      request_cache_detail::key_equal<key_type>> entries_;
+    static inline std::size_t hits_ = 0;
+    static inline std::size_t misses_ = 0;
+    static inline std::size_t invalidations_ = 0;
 };
+
+template<Request R>
+RequestCacheStats request_cache_stats() {
+    if constexpr (CachedRequest<R>) {
+        return RequestCache<R>::stats();
+    } else {
+        return {};
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // STATIC EVENT BUS
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace event_bus_detail {
+    // Выборки из списка типов привязок шины (один экземпляр на шину)
+    // Привязки без состояния: тип привязки однозначно задает обработчик,
+    // поэтому привязка вызывается как B{}(context, msg)
+    template<typename List>
+    struct binding_table;
+
+    template<typename... Bs>
+    struct binding_table<type_list<Bs...>> {
+        // Привязки сообщения M в порядке регистрации
+        template<typename M>
+        using subscribers = decltype((type_list<>{} + ... +
+            keep_if_t<std::is_same_v<typename Bs::message_type, M>, Bs>{}));
+
+        // Привязки кэшируемых запросов
+        using cached_requests = decltype((type_list<>{} + ... +
+            keep_if_t<CachedRequest<typename Bs::message_type>, Bs>{}));
+
+        template<typename M>
+        static constexpr bool handled_by_instance =
+            ((std::is_same_v<typename Bs::message_type, M> && Bs::instance_bound) || ... || false);
+    };
+}
+
 template<auto... Bindings>
 class EventBus {
 public:
@@ -151,45 +371,93 @@ public:
         return EventBus<Bindings..., new_binding>{};
     }
 
+    // Публикация и отправка без контекста: все обработчики должны быть статическими
     template<Event E>
     static constexpr void publish(const E& msg) {
-        (invoke_binding_if_match<Bindings, E>(msg), ...);
+        static_context context;
+        publish(msg, context);
     }
 
     template<Command C>
     static constexpr void dispatch(const C& msg) {
-        dispatch_impl<C, Bindings...>(msg);
+        static_context context;
+        dispatch(msg, context);
     }
 
     template<Request R>
     static constexpr auto dispatch(const R& msg) -> response_t<R> {
-        return dispatch_impl<R, Bindings...>(msg);
+        static_context context;
+        return dispatch(msg, context);
+    }
+
+    // Публикация и отправка с контекстом для обработчиков-членов: context -
+    // модуль-владелец или хранилище модулей с module<Owner>() (Compositor)
+    template<Event E, typename Context>
+    static constexpr void publish(const E& msg, Context& context) {
+        [&]<typename... S>(type_list<S...>) {
+            (S{}(context, msg), ...);
+        }(typename table::template subscribers<E>{});
+        invalidate_cached_requests<E>();
     }
 
+    template<Command C, typename Context>
+    static constexpr void dispatch(const C& msg, Context& context) {
+        dispatch_impl(msg, context);
+        invalidate_cached_requests<C>();
+    }
+
+    template<Request R, typename Context>
+    static constexpr auto dispatch(const R& msg, Context& context) -> response_t<R> {
+        if constexpr (CachedRequest<R>) {
+            static_assert(!table::template handled_by_instance<R>,
+                          "Memoized request needs a static handler: the cache is shared by all compositors");
+            return RequestCache<R>::get(msg, [&] { return dispatch_impl(msg, context); });
+        } else {
+            return dispatch_impl(msg, context);
+        }
+    }
+
+    static constexpr std::size_t size() { return sizeof...(Bindings); }
+
 private:
-    template<auto Binding>
-    using binding_message_t = typename std::decay_t<decltype(Binding)>::message_type;
+    // Пакет Bindings раскрывается один раз в список типов привязок;
+    // все выборки делаются по нему (см. event_bus_detail::binding_table)
+    using table = event_bus_detail::binding_table<type_list<std::remove_cvref_t<decltype(Bindings)>...>>;
+
+    // Очистка кэшей запросов, для которых M указан в invalidated_by
+    // (перебираются только привязки кэшируемых запросов)
+    template<Message M>
+    static constexpr void invalidate_cached_requests() {
+        []<typename... C>(type_list<C...>) {
+            (invalidate_if_depends<typename C::message_type, M>(), ...);
+        }(typename table::cached_requests{});
+    }
 
-    template<auto Binding, Message M>
-    static constexpr void invoke_binding_if_match(const M& msg) {
-        if constexpr (std::is_same_v<binding_message_t<Binding>, M>) {
-            Binding(msg);
+    template<CachedRequest R, Message M>
+    static constexpr void invalidate_if_depends() {
+        if constexpr (list_contains_v<M, typename request_cache_traits<R>::invalidated_by>) {
+            RequestCache<R>::invalidate();
         }
     }
 
-    template<Message M, auto First, auto... Rest>
-    static constexpr auto dispatch_impl(const M& msg) -> response_t<M> {
-        if constexpr (std::is_same_v<binding_message_t<First>, M>) {
-            return First(msg);
-        } else if constexpr (sizeof...(Rest) > 0) {
-            return dispatch_impl<M, Rest...>(msg);
+    // Первый обработчик команды/запроса; без обработчика - ответ по умолчанию
+    template<Message M, typename Context>
+    static constexpr auto dispatch_impl(const M& msg, Context& context) -> response_t<M> {
+        using handlers = typename table::template subscribers<M>;
+        if constexpr (handlers::size > 0) {
+            return front_t<handlers>{}(context, msg);
+        } else if constexpr (std::is_void_v<response_t<M>>) {
+            return;
         } else {
-            static_assert(sizeof...(Rest) >= 0, "Handler not found for message type");
-            if constexpr (std::is_void_v<response_t<M>>) {
-                return;
-            } else {
-                return response_t<M>{};
-            }
+            return response_t<M>{};
         }
     }
 };
+
+// Объединение привязок двух шин (порядок сохраняется)
+// Модули регистрируются каждый в пустую шину, затем шины объединяются:
+// цепочка subscribe() копирует только привязки своего модуля
+template<auto... Left, auto... Right>
+constexpr EventBus<Left..., Right...> operator+(EventBus<Left...>, EventBus<Right...>) {
+    return {};
+}
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <core/event.hpp>
+#include <core/restart.hpp>
+#include <core/type_list.hpp>
 #include <concepts>
+#include <cstdint>
+#include <string_view>
 #include <type_traits>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,10 +36,11 @@ concept Module = requires(M module) {
 //
 // Пример использования:
 //   struct MyModule : ModuleBase<MyModule> {
-//       // Определение обработчиков и подписок как статических функций или лямбд
+//       // Обработчики - статические функции, лямбды без захвата
+//       // или функции-члены (вызываются на экземпляре модуля в Compositor)
 //       static void handle_command(const MyCommand& cmd) { ... }
 //       static void handle_request(const MyRequest& req) -> Response { ... }
-//       static void on_event(const SomeEvent& evt) { ... }
+//       void on_event(const SomeEvent& evt) { ++counter; }
 //       
 //       // Реализация регистрации модуля
 //       template<auto... Bindings>
@@ -43,8 +48,10 @@ concept Module = requires(M module) {
 //           return bus
 //               .template bind_command<MyCommand, handle_command>()
 //               .template bind_request<MyRequest, handle_request>()
-//               .template subscribe_event<SomeEvent, on_event>();
+//               .template subscribe_event<SomeEvent, &MyModule::on_event>();
 //       }
+//
+//       int counter = 0;
 //   };
 //
 //   // Регистрация модуля в EventBus
@@ -86,13 +93,11 @@ constexpr auto register_module(EventBus<Bindings...> bus, const M& module) {
     return module.register_in(bus);
 }
 
-template<auto... Bindings, typename M, typename... Modules>
-constexpr auto register_modules(EventBus<Bindings...> bus, const M& module, const Modules&... modules) {
-    if constexpr (sizeof...(modules) == 0) {
-        return register_module(bus, module);
-    } else {
-        return register_modules(register_module(bus, module), modules...);
-    }
+// Регистрация модулей по порядку без рекурсии: каждый модуль регистрирует
+// привязки в пустую шину, результаты объединяются одной свёрткой
+template<auto... Bindings, typename... Modules>
+constexpr auto register_modules(EventBus<Bindings...> bus, const Modules&... modules) {
+    return (bus + ... + register_module(EventBus<>{}, modules));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -108,3 +113,41 @@ template<typename M>
 concept CleanupModule = requires(M module) {
     { module.cleanup() } -> std::same_as<void>;
 };
+
+// Модуль, состояние которого переживает перезапуск (см. core/restart.hpp):
+//   struct WindowModule : ModuleBase<WindowModule> {
+//       static constexpr std::string_view state_tag = "windows";
+//       static constexpr std::uint32_t state_version = 1; // менять вместе с форматом
+//       void serialize(RestartWriter& out) const { ... }
+//       bool restore(RestartReader& in) { ... }       // false - старт с нуля
+//   };
+// restore() вызывается до initialize(), поэтому initialize() может
+// пропустить опрос X сервера для уже восстановленного состояния
+template<typename M>
+concept SerializableModule = requires(M module, const M& const_module, RestartWriter& out, RestartReader& in) {
+    { M::state_tag } -> std::convertible_to<std::string_view>;
+    { M::state_version } -> std::convertible_to<std::uint32_t>;
+    { const_module.serialize(out) } -> std::same_as<void>;
+    { module.restore(in) } -> std::same_as<bool>;
+};
+
+// Зависимости модуля объявляются списком типов:
+//   struct FontModule : ModuleBase<FontModule> {
+//       using depends_on = type_list<XConnectionModule>;
+//       void initialize() { ... } // выполняется после XConnectionModule::initialize()
+//   };
+// Compositor инициализирует независимые модули параллельно,
+// а очищает в обратном порядке зависимостей
+template<typename M>
+struct module_dependencies {
+    using type = type_list<>;
+};
+
+template<typename M>
+requires requires { typename M::depends_on; }
+struct module_dependencies<M> {
+    using type = typename M::depends_on;
+};
+
+template<typename M>
+using module_dependencies_t = typename module_dependencies<M>::type;
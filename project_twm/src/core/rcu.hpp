@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// RCU POINTER
+////////////////////////////////////////////////////////////////////////////////
+
+// Указатель с публикацией в стиле RCU (read-copy-update)
+// - Читатели получают текущую версию одной атомарной загрузкой и работают
+//   с ней до конца обработки события, не видя частично обновленных данных
+// - Писатель (любой поток) строит новую версию целиком и публикует ее
+//   атомарной заменой указателя; старая версия откладывается
+// - Отложенные версии освобождаются в reclaim(), который вызывается потоком
+//   читателей в точке покоя (между событиями главного цикла), когда
+//   ни одна ссылка на старые версии уже не используется
+//
+// Пример использования:
+//   RcuPointer<Table> table{std::make_unique<Table>()};
+//   // поток читателей:
+//   const Table* t = table.read(); use(*t);
+//   // фоновый поток:
+//   table.publish(std::make_unique<Table>(build()));
+//   // поток читателей в точке покоя:
+//   table.reclaim();
+template<typename T>
+class RcuPointer {
+public:
+    explicit RcuPointer(std::unique_ptr<const T> initial = nullptr)
+        : current_(initial.release())
+    {}
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    ~RcuPointer() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    // Текущая версия; действительна до следующего reclaim() в потоке читателей
+    const T* read() const {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    // Атомарная замена версии; старая версия освобождается в reclaim()
+    void publish(std::unique_ptr<const T> next) {
+        const T* previous = current_.exchange(next.release(), std::memory_order_acq_rel);
+        if (previous) {
+            std::lock_guard lock(retired_mutex_);
+            retired_.emplace_back(previous);
+        }
+    }
+
+    // Освобождение отложенных версий (только в точке покоя читателей)
+    void reclaim() {
+        std::vector<std::unique_ptr<const T>> retired;
+        {
+            std::lock_guard lock(retired_mutex_);
+            retired.swap(retired_);
+        }
+    }
+
+private:
+    std::atomic<const T*> current_;
+    std::mutex retired_mutex_;
+    std::vector<std::unique_ptr<const T>> retired_;
+};
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// RESTART IMAGE - Передача состояния модулей новому процессу через memfd
+////////////////////////////////////////////////////////////////////////////////
+//
+// Перезапуск на месте (обновление бинарника, перезагрузка кода) без
+// восстановления состояния опросом X сервера:
+//
+// 1) Compositor::serialize_state() пишет разделы модулей с serialize()
+//    (см. SerializableModule) в плоский образ
+// 2) restart_image::exec() кладет образ в memfd, запечатывает его и
+//    выполняет execv; номер дескриптора передается в TWM_RESTART_FD
+// 3) Новый процесс отображает образ (RestartImage::from_environment())
+//    и вызывает Compositor::restore_state() до initialize()
+//
+// Формат: заголовок, затем разделы {тег модуля, версия формата модуля,
+// размер, данные}. Все смещения выровнены на 8 байт, поэтому массивы
+// тривиальных типов читаются прямо из отображения без копирования.
+// Раздел с другой версией пропускается - модуль стартует с нуля.
+//
+// Пример использования (модуль):
+//   static constexpr std::string_view state_tag = "windows";
+//   static constexpr std::uint32_t state_version = 1;
+//   void serialize(RestartWriter& out) const { out.write_array(std::span(windows_)); }
+//   bool restore(RestartReader& in) {
+//       auto windows = in.read_array<ManagedWindow>();
+//       windows_.assign(windows.begin(), windows.end());
+//       return in.ok();
+//   }
+//
+////////////////////////////////////////////////////////////////////////////////
+
+namespace restart_image {
+    inline constexpr std::uint32_t magic = 0x524D5754; // "TWMR"
+    inline constexpr std::uint32_t version = 1;
+    inline constexpr std::size_t alignment = 8;
+    inline constexpr std::size_t max_tag_size = 23;
+    inline constexpr const char* environment_variable = "TWM_RESTART_FD";
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t section_count;
+        std::uint32_t reserved;
+        std::uint64_t size;  // Весь образ вместе с заголовком
+    };
+
+    struct SectionHeader {
+        char tag[max_tag_size + 1];  // Тег модуля, дополненный нулями
+        std::uint32_t state_version;
+        std::uint32_t reserved;
+        std::uint64_t size;          // Данные раздела без выравнивания
+    };
+
+    static_assert(sizeof(Header) % alignment == 0);
+    static_assert(sizeof(SectionHeader) % alignment == 0);
+
+    constexpr std::size_t align_up(std::size_t size) {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// WRITER
+////////////////////////////////////////////////////////////////////////////////
+
+// Построение образа в памяти; модуль пишет только в свой раздел
+class RestartWriter {
+public:
+    RestartWriter() {
+        buffer_.resize(sizeof(restart_image::Header));
+    }
+
+    // Значение тривиального типа (выравнивается до 8 байт)
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    void write(const T& value) {
+        append(&value, sizeof(T));
+    }
+
+    // Массив: количество элементов, затем данные
+    template<typename T>
+    requires std::is_trivially_copyable_v<T> && (alignof(T) <= restart_image::alignment)
+    void write_array(std::span<const T> values) {
+        write(static_cast<std::uint64_t>(values.size()));
+        append(values.data(), values.size_bytes());
+    }
+
+    template<typename T>
+    requires (!std::is_const_v<T>)
+    void write_array(std::span<T> values) {
+        write_array(std::span<const T>(values));
+    }
+
+    void write_string(std::string_view value) {
+        write_array(std::span<const char>(value.data(), value.size()));
+    }
+
+    // Используется Compositor::serialize_state()
+    void begin_section(std::string_view tag, std::uint32_t state_version) {
+        restart_image::SectionHeader header{};
+        std::memcpy(header.tag, tag.data(), std::min(tag.size(), restart_image::max_tag_size));
+        header.state_version = state_version;
+        section_offset_ = buffer_.size();
+        append(&header, sizeof(header));
+    }
+
+    void end_section() {
+        auto* header = reinterpret_cast<restart_image::SectionHeader*>(buffer_.data() + section_offset_);
+        header->size = buffer_.size() - section_offset_ - sizeof(restart_image::SectionHeader);
+        ++section_count_;
+    }
+
+    // Готовый образ (заголовок заполняется здесь)
+    std::span<const std::byte> image() {
+        const restart_image::Header header{
+            .magic = restart_image::magic,
+            .version = restart_image::version,
+            .section_count = section_count_,
+            .reserved = 0,
+            .size = buffer_.size()
+        };
+        std::memcpy(buffer_.data(), &header, sizeof(header));
+        return buffer_;
+    }
+
+    std::size_t size() const { return buffer_.size(); }
+
+private:
+    void append(const void* data, std::size_t size) {
+        const std::size_t offset = buffer_.size();
+        buffer_.resize(offset + restart_image::align_up(size));
+        if (size > 0) std::memcpy(buffer_.data() + offset, data, size);
+    }
+
+    std::vector<std::byte> buffer_;
+    std::size_t section_offset_ = 0;
+    std::uint32_t section_count_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// READER
+////////////////////////////////////////////////////////////////////////////////
+
+// Чтение раздела модуля; при выходе за границу раздела чтения возвращают
+// пустые значения, а ok() становится false
+class RestartReader {
+public:
+    explicit RestartReader(std::span<const std::byte> data) : data_(data) {}
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    bool read(T& value) {
+        const std::byte* source = take(sizeof(T));
+        if (!source) return false;
+        std::memcpy(&value, source, sizeof(T));
+        return true;
+    }
+
+    // Массив без копирования: span указывает в отображение образа
+    // и действителен, пока жив RestartImage
+    template<typename T>
+    requires std::is_trivially_copyable_v<T> && (alignof(T) <= restart_image::alignment)
+    std::span<const T> read_array() {
+        std::uint64_t count = 0;
+        if (!read(count) || count > (data_.size() - offset_) / std::max<std::size_t>(sizeof(T), 1)) {
+            ok_ = false;
+            return {};
+        }
+        const std::byte* source = take(count * sizeof(T));
+        if (!source) return {};
+        return {reinterpret_cast<const T*>(source), static_cast<std::size_t>(count)};
+    }
+
+    std::string_view read_string() {
+        const std::span<const char> chars = read_array<char>();
+        return {chars.data(), chars.size()};
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    const std::byte* take(std::size_t size) {
+        const std::size_t padded = restart_image::align_up(size);
+        if (!ok_ || padded > data_.size() - offset_) {
+            ok_ = false;
+            return nullptr;
+        }
+        const std::byte* result = data_.data() + offset_;
+        offset_ += padded;
+        return result;
+    }
+
+    std::span<const std::byte> data_;
+    std::size_t offset_ = 0;
+    bool ok_ = true;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// IMAGE
+////////////////////////////////////////////////////////////////////////////////
+
+// Отображенный образ, полученный от предыдущего процесса
+class RestartImage {
+public:
+    RestartImage(const RestartImage&) = delete;
+    RestartImage& operator=(const RestartImage&) = delete;
+
+    RestartImage(RestartImage&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    RestartImage& operator=(RestartImage&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~RestartImage() {
+        unmap();
+    }
+
+    // Отображение образа из дескриптора (дескриптор закрывается);
+    // nullopt - не образ или другая версия формата
+    static std::optional<RestartImage> open(int fd) {
+        struct stat st;
+        if (fstat(fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(restart_image::Header)) {
+            close(fd);
+            return std::nullopt;
+        }
+        void* addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) return std::nullopt;
+
+        RestartImage image(static_cast<const std::byte*>(addr), static_cast<std::size_t>(st.st_size));
+        if (image.header().magic != restart_image::magic || image.header().version != restart_image::version
+            || image.header().size != image.size_) {
+            return std::nullopt;
+        }
+        return image;
+    }
+
+    // Образ, переданный через TWM_RESTART_FD; переменная удаляется,
+    // чтобы ее не унаследовали запускаемые программы
+    static std::optional<RestartImage> from_environment() {
+        const char* value = std::getenv(restart_image::environment_variable);
+        if (!value || !*value) return std::nullopt;
+        const int fd = std::atoi(value);
+        unsetenv(restart_image::environment_variable);
+        return open(fd);
+    }
+
+    // Данные раздела модуля; nullopt - раздела нет или версия не совпадает
+    std::optional<RestartReader> section(std::string_view tag, std::uint32_t state_version) const {
+        std::size_t offset = sizeof(restart_image::Header);
+        for (std::uint32_t i = 0; i < header().section_count; ++i) {
+            if (size_ - offset < sizeof(restart_image::SectionHeader)) break;
+            const auto* section = reinterpret_cast<const restart_image::SectionHeader*>(data_ + offset);
+            offset += sizeof(restart_image::SectionHeader);
+            if (section->size > size_ - offset) break;
+
+            const std::string_view section_tag(section->tag, strnlen(section->tag, sizeof(section->tag)));
+            if (section_tag == tag.substr(0, restart_image::max_tag_size)
+                && section->state_version == state_version) {
+                return RestartReader({data_ + offset, static_cast<std::size_t>(section->size)});
+            }
+            offset += restart_image::align_up(section->size);
+        }
+        return std::nullopt;
+    }
+
+    std::size_t size() const { return size_; }
+    std::uint32_t section_count() const { return header().section_count; }
+
+private:
+    RestartImage(const std::byte* data, std::size_t size) : data_(data), size_(size) {}
+
+    const restart_image::Header& header() const {
+        return *reinterpret_cast<const restart_image::Header*>(data_);
+    }
+
+    void unmap() {
+        if (data_) munmap(const_cast<std::byte*>(data_), size_);
+        data_ = nullptr;
+    }
+
+    const std::byte* data_;
+    std::size_t size_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// HANDOFF
+////////////////////////////////////////////////////////////////////////////////
+
+namespace restart_image {
+    // Запечатанный memfd с образом; -1 при ошибке
+    // Дескриптор без FD_CLOEXEC, чтобы пережить execv
+    inline int create(std::span<const std::byte> image) {
+        const int fd = memfd_create("twm-restart", MFD_ALLOW_SEALING);
+        if (fd < 0) return -1;
+        std::size_t written = 0;
+        while (written < image.size()) {
+            const ssize_t n = ::write(fd, image.data() + written, image.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                close(fd);
+                return -1;
+            }
+            written += static_cast<std::size_t>(n);
+        }
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+        return fd;
+    }
+
+    // Путь установленного бинарника: после установки поверх (rename) старый
+    // inode удален, /proc/self/exe указывает на него и readlink дает
+    // "<путь> (deleted)" - суффикс отрезается, чтобы exec запустил новый файл.
+    // При ошибке readlink - сам /proc/self/exe (текущий образ)
+    inline std::string binary_path() {
+        char buffer[4096];
+        const ssize_t n = readlink("/proc/self/exe", buffer, sizeof(buffer));
+        if (n <= 0 || static_cast<std::size_t>(n) == sizeof(buffer)) return "/proc/self/exe";
+        std::string_view path(buffer, static_cast<std::size_t>(n));
+        constexpr std::string_view deleted = " (deleted)";
+        if (path.ends_with(deleted)) path.remove_suffix(deleted.size());
+        return std::string(path);
+    }
+
+    // Запуск нового образа процесса с передачей состояния
+    // По умолчанию - бинарник по пути текущего (binary_path()), то есть новая
+    // версия, если файл был заменен. Возвращает управление только при ошибке.
+    inline bool exec(RestartWriter& writer, char* const argv[], const char* path = nullptr) {
+        const std::string binary = path ? path : binary_path();
+        const int fd = create(writer.image());
+        if (fd < 0) return false;
+        setenv(environment_variable, std::to_string(fd).c_str(), 1);
+        execv(binary.c_str(), argv);
+        unsetenv(environment_variable);
+        close(fd);
+        return false;
+    }
+}
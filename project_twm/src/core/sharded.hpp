@@ -0,0 +1,263 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <core/type_list.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// SHARDED EVENT PROCESSING
+////////////////////////////////////////////////////////////////////////////////
+
+// Параллельная обработка событий по ключу шарда
+// - Payload события объявляет ключ (окно, клиент) специализацией shard_key
+// - Событие с ключом K всегда обрабатывается одним и тем же потоком,
+//   поэтому события одного ключа обрабатываются строго в порядке публикации,
+//   а события разных ключей - параллельно
+// - Передача между главным потоком и рабочими - lock-free SPSC кольца
+//
+// Обработчики шардированных событий вызываются из рабочих потоков:
+// они могут разделять состояние только в пределах одного ключа.
+// Шардированные события не должны сбрасывать кэши запросов
+// (request_cache_traits::invalidated_by): кэш не потокобезопасен.
+//
+// Пример использования:
+//   template<> struct shard_key<WindowDamagePayload> {
+//       static std::uint64_t get(const WindowDamagePayload& p) { return p.window; }
+//   };
+//
+//   ShardedPublisher<decltype(compositor)::BusType, WindowDamageEvent> sharded(compositor, 4);
+//   sharded.publish(damage_event); // из главного потока
+//   sharded.flush();               // дождаться обработки всех событий
+//
+// Обработчики-члены модулей (&ThumbnailModule::on_damage) вызываются на
+// экземплярах модулей контекста (Compositor); без контекста
+// (ShardedPublisher<Bus, E> sharded(4)) - только свободные обработчики
+
+// Размер кэш-линии для разнесения индексов колец (x86-64, большинство ARM)
+inline constexpr std::size_t cache_line_size = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+// SPSC RING
+////////////////////////////////////////////////////////////////////////////////
+
+// Кольцевой буфер с одним писателем и одним читателем без блокировок
+// Емкость - степень двойки; индексы писателя и читателя в разных кэш-линиях,
+// каждая сторона кэширует индекс другой, чтобы реже читать чужую линию
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1)
+        , slots_(std::make_unique<Slot[]>(mask_ + 1))
+    {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing() {
+        while (try_pop()) {}
+    }
+
+    // Только поток-писатель
+    template<typename U>
+    bool try_push(U&& value) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) return false;
+        }
+        new (slots_[tail & mask_].storage) T(std::forward<U>(value));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только поток-читатель
+    std::optional<T> try_pop() {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) return std::nullopt;
+        }
+        T* slot = std::launder(reinterpret_cast<T*>(slots_[head & mask_].storage));
+        std::optional<T> value(std::move(*slot));
+        slot->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static std::size_t round_up_pow2(std::size_t n) {
+        std::size_t result = 2;
+        while (result < n) result <<= 1;
+        return result;
+    }
+
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(cache_line_size) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_ = 0;   // Копия tail_ у читателя
+    alignas(cache_line_size) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_ = 0;   // Копия head_ у писателя
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// SHARDED PUBLISHER
+////////////////////////////////////////////////////////////////////////////////
+
+// Публикация событий Events... в шину Bus на shard_count рабочих потоках
+// publish() вызывается из одного потока (главного цикла)
+template<typename Bus, ShardedEvent... Events>
+class ShardedPublisher {
+public:
+    using value_type = std::variant<Events...>;
+
+    // Шина без контекста: только свободные обработчики
+    explicit ShardedPublisher(std::size_t shard_count, std::size_t ring_capacity = 4096)
+        : deliver_([](void*, const value_type& value) {
+              std::visit([](const auto& event) { Bus::publish(event); }, value);
+          })
+    {
+        start(shard_count, ring_capacity);
+    }
+
+    // Контекст вызова обработчиков (Compositor): обработчики-члены
+    // вызываются на его экземплярах модулей; контекст должен пережить publisher
+    template<typename Context>
+    requires (!std::is_arithmetic_v<Context>)
+    ShardedPublisher(Context& context, std::size_t shard_count, std::size_t ring_capacity = 4096)
+        : context_(&context)
+        , deliver_([](void* context, const value_type& value) {
+              std::visit([context](const auto& event) { Bus::publish(event, *static_cast<Context*>(context)); }, value);
+          })
+    {
+        start(shard_count, ring_capacity);
+    }
+
+    ShardedPublisher(const ShardedPublisher&) = delete;
+    ShardedPublisher& operator=(const ShardedPublisher&) = delete;
+
+    ~ShardedPublisher() {
+        flush();
+        stopping_.store(true, std::memory_order_release);
+        for (auto& shard : shards_) wake(*shard, true);
+        for (auto& shard : shards_) shard->thread.join();
+    }
+
+    // Постановка события в очередь шарда его ключа
+    // Если кольцо заполнено, писатель ждет (обратное давление)
+    template<typename E>
+    requires (contains_v<E, Events...>)
+    void publish(const E& event) {
+        Shard& shard = *shards_[shard_index(shard_key_of(event))];
+        value_type value(std::in_place_type<E>, event);
+        while (!shard.ring.try_push(std::move(value))) {
+            wake(shard, true);
+            std::this_thread::yield();
+        }
+        ++shard.published;
+        wake(shard, false);
+    }
+
+    // Ожидание обработки всех опубликованных событий
+    void flush() {
+        for (auto& shard : shards_) {
+            while (shard->processed.load(std::memory_order_acquire) != shard->published) {
+                wake(*shard, true);
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::size_t shard_count() const { return shards_.size(); }
+
+    std::size_t shard_index(std::uint64_t key) const {
+        // Перемешивание ключа: идентификаторы окон часто идут с шагом
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return static_cast<std::size_t>(key % shards_.size());
+    }
+
+private:
+    struct alignas(cache_line_size) Shard {
+        explicit Shard(std::size_t capacity) : ring(capacity) {}
+
+        SpscRing<value_type> ring;
+        std::size_t published = 0;                      // Только писатель
+        alignas(cache_line_size) std::atomic<std::size_t> processed{0};
+        std::atomic<bool> sleeping{false};
+        std::atomic<std::uint32_t> signal{0};
+        std::thread thread;
+    };
+
+    void start(std::size_t shard_count, std::size_t ring_capacity) {
+        shards_.reserve(shard_count);
+        for (std::size_t i = 0; i < std::max<std::size_t>(shard_count, 1); ++i) {
+            shards_.push_back(std::make_unique<Shard>(ring_capacity));
+        }
+        for (auto& shard : shards_) {
+            shard->thread = std::thread([this, s = shard.get()] { worker(*s); });
+        }
+    }
+
+    // Пробуждение рабочего потока, если он уснул на пустом кольце
+    static void wake(Shard& shard, bool force) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (force || shard.sleeping.load(std::memory_order_relaxed)) {
+            shard.signal.fetch_add(1, std::memory_order_release);
+            shard.signal.notify_one();
+        }
+    }
+
+    void worker(Shard& shard) {
+        unsigned int idle_spins = 0;
+        while (true) {
+            if (auto value = shard.ring.try_pop()) {
+                deliver_(context_, *value);
+                shard.processed.fetch_add(1, std::memory_order_release);
+                idle_spins = 0;
+                continue;
+            }
+            if (stopping_.load(std::memory_order_acquire)) return;
+            if (++idle_spins < 256) continue;
+
+            // Засыпание: флаг выставляется до повторной проверки кольца,
+            // чтобы писатель, положивший событие после проверки, разбудил поток
+            const std::uint32_t signal = shard.signal.load(std::memory_order_acquire);
+            shard.sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (shard.ring.empty() && !stopping_.load(std::memory_order_acquire)) {
+                shard.signal.wait(signal, std::memory_order_acquire);
+            }
+            shard.sleeping.store(false, std::memory_order_relaxed);
+            idle_spins = 0;
+        }
+    }
+
+    void* context_ = nullptr;
+    void (*deliver_)(void* context, const value_type& value); // Публикация в Bus с контекстом или без
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> stopping_{false};
+};
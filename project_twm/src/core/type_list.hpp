@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////
+// TYPE LIST
+////////////////////////////////////////////////////////////////////////////////
+
+// Общие утилиты метапрограммирования для Compositor, EventBus и модулей
+// Операции без рекурсии по списку (поиск - через constexpr массив,
+// фильтрация - свёрткой): глубина инстанцирования не растет с длиной списка,
+// что держит время компиляции почти линейным при тысячах привязок.
+
+// Список типов для метапрограммирования (зависимости модулей и т.п.)
+template<typename... Ts>
+struct type_list {
+    static constexpr std::size_t size = sizeof...(Ts);
+};
+
+// Содержит ли список Ts... тип T
+template<typename T, typename... Ts>
+constexpr bool contains_v = (std::is_same_v<T, Ts> || ... || false);
+
+// Индекс первого вхождения T в Ts... (sizeof...(Ts), если не найден)
+template<typename T, typename... Ts>
+constexpr std::size_t index_of_v = [] {
+    constexpr bool matches[] = {std::is_same_v<T, Ts>..., false};
+    std::size_t index = 0;
+    while (index < sizeof...(Ts) && !matches[index]) ++index;
+    return index;
+}();
+
+// Конкатенация списков: фильтрация - свёртка (type_list<>{} + ... + keep_if_t<...>{})
+// Пустые слагаемые дают один и тот же тип, поэтому инстанцируются однократно
+template<typename... Left, typename... Right>
+constexpr type_list<Left..., Right...> operator+(type_list<Left...>, type_list<Right...>) {
+    return {};
+}
+
+// type_list<T>, если Keep, иначе type_list<>
+template<bool Keep, typename T>
+using keep_if_t = std::conditional_t<Keep, type_list<T>, type_list<>>;
+
+// Первый тип непустого списка
+template<typename List>
+struct front;
+
+template<typename T, typename... Ts>
+struct front<type_list<T, Ts...>> {
+    using type = T;
+};
+
+template<typename List>
+using front_t = typename front<List>::type;
+
+// Содержит ли список type_list<Ts...> тип T
+template<typename T, typename List>
+struct list_contains;
+
+template<typename T, typename... Ts>
+struct list_contains<T, type_list<Ts...>> : std::bool_constant<contains_v<T, Ts...>> {};
+
+template<typename T, typename List>
+constexpr bool list_contains_v = list_contains<T, List>::value;
@@ -1,50 +1,103 @@
+#include <csignal>
 #include <iostream>
 #include <X11/Xlib.h>
 #include "core/compositor.hpp"
+#include "core/restart.hpp"
+#include "modules/config.hpp"
 #include "modules/keyboard.hpp"
+#include "modules/pointer.hpp"
+#include "modules/probe.hpp"
 #include "modules/shortcuts.hpp"
 
-int main() {
+int main(int, char** argv) {
+    // Записи в закрытый канал или сокет (пробник, клиенты IPC) возвращают
+    // EPIPE и отключают только этот канал, а не завершают композитор
+    signal(SIGPIPE, SIG_IGN);
+
+    // Модули инициализируются параллельно (см. Compositor::initialize)
+    XInitThreads();
+
     Display* display = XOpenDisplay(nullptr);
     if (!display) {
         std::cerr << "Failed to open X display" << std::endl;
         return 1;
     }
 
+    // У модуля мыши свое соединение (см. PointerModule)
+    Display* pointer_display = XOpenDisplay(nullptr);
+    if (!pointer_display) {
+        std::cerr << "Failed to open X display" << std::endl;
+        XCloseDisplay(display);
+        return 1;
+    }
+
     try {
         KeyboardModule keyboard(display);
         
         ShortcutsModule shortcuts;
+
+        ConfigModule config;
+
+        PointerModule pointer(pointer_display);
         
-        auto compositor = Compositor<KeyboardModule, ShortcutsModule>{
-            keyboard, shortcuts
+        // Пробник задержки регистрируется после обработчиков клавиш (TWM_PROBE_FD)
+        auto compositor = Compositor<KeyboardModule, ShortcutsModule, ConfigModule, PointerModule, LatencyProbeModule>{
+            keyboard, shortcuts, config, pointer, LatencyProbeModule::from_environment()
         };
         
-        keyboard.set_key_press_publisher([&compositor](const KeyPressEvent& e) {
+        // Композитор хранит копии модулей, поэтому публикаторы устанавливаются на них
+        auto& compositor_keyboard = compositor.module<KeyboardModule>();
+        compositor_keyboard.set_key_press_publisher([&compositor](const KeyPressEvent& e) {
+            compositor.publish(e);
+        });
+        compositor_keyboard.set_key_release_publisher([&compositor](const KeyReleaseEvent& e) {
             compositor.publish(e);
         });
-        keyboard.set_key_release_publisher([&compositor](const KeyReleaseEvent& e) {
+        compositor.module<PointerModule>().set_publisher([&compositor](const auto& e) {
             compositor.publish(e);
         });
         
+        // Перезапуск на месте: состояние предыдущего процесса до initialize()
+        if (auto image = RestartImage::from_environment()) {
+            const std::size_t restored = compositor.restore_state(*image);
+            std::cout << "Restarted: " << restored << " modules restored from "
+                      << image->size() << " byte image" << std::endl;
+        }
+
         compositor.initialize();
         
         std::cout << "TWM started. Press Escape to exit, Win+B for message." << std::endl;
+        std::cout << "Config: " << config.path() << " (reloaded on change)" << std::endl;
         
         CompositorRunner runner(compositor);
         
         runner.run([&]() {
-            return ShortcutsModule::should_exit();
+            return compositor.module<ShortcutsModule>().should_exit();
         });
         
+        // Образ пишется до cleanup(), пока модули держат состояние
+        const bool restart = compositor.module<ShortcutsModule>().should_restart();
+        RestartWriter image;
+        if (restart) compositor.serialize_state(image);
+
         compositor.cleanup();
+
+        if (restart) {
+            XCloseDisplay(pointer_display);
+            XCloseDisplay(display);
+            restart_image::exec(image, argv);
+            std::cerr << "Restart failed, exiting" << std::endl;
+            return 1;
+        }
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
+        XCloseDisplay(pointer_display);
         XCloseDisplay(display);
         return 1;
     }
     
+    XCloseDisplay(pointer_display);
     XCloseDisplay(display);
     return 0;
 }
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <core/module.hpp>
+#include <modules/shortcuts.hpp>
+#include <X11/Xlib.h>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// CONFIG MODULE - Загрузка и горячая перезагрузка конфигурации
+////////////////////////////////////////////////////////////////////////////////
+//
+// Следит за файлом конфигурации через inotify (источник событий для
+// CompositorRunner). При изменении файла новая таблица шорткатов и раскладок
+// строится в фоновом потоке и атомарно подменяется через
+// ShortcutsModule::publish_table(), поэтому перезагрузка не блокирует ввод,
+// а обработка клавиши всегда видит целиком одну версию таблицы.
+// При ошибке разбора остается действовать предыдущая таблица.
+//
+// Формат файла (одна директива в строке, # - комментарий):
+//   bind Escape exit
+//   bind Mod4+b message Hello from TWM!
+//   bind Mod4+Shift+Return spawn xterm
+//   bind Mod4+Shift+r restart
+//   layout 0 1          # рабочий стол 0 - раскладка 1
+// Модификаторы: Shift, Control/Ctrl, Mod1/Alt, Mod4/Super
+//
+// Пример использования:
+//   auto compositor = Compositor<KeyboardModule, ShortcutsModule, ConfigModule>{
+//       keyboard, shortcuts, ConfigModule{}};
+//   compositor.initialize(); // первая загрузка синхронно
+//
+// При перезапуске (см. core/restart.hpp) таблица передается в образе вместе
+// с отметкой файла (устройство, inode, размер, время изменения); если файл
+// не менялся, initialize() не читает и не разбирает его заново.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+namespace config_parser {
+    // Результат разбора: номер строки с первой ошибкой (0 - без ошибок)
+    struct Result {
+        std::size_t error_line = 0;
+        std::string_view error;
+    };
+
+    inline std::string_view trim(std::string_view s) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '\r')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+        return s;
+    }
+
+    // Следующее слово строки; line сдвигается за него
+    inline std::string_view next_token(std::string_view& line) {
+        line = trim(line);
+        std::size_t end = 0;
+        while (end < line.size() && line[end] != ' ' && line[end] != '\t') ++end;
+        std::string_view token = line.substr(0, end);
+        line.remove_prefix(end);
+        return token;
+    }
+
+    inline bool parse_modifier(std::string_view name, unsigned int& mask) {
+        if (name == "Shift") mask |= ShiftMask;
+        else if (name == "Control" || name == "Ctrl") mask |= ControlMask;
+        else if (name == "Mod1" || name == "Alt") mask |= Mod1Mask;
+        else if (name == "Mod4" || name == "Super") mask |= Mod4Mask;
+        else return false;
+        return true;
+    }
+
+    // "Mod4+Shift+Return" -> модификаторы и keysym
+    // Имя клавиши копируется в буфер на стеке (XStringToKeysym ждет C-строку)
+    inline bool parse_key(std::string_view combo, KeySym& keysym, unsigned int& modifiers) {
+        modifiers = 0;
+        std::size_t plus;
+        while ((plus = combo.find('+')) != std::string_view::npos && plus + 1 < combo.size()) {
+            if (!parse_modifier(combo.substr(0, plus), modifiers)) return false;
+            combo.remove_prefix(plus + 1);
+        }
+        char name[64];
+        if (combo.empty() || combo.size() >= sizeof(name)) return false;
+        std::memcpy(name, combo.data(), combo.size());
+        name[combo.size()] = '\0';
+        keysym = XStringToKeysym(name);
+        return keysym != NoSymbol;
+    }
+
+    inline bool parse_action(std::string_view name, ShortcutAction& action) {
+        if (name == "exit") action = ShortcutAction::exit;
+        else if (name == "message") action = ShortcutAction::message;
+        else if (name == "spawn") action = ShortcutAction::spawn;
+        else if (name == "restart") action = ShortcutAction::restart;
+        else return false;
+        return true;
+    }
+
+    template<typename T>
+    bool parse_number(std::string_view token, T& value) {
+        auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+        return ec == std::errc{} && ptr == token.data() + token.size();
+    }
+
+    // Разбор текста конфига в таблицу; токены - string_view в исходный текст,
+    // память выделяется только под записи таблицы и строки аргументов
+    inline Result parse(std::string_view text, ShortcutTable& table) {
+        std::size_t line_number = 0;
+        while (!text.empty()) {
+            ++line_number;
+            std::size_t eol = text.find('\n');
+            std::string_view line = text.substr(0, eol);
+            text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+            if (std::size_t comment = line.find('#'); comment != std::string_view::npos) {
+                line = line.substr(0, comment);
+            }
+            std::string_view directive = next_token(line);
+            if (directive.empty()) continue;
+
+            if (directive == "bind") {
+                KeySym keysym;
+                unsigned int modifiers;
+                ShortcutAction action;
+                if (!parse_key(next_token(line), keysym, modifiers)) return {line_number, "unknown key"};
+                if (!parse_action(next_token(line), action)) return {line_number, "unknown action"};
+                table.add(keysym, modifiers, action, trim(line));
+            } else if (directive == "layout") {
+                std::size_t workspace;
+                std::uint32_t layout;
+                if (!parse_number(next_token(line), workspace) || workspace >= ShortcutTable::max_workspaces
+                    || !parse_number(next_token(line), layout)) {
+                    return {line_number, "expected: layout <workspace> <layout>"};
+                }
+                table.layouts[workspace] = layout;
+            } else {
+                return {line_number, "unknown directive"};
+            }
+        }
+        table.finalize();
+        return {};
+    }
+
+    // Разбор файла через mmap без копирования содержимого
+    inline Result parse_file(const std::string& path, ShortcutTable& table) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return {1, "cannot open file"};
+
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            close(fd);
+            return {1, "cannot stat file"};
+        }
+        if (st.st_size == 0) {
+            close(fd);
+            return parse({}, table);
+        }
+
+        void* data = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) return {1, "cannot map file"};
+
+        Result result = parse(std::string_view(static_cast<const char*>(data), static_cast<std::size_t>(st.st_size)), table);
+        munmap(data, static_cast<std::size_t>(st.st_size));
+        return result;
+    }
+
+    // Отметка файла для проверки изменений между перезапусками
+    struct FileStamp {
+        std::uint64_t device = 0;
+        std::uint64_t inode = 0;
+        std::int64_t size = -1;          // -1 - файла нет
+        std::int64_t modified_ns = 0;
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    inline FileStamp file_stamp(const std::string& path) {
+        struct stat st;
+        if (stat(path.c_str(), &st) < 0) return {};
+        return {
+            .device = static_cast<std::uint64_t>(st.st_dev),
+            .inode = static_cast<std::uint64_t>(st.st_ino),
+            .size = static_cast<std::int64_t>(st.st_size),
+            .modified_ns = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec
+        };
+    }
+
+    // $XDG_CONFIG_HOME/twm/config или ~/.config/twm/config
+    inline std::string default_path() {
+        if (const char* home = std::getenv("XDG_CONFIG_HOME"); home && *home) {
+            return std::string(home) + "/twm/config";
+        }
+        const char* home = std::getenv("HOME");
+        return std::string(home ? home : ".") + "/.config/twm/config";
+    }
+}
+
+class ConfigModule : public ModuleBase<ConfigModule> {
+public:
+    explicit ConfigModule(std::string path = config_parser::default_path())
+        : state_(std::make_shared<State>(std::move(path)))
+    {}
+
+    static constexpr std::string_view state_tag = "config";
+    static constexpr std::uint32_t state_version = 1;
+
+    void initialize() {
+        State& s = *state_;
+        if (!s.restored) load(s);
+        if (s.inotify_fd >= 0 && s.watch < 0) {
+            // Следим за каталогом: редакторы часто заменяют файл через rename()
+            const std::size_t slash = s.path.rfind('/');
+            const std::string dir = slash == std::string::npos ? "." : s.path.substr(0, slash + 1);
+            s.watch = inotify_add_watch(s.inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        }
+        s.start_worker();
+    }
+
+    void cleanup() {
+        state_->stop_worker();
+    }
+
+    int event_fd() const {
+        return state_->inotify_fd;
+    }
+
+    // Вызывается в главном потоке между событиями; замененные таблицы
+    // освобождает ShortcutsModule::run() в точке покоя главного цикла
+    bool handle_event() {
+        State& s = *state_;
+
+        alignas(inotify_event) char buffer[4096];
+        bool changed = false;
+        ssize_t n;
+        while ((n = read(s.inotify_fd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + n;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                if (event->len > 0 && s.file_name == event->name) changed = true;
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        if (changed) s.request_reload();
+        return true;
+    }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+
+    // Таблица и отметка файла, из которого она построена
+    void serialize(RestartWriter& out) const {
+        std::lock_guard lock(state_->mutex);
+        out.write_string(state_->path);
+        out.write(state_->loaded_stamp);
+        ShortcutsModule::table().serialize(out);
+    }
+
+    // Таблица принимается, только если файл конфига с тех пор не менялся
+    bool restore(RestartReader& in) {
+        State& s = *state_;
+        const std::string_view path = in.read_string();
+        config_parser::FileStamp stamp;
+        in.read(stamp);
+        auto table = std::make_unique<ShortcutTable>();
+        if (!table->restore(in) || path != s.path || stamp != config_parser::file_stamp(s.path)) {
+            return false;
+        }
+        s.loaded_stamp = stamp;
+        s.restored = true;
+        ShortcutsModule::publish_table(std::move(table));
+        return true;
+    }
+
+    const std::string& path() const { return state_->path; }
+
+    // Количество успешных загрузок (для диагностики)
+    std::size_t generation() const { return state_->generation.load(std::memory_order_relaxed); }
+
+    // Ожидание завершения запрошенных перезагрузок
+    void wait_idle() { state_->wait_idle(); }
+
+private:
+    // Состояние общее для всех копий модуля (Compositor хранит копию)
+    struct State {
+        explicit State(std::string config_path)
+            : path(std::move(config_path))
+            , file_name(path.substr(path.rfind('/') == std::string::npos ? 0 : path.rfind('/') + 1))
+            , inotify_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+        {}
+
+        ~State() {
+            stop_worker();
+            if (inotify_fd >= 0) close(inotify_fd);
+        }
+
+        void start_worker() {
+            if (worker.joinable()) return;
+            stopping = false;
+            worker = std::thread([this] { loop(); });
+        }
+
+        void stop_worker() {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            cv.notify_all();
+            if (worker.joinable()) worker.join();
+        }
+
+        // Несколько изменений подряд объединяются в одну перезагрузку
+        void request_reload() {
+            {
+                std::lock_guard lock(mutex);
+                reload_pending = true;
+            }
+            cv.notify_all();
+        }
+
+        void wait_idle() {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [this] { return (!reload_pending && !busy) || !worker.joinable(); });
+        }
+
+        void loop() {
+            std::unique_lock lock(mutex);
+            while (true) {
+                cv.wait(lock, [this] { return stopping || reload_pending; });
+                if (stopping) break;
+                reload_pending = false;
+                busy = true;
+                lock.unlock();
+
+                load(*this);
+
+                lock.lock();
+                busy = false;
+                cv.notify_all();
+            }
+        }
+
+        std::string path;
+        std::string file_name;
+        int inotify_fd;
+        int watch = -1;
+        std::atomic<std::size_t> generation = 0;
+        config_parser::FileStamp loaded_stamp; // Файл последней загруженной таблицы
+        bool restored = false;                 // Таблица получена из образа перезапуска
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool reload_pending = false;
+        bool busy = false;
+        bool stopping = false;
+    };
+
+    // Построение новой таблицы и публикация (в любом потоке)
+    static void load(State& s) {
+        const config_parser::FileStamp stamp = config_parser::file_stamp(s.path);
+        if (stamp.size < 0) return; // Нет конфига - встроенные привязки
+
+        auto table = std::make_unique<ShortcutTable>();
+        config_parser::Result result = config_parser::parse_file(s.path, *table);
+        if (result.error_line != 0) {
+            std::cerr << "Config " << s.path << ":" << result.error_line << ": " << result.error
+                      << " (keeping previous bindings)" << std::endl;
+            return;
+        }
+        {
+            // Таблица и отметка меняются вместе (см. serialize())
+            std::lock_guard lock(s.mutex);
+            ShortcutsModule::publish_table(std::move(table));
+            s.loaded_stamp = stamp;
+        }
+        s.generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<State> state_;
+};
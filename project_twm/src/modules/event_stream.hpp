@@ -0,0 +1,618 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <core/module.hpp>
+#include <modules/ipc.hpp>
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// EVENT STREAM MODULE - Трансляция событий шины IPC клиентам
+////////////////////////////////////////////////////////////////////////////////
+//
+// Внешние программы (статус-бары, скрипты) получают поток выбранных событий
+// шины через Unix domain socket. Медленный клиент не должен тормозить
+// композитор, поэтому:
+//
+// - Событие сериализуется один раз в общий кольцевой буфер кадров
+//   (кадр - ipc::Header с flag_event, type - индекс события в списке
+//   Events..., seq - сквозной номер события, и побайтовая копия payload)
+// - У каждого клиента своя ограниченная очередь ссылок на кадры общего
+//   буфера; при переполнении действует политика медленного клиента:
+//   drop_oldest (старые кадры отбрасываются, клиент видит пропуск в seq)
+//   или disconnect (клиент отключается); оба случая считаются в stats()
+// - Обработчики событий только добавляют кадры и будят главный цикл через
+//   eventfd; отправка - в handle_event() одним неблокирующим sendmsg() на
+//   клиента за итерацию, соседние кадры общего буфера объединяются
+// - Отправка с MSG_NOSIGNAL: подписчик, закрывший сокет, дает EPIPE и
+//   отключается, SIGPIPE композитор не получает
+// - Кадр, записанный в сокет частично, дописывается из копии клиента,
+//   поэтому отбрасывание старых кадров не разрывает поток
+//
+// Клиент может сузить подписку кадром { type = ipc::subscribe_type,
+// payload = uint64 маска индексов событий }; по умолчанию - все события.
+// Обработчики вызываются в потоке композитора (главном).
+//
+// Пример использования:
+//   using Stream = EventStreamModule<FocusChangedEvent, KeyPressEvent>;
+//   auto compositor = Compositor<KeyboardModule, Stream>{keyboard, Stream{}};
+//   compositor.initialize();
+//   CompositorRunner runner(compositor);  // epoll fd модуля попадает в poll()
+//
+//   EventStreamClient<FocusChangedEvent, KeyPressEvent> client;  // другой процесс
+//   client.connect(ipc::default_stream_path());
+//   client.receive([](const auto& event) { ... });
+//
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ipc {
+    // Кадр - событие из потока EventStreamModule
+    inline constexpr std::uint16_t flag_event = 1u << 3;
+    // Тип кадра клиента: выбор событий (payload - uint64 маска индексов)
+    inline constexpr std::uint16_t subscribe_type = UINT16_MAX;
+
+    // Событие, которое можно транслировать без сериализации
+    template<typename E>
+    concept StreamEvent = Event<E> && std::is_trivially_copyable_v<payload_t<E>>
+                       && sizeof(payload_t<E>) <= max_payload_size;
+
+    enum class SlowConsumerPolicy : std::uint8_t {
+        drop_oldest,  // Отбрасывать самые старые неотправленные кадры клиента
+        disconnect    // Отключать клиента, очередь которого переполнена
+    };
+
+    struct StreamConfig {
+        SlowConsumerPolicy policy = SlowConsumerPolicy::drop_oldest;
+        std::size_t client_capacity = 4096;        // Кадров в очереди клиента
+        std::size_t buffer_frames = 16384;         // Кадров в общем буфере (степень двойки)
+        std::size_t buffer_bytes = 1024 * 1024;    // Байт в общем буфере (степень двойки)
+    };
+
+    struct StreamStats {
+        std::uint64_t events = 0;        // Сериализовано событий
+        std::uint64_t frames_sent = 0;   // Кадров отправлено (по всем клиентам)
+        std::uint64_t bytes_sent = 0;
+        std::uint64_t send_calls = 0;    // Вызовов sendmsg()
+        std::uint64_t dropped = 0;       // Кадров отброшено у медленных клиентов
+        std::uint64_t disconnected = 0;  // Клиентов отключено за переполнение
+    };
+
+    // $XDG_RUNTIME_DIR/twm-events.sock или /tmp/twm-events-<uid>.sock
+    inline std::string default_stream_path() {
+        if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime) {
+            return std::string(runtime) + "/twm-events.sock";
+        }
+        return "/tmp/twm-events-" + std::to_string(getuid()) + ".sock";
+    }
+}
+
+template<typename... Events>
+requires (ipc::StreamEvent<Events> && ...) && (sizeof...(Events) <= 64)
+class EventStreamModule : public ModuleBase<EventStreamModule<Events...>> {
+public:
+    explicit EventStreamModule(std::string socket_path = ipc::default_stream_path(), ipc::StreamConfig config = {})
+        : state_(std::make_shared<State>(std::move(socket_path), config))
+    {}
+
+    // Создание слушающего сокета
+    // Сокет остается неактивным, если путь занят или недоступен
+    void initialize() {
+        State& s = *state_;
+        if (s.listen_fd >= 0 || s.epoll_fd < 0) return;
+
+        sockaddr_un addr;
+        if (!ipc::fill_address(addr, s.path)) return;
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return;
+
+        unlink(s.path.c_str()); // Сокет от предыдущего запуска
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 128) < 0) {
+            close(fd);
+            return;
+        }
+        s.watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+        s.listen_fd = fd;
+    }
+
+    void cleanup() {
+        state_->close_all();
+    }
+
+    // epoll fd: новые клиенты, данные от клиентов, готовность к записи
+    // и eventfd с новыми кадрами
+    int event_fd() const {
+        return state_->epoll_fd;
+    }
+
+    bool handle_event() {
+        State& s = *state_;
+        epoll_event events[64];
+        const int count = epoll_wait(s.epoll_fd, events, 64, 0);
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == s.listen_fd) {
+                accept_clients();
+            } else if (fd == s.wake_fd) {
+                std::uint64_t value;
+                while (read(s.wake_fd, &value, sizeof(value)) < 0 && errno == EINTR) {}
+            } else if (auto it = s.clients.find(fd); it != s.clients.end()) {
+                bool alive = !(events[i].events & (EPOLLERR | EPOLLHUP));
+                if (alive && (events[i].events & (EPOLLIN | EPOLLRDHUP))) alive = read_client(it->second);
+                if (!alive) s.drop_client(fd);
+            }
+        }
+        flush();
+        return true;
+    }
+
+    // Отправка накопленных кадров всем клиентам (вызывается из handle_event())
+    void flush() {
+        State& s = *state_;
+        s.wake_pending = false;
+        for (auto it = s.clients.begin(); it != s.clients.end();) {
+            if (send_frames(it->second)) {
+                ++it;
+            } else {
+                const int fd = (it++)->first;
+                s.drop_client(fd);
+            }
+        }
+    }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return (bus + ... + EventBus<>{}.template subscribe_event<Events, &EventStreamModule::template handle<Events>>());
+    }
+
+    template<typename E>
+    static constexpr std::uint16_t type_id = ipc::type_id<E, Events...>();
+
+    const std::string& socket_path() const { return state_->path; }
+    std::size_t client_count() const { return state_->clients.size(); }
+    const ipc::StreamStats& stats() const { return state_->stats; }
+
+private:
+    static constexpr std::uint64_t all_events = sizeof...(Events) == 64 ? ~0ull : (1ull << sizeof...(Events)) - 1;
+
+    // Кадр общего буфера: позиция в байтовом кольце (сквозная) и размер
+    struct Frame {
+        std::uint64_t position;
+        std::uint32_t size;
+        std::uint16_t type;
+    };
+
+    struct Client {
+        int fd = -1;
+        std::uint64_t mask = all_events;
+        std::vector<std::uint64_t> queue;     // Номера кадров общего буфера (кольцо)
+        std::uint64_t head = 0;               // Следующий кадр к отправке
+        std::uint64_t tail = 0;               // Следующая свободная ячейка
+        std::vector<char> carry;              // Недописанный хвост кадра
+        std::size_t carry_offset = 0;
+        std::vector<char> in;                 // Непрочитанный хвост входящих кадров
+        bool writable_watched = false;
+    };
+
+    // Состояние общее для всех копий модуля (Compositor хранит копию)
+    struct State {
+        State(std::string socket_path, ipc::StreamConfig stream_config)
+            : path(std::move(socket_path))
+            , config(stream_config)
+            , epoll_fd(epoll_create1(EPOLL_CLOEXEC))
+            , wake_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+            , bytes(std::bit_ceil(std::max<std::size_t>(config.buffer_bytes, 2 * (sizeof(ipc::Header) + ipc::max_payload_size))))
+            , frames(std::bit_ceil(std::max<std::size_t>(config.buffer_frames, 2)))
+        {
+            config.client_capacity = std::clamp<std::size_t>(config.client_capacity, 1, frames.size());
+            if (epoll_fd >= 0 && wake_fd >= 0) watch(wake_fd, EPOLLIN, EPOLL_CTL_ADD);
+        }
+
+        ~State() {
+            close_all();
+            if (wake_fd >= 0) close(wake_fd);
+            if (epoll_fd >= 0) close(epoll_fd);
+        }
+
+        void watch(int fd, std::uint32_t events, int operation) {
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.fd = fd;
+            epoll_ctl(epoll_fd, operation, fd, &ev);
+        }
+
+        void drop_client(int fd) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+            clients.erase(fd);
+        }
+
+        void close_all() {
+            while (!clients.empty()) drop_client(clients.begin()->first);
+            if (listen_fd >= 0) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, listen_fd, nullptr);
+                close(listen_fd);
+                unlink(path.c_str());
+                listen_fd = -1;
+            }
+        }
+
+        // Копирование в байтовое кольцо с переходом через конец
+        void copy_in(std::uint64_t position, const void* data, std::size_t size) {
+            const std::size_t offset = position & (bytes.size() - 1);
+            const std::size_t first = std::min(size, bytes.size() - offset);
+            std::memcpy(bytes.data() + offset, data, first);
+            std::memcpy(bytes.data(), static_cast<const char*>(data) + first, size - first);
+        }
+
+        const Frame& frame(std::uint64_t number) const { return frames[number & (frames.size() - 1)]; }
+
+        std::string path;
+        ipc::StreamConfig config;
+        int epoll_fd;
+        int wake_fd;
+        int listen_fd = -1;
+        std::unordered_map<int, Client> clients;
+
+        // Общий буфер: кадры [oldest, next) действительны
+        std::vector<char> bytes;
+        std::vector<Frame> frames;
+        std::uint64_t oldest = 0;
+        std::uint64_t next = 0;
+        std::uint64_t write_position = 0;
+        bool wake_pending = false;
+
+        ipc::StreamStats stats;
+        std::vector<iovec> iov;
+    };
+
+    // Обработчик шины: одна сериализация на событие, затем ссылка в очереди клиентов
+    template<typename E>
+    void handle(const E& event) {
+        State& s = *state_;
+        if (s.clients.empty()) return;
+
+        constexpr std::uint16_t type = type_id<E>;
+        const ipc::Header header{
+            .size = sizeof(payload_t<E>),
+            .type = type,
+            .flags = ipc::flag_event,
+            .seq = static_cast<std::uint32_t>(s.stats.events)
+        };
+        const std::uint32_t size = sizeof(header) + sizeof(payload_t<E>);
+
+        // Вытеснение самых старых кадров, если не хватает места
+        while (s.next - s.oldest == s.frames.size()
+               || (s.next > s.oldest && s.write_position + size - s.frame(s.oldest).position > s.bytes.size())) {
+            ++s.oldest;
+        }
+        s.copy_in(s.write_position, &header, sizeof(header));
+        s.copy_in(s.write_position + sizeof(header), &event.payload, sizeof(payload_t<E>));
+        s.frames[s.next & (s.frames.size() - 1)] = Frame{s.write_position, size, type};
+        s.write_position += size;
+        const std::uint64_t number = s.next++;
+        ++s.stats.events;
+
+        std::vector<int> overflowed;
+        for (auto& [fd, client] : s.clients) {
+            if (!(client.mask & (1ull << type))) continue;
+            if (client.tail - client.head == s.config.client_capacity) {
+                if (s.config.policy == ipc::SlowConsumerPolicy::disconnect) {
+                    overflowed.push_back(fd);
+                    continue;
+                }
+                ++client.head;
+                ++s.stats.dropped;
+            }
+            client.queue[client.tail++ % client.queue.size()] = number;
+        }
+        for (int fd : overflowed) {
+            s.drop_client(fd);
+            ++s.stats.disconnected;
+        }
+
+        // Один системный вызов на итерацию главного цикла, а не на событие
+        if (!s.wake_pending) {
+            s.wake_pending = true;
+            const std::uint64_t one = 1;
+            while (write(s.wake_fd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+        }
+    }
+
+    void accept_clients() {
+        State& s = *state_;
+        while (true) {
+            const int fd = accept4(s.listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = fd;
+            if (epoll_ctl(s.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                close(fd);
+                continue;
+            }
+            Client client;
+            client.fd = fd;
+            client.queue.resize(s.config.client_capacity);
+            s.clients.emplace(fd, std::move(client));
+        }
+    }
+
+    // Кадры подписки от клиента; прочие кадры игнорируются
+    bool read_client(Client& client) {
+        char buffer[4096];
+        while (true) {
+            const ssize_t n = read(client.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                client.in.insert(client.in.end(), buffer, buffer + n);
+                continue;
+            }
+            if (n == 0) return false;
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+
+        std::size_t offset = 0;
+        while (client.in.size() - offset >= sizeof(ipc::Header)) {
+            ipc::Header header;
+            std::memcpy(&header, client.in.data() + offset, sizeof(header));
+            if (header.size > ipc::max_payload_size) return false;
+            if (client.in.size() - offset - sizeof(header) < header.size) break;
+            if (header.type == ipc::subscribe_type && header.size == sizeof(std::uint64_t)) {
+                std::memcpy(&client.mask, client.in.data() + offset + sizeof(header), sizeof(client.mask));
+                client.mask &= all_events;
+            }
+            offset += sizeof(header) + header.size;
+        }
+        client.in.erase(client.in.begin(), client.in.begin() + static_cast<std::ptrdiff_t>(offset));
+        return true;
+    }
+
+    // Неблокирующая отправка очереди клиента одним sendmsg(); EPIPE - false
+    bool send_frames(Client& client) {
+        State& s = *state_;
+
+        // Кадры, вытесненные из общего буфера, для клиента потеряны
+        if (client.head < client.tail && client.queue[client.head % client.queue.size()] < s.oldest) {
+            while (client.head < client.tail && client.queue[client.head % client.queue.size()] < s.oldest) {
+                ++client.head;
+                ++s.stats.dropped;
+            }
+        }
+        if (client.carry_offset == client.carry.size() && client.head == client.tail) {
+            return watch_writable(client, false);
+        }
+
+        std::vector<iovec>& iov = s.iov;
+        iov.clear();
+        if (client.carry_offset < client.carry.size()) {
+            iov.push_back({client.carry.data() + client.carry_offset, client.carry.size() - client.carry_offset});
+        }
+        std::uint64_t contiguous_end = UINT64_MAX; // Конец предыдущего кадра в байтовом кольце
+        for (std::uint64_t i = client.head; i < client.tail && iov.size() + 2 <= IOV_MAX; ++i) {
+            const Frame& frame = s.frame(client.queue[i % client.queue.size()]);
+            const std::size_t offset = frame.position & (s.bytes.size() - 1);
+            const std::size_t first = std::min<std::size_t>(frame.size, s.bytes.size() - offset);
+            if (frame.position == contiguous_end && offset != 0) {
+                iov.back().iov_len += first; // Соседний кадр - продолжение того же вектора
+            } else {
+                iov.push_back({s.bytes.data() + offset, first});
+            }
+            if (first < frame.size) iov.push_back({s.bytes.data(), frame.size - first});
+            contiguous_end = frame.position + frame.size;
+        }
+
+        ssize_t written;
+        do {
+            msghdr message{};
+            message.msg_iov = iov.data();
+            message.msg_iovlen = iov.size();
+            written = sendmsg(client.fd, &message, MSG_NOSIGNAL);
+        } while (written < 0 && errno == EINTR);
+        if (written < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            written = 0;
+        }
+        ++s.stats.send_calls;
+        s.stats.bytes_sent += static_cast<std::size_t>(written);
+
+        // Учет записанного: сначала хвост прошлого кадра, затем кадры очереди
+        std::size_t left = static_cast<std::size_t>(written);
+        const std::size_t carried = std::min(left, client.carry.size() - client.carry_offset);
+        client.carry_offset += carried;
+        left -= carried;
+        if (client.carry_offset == client.carry.size()) {
+            client.carry.clear();
+            client.carry_offset = 0;
+        }
+        while (client.head < client.tail) {
+            const std::uint64_t number = client.queue[client.head % client.queue.size()];
+            const Frame& frame = s.frame(number);
+            if (left < frame.size) {
+                if (left > 0) {
+                    // Частично записанный кадр: хвост копируется клиенту
+                    client.carry.resize(frame.size - left);
+                    copy_out(frame.position + left, client.carry.data(), client.carry.size());
+                    ++client.head;
+                    ++s.stats.frames_sent;
+                }
+                break;
+            }
+            left -= frame.size;
+            ++client.head;
+            ++s.stats.frames_sent;
+        }
+
+        const bool pending = client.carry_offset < client.carry.size() || client.head < client.tail;
+        return watch_writable(client, pending);
+    }
+
+    void copy_out(std::uint64_t position, char* out, std::size_t size) const {
+        const State& s = *state_;
+        const std::size_t offset = position & (s.bytes.size() - 1);
+        const std::size_t first = std::min(size, s.bytes.size() - offset);
+        std::memcpy(out, s.bytes.data() + offset, first);
+        std::memcpy(out + first, s.bytes.data(), size - first);
+    }
+
+    // EPOLLOUT нужен, только пока у клиента есть неотправленные данные
+    bool watch_writable(Client& client, bool enable) {
+        if (client.writable_watched == enable) return true;
+        client.writable_watched = enable;
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | (enable ? EPOLLOUT : 0u);
+        ev.data.fd = client.fd;
+        return epoll_ctl(state_->epoll_fd, EPOLL_CTL_MOD, client.fd, &ev) == 0;
+    }
+
+    std::shared_ptr<State> state_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// EVENT STREAM CLIENT
+////////////////////////////////////////////////////////////////////////////////
+
+// Блокирующий клиент потока EventStreamModule
+//
+// Пример использования:
+//   EventStreamClient<FocusChangedEvent, KeyPressEvent> client;
+//   client.connect(ipc::default_stream_path());
+//   client.subscribe<FocusChangedEvent>();
+//   while (client.receive([](const auto& event) { ... })) {}
+template<typename... Events>
+requires (ipc::StreamEvent<Events> && ...)
+class EventStreamClient {
+public:
+    EventStreamClient() = default;
+    EventStreamClient(const EventStreamClient&) = delete;
+    EventStreamClient& operator=(const EventStreamClient&) = delete;
+
+    ~EventStreamClient() {
+        disconnect();
+    }
+
+    bool connect(const std::string& path) {
+        disconnect();
+        sockaddr_un addr;
+        if (!ipc::fill_address(addr, path)) return false;
+        fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) return false;
+        if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            disconnect();
+            return false;
+        }
+        return true;
+    }
+
+    void disconnect() {
+        if (fd_ >= 0) close(fd_);
+        fd_ = -1;
+        begin_ = 0;
+        end_ = 0;
+    }
+
+    bool connected() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+
+    // Выбор событий потока
+    template<typename... Selected>
+    requires ((ipc::type_id<Selected, Events...>() != UINT16_MAX) && ...)
+    bool subscribe() {
+        const std::uint64_t mask = ((1ull << ipc::type_id<Selected, Events...>()) | ... | 0ull);
+        const ipc::Header header{.size = sizeof(mask), .type = ipc::subscribe_type, .flags = 0, .seq = 0};
+        char frame[sizeof(header) + sizeof(mask)];
+        std::memcpy(frame, &header, sizeof(header));
+        std::memcpy(frame + sizeof(header), &mask, sizeof(mask));
+        return write(fd_, frame, sizeof(frame)) == static_cast<ssize_t>(sizeof(frame));
+    }
+
+    // Чтение следующего кадра и вызов visitor(event) для его типа
+    // Возвращает false при разрыве соединения; seq() - номер события
+    // (пропуск номеров - отброшенные сервером кадры)
+    template<typename Visitor>
+    bool receive(Visitor&& visitor) {
+        ipc::Header header;
+        if (!fill(sizeof(header))) return false;
+        std::memcpy(&header, buffer_.data() + begin_, sizeof(header));
+        if (header.size > ipc::max_payload_size || !fill(sizeof(header) + header.size)) return false;
+        const char* body = buffer_.data() + begin_ + sizeof(header);
+        begin_ += sizeof(header) + header.size;
+        seq_ = header.seq;
+        visit(header, body, visitor, std::index_sequence_for<Events...>{});
+        return true;
+    }
+
+    // Есть ли в буфере полностью прочитанный кадр (receive() не заблокируется)
+    bool buffered() const {
+        if (end_ - begin_ < sizeof(ipc::Header)) return false;
+        ipc::Header header;
+        std::memcpy(&header, buffer_.data() + begin_, sizeof(header));
+        return end_ - begin_ >= sizeof(header) + header.size;
+    }
+
+    std::uint32_t seq() const { return seq_; }
+
+private:
+    template<typename Visitor, std::size_t... Indices>
+    void visit(const ipc::Header& header, const char* body, Visitor& visitor, std::index_sequence<Indices...>) {
+        ((Indices == header.type ? (visit_at<Indices>(header, body, visitor), true) : false) || ...);
+    }
+
+    template<std::size_t Index, typename Visitor>
+    void visit_at(const ipc::Header& header, const char* body, Visitor& visitor) {
+        using E = std::tuple_element_t<Index, std::tuple<Events...>>;
+        if (header.size != sizeof(payload_t<E>)) return;
+        E event{};
+        if constexpr (!std::is_empty_v<payload_t<E>>) {
+            std::memcpy(&event.payload, body, sizeof(payload_t<E>));
+        }
+        visitor(event);
+    }
+
+    // Дочитать сокет, пока в буфере не будет хотя бы need байт
+    bool fill(std::size_t need) {
+        if (end_ - begin_ >= need) return true;
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+        if (buffer_.size() < need) buffer_.resize(need);
+
+        while (end_ < need) {
+            const ssize_t n = read(fd_, buffer_.data() + end_, buffer_.size() - end_);
+            if (n == 0) return false;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            end_ += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    int fd_ = -1;
+    std::uint32_t seq_ = 0;
+    std::vector<char> buffer_ = std::vector<char>(64 * 1024);
+    std::size_t begin_ = 0;
+    std::size_t end_ = 0;
+};
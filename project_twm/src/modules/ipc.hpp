@@ -0,0 +1,600 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <core/module.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// IPC MODULE - Командный канал через Unix domain socket
+////////////////////////////////////////////////////////////////////////////////
+//
+// Позволяет скриптам и статус-барам отправлять в шину команды и запросы.
+// Список доступных сообщений задается параметрами шаблона, идентификатор
+// типа на проводе - индекс сообщения в этом списке.
+//
+// Протокол (little-endian, без выравнивания между кадрами):
+//   ipc::Header { size, type, flags, seq } + size байт payload
+// Payload - побайтовая копия payload_type сообщения (должен быть trivially
+// copyable), ответ - побайтовая копия response_type запроса.
+// Клиент может отправить много кадров одной записью; ответы на все
+// прочитанные кадры отправляются одним sendmsg(). Запись идет с MSG_NOSIGNAL:
+// клиент, закрывший сокет, не читая ответов, дает EPIPE и отключается, а не
+// SIGPIPE, завершающий композитор.
+// Пока у клиента есть неотправленные ответы, его кадры не читаются и не
+// обрабатываются (запись клиента упирается в буфер сокета), поэтому очередь
+// ответов клиента не больше ipc::max_buffered_size и одного ответа. Клиент,
+// закрывший свою сторону (shutdown(SHUT_WR)), остается до отправки всех
+// ответов.
+//
+// Пример использования:
+//   using Ipc = IpcModule<SetNumCommand, GetNumRequest>;
+//   auto compositor = Compositor<KeyboardModule, Ipc>{keyboard, Ipc{}};
+//   compositor.module<Ipc>().set_dispatcher([&compositor](const auto& msg) {
+//       return compositor.dispatch(msg);
+//   });
+//   compositor.initialize();
+//   CompositorRunner runner(compositor);  // epoll fd модуля попадает в poll()
+//   runner.run();
+//
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ipc {
+    // Кадр без ответа (только для команд)
+    inline constexpr std::uint16_t flag_no_reply = 1u << 0;
+    // Кадр - ответ сервера
+    inline constexpr std::uint16_t flag_reply = 1u << 1;
+    // Ответ-ошибка: неизвестный тип, неверный размер или нет обработчика
+    inline constexpr std::uint16_t flag_error = 1u << 2;
+
+    inline constexpr std::uint32_t max_payload_size = 64u * 1024u;
+    // Предел входящих байт за одно чтение и ответов одной пачки
+    inline constexpr std::size_t max_buffered_size = 1u << 20;
+
+    struct Header {
+        std::uint32_t size;   // Размер payload в байтах
+        std::uint16_t type;   // Индекс типа сообщения в списке IpcModule
+        std::uint16_t flags;
+        std::uint32_t seq;    // Номер кадра клиента, копируется в ответ
+    };
+    static_assert(sizeof(Header) == 12 && std::is_trivially_copyable_v<Header>);
+
+    // Сообщение, которое можно передать по сокету без сериализации
+    template<typename M>
+    concept WireMessage = (Command<M> || Request<M>)
+                       && std::is_trivially_copyable_v<payload_t<M>>
+                       && (std::is_void_v<response_t<M>> || std::is_trivially_copyable_v<response_t<M>>);
+
+    // Идентификатор типа M в списке Messages...
+    template<typename M, typename... Messages>
+    constexpr std::uint16_t type_id() {
+        std::uint16_t index = 0, result = UINT16_MAX;
+        ((std::is_same_v<M, Messages> ? (result = index, ++index) : ++index), ...);
+        return result;
+    }
+
+    // $XDG_RUNTIME_DIR/twm.sock или /tmp/twm-<uid>.sock
+    inline std::string default_socket_path() {
+        if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime) {
+            return std::string(runtime) + "/twm.sock";
+        }
+        return "/tmp/twm-" + std::to_string(getuid()) + ".sock";
+    }
+
+    inline bool fill_address(sockaddr_un& addr, const std::string& path) {
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+}
+
+template<typename... Messages>
+requires (ipc::WireMessage<Messages> && ...)
+class IpcModule : public ModuleBase<IpcModule<Messages...>> {
+public:
+    explicit IpcModule(std::string socket_path = ipc::default_socket_path())
+        : state_(std::make_shared<State>(std::move(socket_path)))
+    {}
+
+    // Создание слушающего сокета
+    // Сокет остается неактивным, если путь занят или недоступен
+    void initialize() {
+        State& s = *state_;
+        if (s.listen_fd >= 0 || s.epoll_fd < 0) return;
+
+        sockaddr_un addr;
+        if (!ipc::fill_address(addr, s.path)) return;
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return;
+
+        unlink(s.path.c_str()); // Сокет от предыдущего запуска
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+            close(fd);
+            return;
+        }
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(s.epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+        s.listen_fd = fd;
+    }
+
+    void cleanup() {
+        state_->close_all();
+    }
+
+    // epoll fd готов к чтению, когда есть новые клиенты или данные от них
+    int event_fd() const {
+        return state_->epoll_fd;
+    }
+
+    bool handle_event() {
+        State& s = *state_;
+        epoll_event events[64];
+        int count = epoll_wait(s.epoll_fd, events, 64, 0);
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == s.listen_fd) {
+                accept_clients();
+                continue;
+            }
+            auto it = s.clients.find(fd);
+            if (it == s.clients.end()) continue;
+
+            bool alive = !(events[i].events & (EPOLLERR | EPOLLHUP)) || (events[i].events & EPOLLIN);
+            if (alive && (events[i].events & EPOLLOUT)) alive = flush_pending(it->second);
+            if (alive && (events[i].events & EPOLLIN)) alive = read_client(it->second);
+            if (!alive) s.drop_client(fd);
+        }
+        return true;
+    }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+
+    // Установка функции отправки сообщений в шину
+    // Функция должна принимать любое сообщение из Messages... (обобщенная лямбда)
+    template<typename DispatchFunc>
+    void set_dispatcher(DispatchFunc&& dispatch_func) {
+        auto shared = std::make_shared<std::decay_t<DispatchFunc>>(std::forward<DispatchFunc>(dispatch_func));
+        ((std::get<handler_t<Messages>>(state_->handlers) = [shared](const Messages& msg) -> response_t<Messages> {
+            return (*shared)(msg);
+        }), ...);
+    }
+
+    template<typename M>
+    static constexpr std::uint16_t type_id = ipc::type_id<M, Messages...>();
+
+    const std::string& socket_path() const { return state_->path; }
+    std::size_t client_count() const { return state_->clients.size(); }
+
+private:
+    template<typename M>
+    using handler_t = std::function<response_t<M>(const M&)>;
+
+    struct Client {
+        int fd;
+        std::vector<char> in;        // Непрочитанный хвост входящих кадров
+        std::vector<char> pending;   // Ответы, не поместившиеся в сокет
+        std::size_t pending_offset = 0;
+        bool read_closed = false;    // Клиент закрыл запись, ждет ответы
+    };
+
+    // Ответы на пачку кадров: заголовки и тела хранятся отдельно
+    // и отправляются одним sendmsg()
+    struct ReplyBatch {
+        std::vector<ipc::Header> headers;
+        std::vector<char> bodies;
+        std::vector<std::pair<std::size_t, std::size_t>> body_ranges; // offset, size
+
+        void clear() {
+            headers.clear();
+            bodies.clear();
+            body_ranges.clear();
+        }
+    };
+
+    // Состояние общее для всех копий модуля (Compositor хранит копию)
+    struct State {
+        explicit State(std::string socket_path)
+            : path(std::move(socket_path))
+            , epoll_fd(epoll_create1(EPOLL_CLOEXEC))
+        {}
+
+        ~State() {
+            close_all();
+            if (epoll_fd >= 0) close(epoll_fd);
+        }
+
+        void drop_client(int fd) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+            clients.erase(fd);
+        }
+
+        void close_all() {
+            while (!clients.empty()) drop_client(clients.begin()->first);
+            if (listen_fd >= 0) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, listen_fd, nullptr);
+                close(listen_fd);
+                unlink(path.c_str());
+                listen_fd = -1;
+            }
+        }
+
+        std::string path;
+        int epoll_fd;
+        int listen_fd = -1;
+        std::unordered_map<int, Client> clients;
+        std::tuple<handler_t<Messages>...> handlers;
+        ReplyBatch batch;
+        std::vector<char> scratch = std::vector<char>(64 * 1024);
+    };
+
+    void accept_clients() {
+        State& s = *state_;
+        while (true) {
+            int fd = accept4(s.listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = fd;
+            if (epoll_ctl(s.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                close(fd);
+                continue;
+            }
+            s.clients.emplace(fd, Client{.fd = fd, .in = {}, .pending = {}});
+        }
+    }
+
+    // Чтение всех доступных данных и обработка всех полных кадров
+    bool read_client(Client& client) {
+        std::vector<char>& scratch = state_->scratch;
+        bool eof = false;
+        while (client.in.size() < ipc::max_buffered_size) {
+            ssize_t n = read(client.fd, scratch.data(), scratch.size());
+            if (n > 0) {
+                client.in.insert(client.in.end(), scratch.data(), scratch.data() + n);
+                continue;
+            }
+            if (n == 0) eof = true;
+            else if (errno == EINTR) continue;
+            else if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+
+        if (eof) client.read_closed = true;
+        return process_input(client);
+    }
+
+    // Обработка полных кадров из client.in пачками: ответы одной пачки - не
+    // больше ipc::max_buffered_size. Если пачка не ушла в сокет целиком,
+    // остальные кадры ждут, пока flush_pending не отправит остаток
+    bool process_input(Client& client) {
+        ReplyBatch& batch = state_->batch;
+        std::size_t offset = 0;
+        bool more = true;
+        while (more && client.pending.empty()) {
+            batch.clear();
+            more = false;
+            while (client.in.size() - offset >= sizeof(ipc::Header)) {
+                ipc::Header header;
+                std::memcpy(&header, client.in.data() + offset, sizeof(header));
+                if (header.size > ipc::max_payload_size) return false;
+                if (client.in.size() - offset - sizeof(header) < header.size) break;
+
+                process_frame(header, client.in.data() + offset + sizeof(header), batch);
+                offset += sizeof(header) + header.size;
+                if (batch.headers.size() * sizeof(ipc::Header) + batch.bodies.size() >= ipc::max_buffered_size) {
+                    more = true;
+                    break;
+                }
+            }
+            if (!send_batch(client, batch)) return false;
+        }
+        client.in.erase(client.in.begin(), client.in.begin() + offset);
+
+        // Клиент закрыл запись: отключается, когда обработаны все кадры и
+        // ушли все ответы
+        return !client.read_closed || !client.pending.empty();
+    }
+
+    void process_frame(const ipc::Header& header, const char* payload, ReplyBatch& batch) {
+        ipc::Header reply{.size = 0, .type = header.type, .flags = ipc::flag_reply, .seq = header.seq};
+        const std::size_t body_offset = batch.bodies.size();
+
+        bool ok = dispatch_frame(header, payload, batch.bodies, std::index_sequence_for<Messages...>{});
+        if (!ok) {
+            batch.bodies.resize(body_offset);
+            reply.flags |= ipc::flag_error;
+        } else if (header.flags & ipc::flag_no_reply) {
+            return;
+        }
+
+        reply.size = static_cast<std::uint32_t>(batch.bodies.size() - body_offset);
+        batch.headers.push_back(reply);
+        batch.body_ranges.emplace_back(body_offset, reply.size);
+    }
+
+    // Поиск обработчика по индексу типа (аналогично CompositorRunner::handle_module_event_impl)
+    template<std::size_t... Indices>
+    bool dispatch_frame(const ipc::Header& header, const char* payload, std::vector<char>& out,
+                        std::index_sequence<Indices...>) {
+        bool result = false;
+        ((Indices == header.type ?
+            (result = dispatch_at<Indices>(header, payload, out), true) : false) || ...);
+        return result;
+    }
+
+    template<std::size_t Index>
+    bool dispatch_at(const ipc::Header& header, const char* payload, std::vector<char>& out) {
+        using M = std::tuple_element_t<Index, std::tuple<Messages...>>;
+        using R = response_t<M>;
+
+        if (header.size != sizeof(payload_t<M>)) return false;
+        auto& handler = std::get<Index>(state_->handlers);
+        if (!handler) return false;
+
+        M message{};
+        if constexpr (!std::is_empty_v<payload_t<M>>) {
+            std::memcpy(&message.payload, payload, sizeof(payload_t<M>));
+        }
+
+        if constexpr (std::is_void_v<R>) {
+            handler(message);
+        } else {
+            const R response = handler(message);
+            const std::size_t offset = out.size();
+            out.resize(offset + sizeof(R));
+            std::memcpy(out.data() + offset, &response, sizeof(R));
+        }
+        return true;
+    }
+
+    // Отправка пачки ответов одним sendmsg(); остаток откладывается до EPOLLOUT
+    // EPIPE (клиент закрыл сокет) - false, клиент отключается
+    bool send_batch(Client& client, const ReplyBatch& batch) {
+        if (batch.headers.empty()) return true;
+
+        std::vector<iovec> iov;
+        iov.reserve(batch.headers.size() * 2);
+        for (std::size_t i = 0; i < batch.headers.size(); ++i) {
+            iov.push_back({const_cast<ipc::Header*>(&batch.headers[i]), sizeof(ipc::Header)});
+            if (const auto [offset, size] = batch.body_ranges[i]; size > 0) {
+                iov.push_back({const_cast<char*>(batch.bodies.data() + offset), size});
+            }
+        }
+
+        std::size_t first = 0;
+        if (client.pending.empty()) {
+            while (first < iov.size()) {
+                const int chunk = static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX));
+                msghdr message{};
+                message.msg_iov = iov.data() + first;
+                message.msg_iovlen = static_cast<std::size_t>(chunk);
+                ssize_t n = sendmsg(client.fd, &message, MSG_NOSIGNAL);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    return false;
+                }
+                // Пропуск полностью записанных векторов, сдвиг частично записанного
+                std::size_t left = static_cast<std::size_t>(n);
+                while (first < iov.size() && left >= iov[first].iov_len) left -= iov[first++].iov_len;
+                if (left > 0) {
+                    iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+                    iov[first].iov_len -= left;
+                    break; // Сокет заполнен
+                }
+            }
+        }
+
+        if (first == iov.size()) return true;
+
+        // Копирование неотправленного остатка
+        for (; first < iov.size(); ++first) {
+            const char* base = static_cast<const char*>(iov[first].iov_base);
+            client.pending.insert(client.pending.end(), base, base + iov[first].iov_len);
+        }
+        return watch_writable(client, true);
+    }
+
+    bool flush_pending(Client& client) {
+        while (client.pending_offset < client.pending.size()) {
+            ssize_t n = ::send(client.fd, client.pending.data() + client.pending_offset,
+                             client.pending.size() - client.pending_offset, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            client.pending_offset += static_cast<std::size_t>(n);
+        }
+        client.pending.clear();
+        client.pending_offset = 0;
+        return watch_writable(client, false) && process_input(client);
+    }
+
+    // Пока есть неотправленные ответы - только EPOLLOUT: новые кадры не
+    // читаются, а EPOLLRDHUP полузакрытого клиента не будит цикл впустую
+    bool watch_writable(Client& client, bool enable) {
+        epoll_event ev{};
+        ev.events = enable ? EPOLLOUT : EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = client.fd;
+        return epoll_ctl(state_->epoll_fd, EPOLL_CTL_MOD, client.fd, &ev) == 0;
+    }
+
+    std::shared_ptr<State> state_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// IPC CLIENT
+////////////////////////////////////////////////////////////////////////////////
+
+// Блокирующий клиент протокола IpcModule
+// Сообщения можно накапливать через send() и отправлять одной записью через flush()
+//
+// Пример использования:
+//   IpcClient<SetNumCommand, GetNumRequest> client;
+//   client.connect(ipc::default_socket_path());
+//   client.call(make_command<NumContainingPayload>({42}));
+//   int num = client.call(make_request<GetNumPayload, int>({}));
+template<typename... Messages>
+requires (ipc::WireMessage<Messages> && ...)
+class IpcClient {
+public:
+    IpcClient() = default;
+    IpcClient(const IpcClient&) = delete;
+    IpcClient& operator=(const IpcClient&) = delete;
+
+    ~IpcClient() {
+        disconnect();
+    }
+
+    bool connect(const std::string& path) {
+        disconnect();
+        sockaddr_un addr;
+        if (!ipc::fill_address(addr, path)) return false;
+        fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) return false;
+        if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            disconnect();
+            return false;
+        }
+        return true;
+    }
+
+    void disconnect() {
+        if (fd_ >= 0) close(fd_);
+        fd_ = -1;
+        out_.clear();
+        in_begin_ = 0;
+        in_end_ = 0;
+    }
+
+    bool connected() const { return fd_ >= 0; }
+
+    // Добавление кадра в буфер отправки; возвращает номер кадра
+    template<typename M>
+    requires (std::is_same_v<M, Messages> || ...)
+    std::uint32_t send(const M& message, std::uint16_t flags = 0) {
+        const ipc::Header header{
+            .size = sizeof(payload_t<M>),
+            .type = ipc::type_id<M, Messages...>(),
+            .flags = flags,
+            .seq = next_seq_++
+        };
+        const std::size_t offset = out_.size();
+        out_.resize(offset + sizeof(header) + sizeof(payload_t<M>));
+        std::memcpy(out_.data() + offset, &header, sizeof(header));
+        if constexpr (std::is_empty_v<payload_t<M>>) {
+            out_[offset + sizeof(header)] = 0;
+        } else {
+            std::memcpy(out_.data() + offset + sizeof(header), &message.payload, sizeof(payload_t<M>));
+        }
+        return header.seq;
+    }
+
+    // Отправка всех накопленных кадров
+    bool flush() {
+        std::size_t done = 0;
+        while (done < out_.size()) {
+            ssize_t n = ::send(fd_, out_.data() + done, out_.size() - done, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        out_.clear();
+        return true;
+    }
+
+    // Чтение следующего ответа; body указывает во внутренний буфер
+    // и действителен до следующего вызова
+    bool receive(ipc::Header& header, const char*& body) {
+        if (!fill(sizeof(ipc::Header))) return false;
+        std::memcpy(&header, in_.data() + in_begin_, sizeof(header));
+        if (header.size > ipc::max_payload_size || !fill(sizeof(header) + header.size)) return false;
+        body = in_.data() + in_begin_ + sizeof(header);
+        in_begin_ += sizeof(header) + header.size;
+        return true;
+    }
+
+    template<Command C>
+    requires (std::is_same_v<C, Messages> || ...)
+    bool call(const C& command) {
+        send(command);
+        ipc::Header header;
+        const char* body;
+        return flush() && receive(header, body) && !(header.flags & ipc::flag_error);
+    }
+
+    template<Request R>
+    requires (std::is_same_v<R, Messages> || ...)
+    response_t<R> call(const R& request) {
+        send(request);
+        ipc::Header header;
+        const char* body;
+        response_t<R> response{};
+        if (flush() && receive(header, body) && !(header.flags & ipc::flag_error)
+            && header.size == sizeof(response)) {
+            std::memcpy(&response, body, sizeof(response));
+        }
+        return response;
+    }
+
+private:
+    // Дочитать сокет, пока в буфере не будет хотя бы need байт
+    bool fill(std::size_t need) {
+        if (in_end_ - in_begin_ >= need) return true;
+
+        // Перенос непрочитанного хвоста в начало буфера
+        std::memmove(in_.data(), in_.data() + in_begin_, in_end_ - in_begin_);
+        in_end_ -= in_begin_;
+        in_begin_ = 0;
+        if (in_.size() < need) in_.resize(need);
+
+        while (in_end_ < need) {
+            ssize_t n = read(fd_, in_.data() + in_end_, in_.size() - in_end_);
+            if (n == 0) return false;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            in_end_ += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    int fd_ = -1;
+    std::uint32_t next_seq_ = 0;
+    std::vector<char> out_;
+    std::vector<char> in_ = std::vector<char>(64 * 1024);
+    std::size_t in_begin_ = 0;
+    std::size_t in_end_ = 0;
+};
@@ -0,0 +1,427 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <core/module.hpp>
+#include <modules/window_events.hpp>
+#include <X11/Xlib.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// POINTER MODULE - Модуль обработки мыши с Xlib
+////////////////////////////////////////////////////////////////////////////////
+//
+// - Подряд идущие MotionNotify сжимаются до последней позиции: за итерацию
+//   главного цикла публикуется не более одного PointerMotionEvent
+// - Mod4+Button1 - перемещение окна, Mod4+Button3 - изменение размера;
+//   геометрия окна применяется не чаще раза за кадр (frame_interval),
+//   отложенная геометрия применяется по таймеру (timerfd)
+// - После применения геометрии публикуется WindowConfigureEvent
+//
+// Модулю нужно собственное соединение с X сервером: KeyboardModule
+// забирает все события своего соединения.
+//
+// Пример использования:
+//   Display* pointer_display = XOpenDisplay(nullptr);
+//   auto compositor = Compositor<KeyboardModule, PointerModule>{
+//       keyboard, PointerModule(pointer_display)};
+//   compositor.module<PointerModule>().set_publisher([&compositor](const auto& e) {
+//       compositor.publish(e);
+//   });
+//   compositor.initialize();
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Позиция указателя (корневые координаты) после сжатия движений
+struct PointerMotionPayload {
+    int x, y;
+    unsigned int state;      // Модификаторы и зажатые кнопки
+    Time timestamp;
+    std::uint32_t merged;    // Сколько MotionNotify объединено в событие
+};
+
+struct PointerPressPayload {
+    unsigned int button;
+    unsigned int state;
+    Window window;           // Окно под указателем (None - корневое)
+    int x, y;
+    Time timestamp;
+};
+
+struct PointerReleasePayload {
+    unsigned int button;
+    unsigned int state;
+    Window window;
+    int x, y;
+    Time timestamp;
+};
+
+using PointerMotionEvent = event<PointerMotionPayload>;
+using PointerPressEvent = event<PointerPressPayload>;
+using PointerReleaseEvent = event<PointerReleasePayload>;
+
+////////////////////////////////////////////////////////////////////////////////
+// ВСПОМОГАТЕЛЬНЫЕ КЛАССЫ (без обращений к X серверу)
+////////////////////////////////////////////////////////////////////////////////
+
+namespace pointer_utils {
+    using clock = std::chrono::steady_clock;
+
+    // Сжатие подряд идущих движений до последней позиции
+    class MotionCompressor {
+    public:
+        void add(int x, int y, unsigned int state, Time timestamp) {
+            const std::uint32_t merged = latest_ ? latest_->merged + 1 : 1;
+            latest_ = PointerMotionPayload{x, y, state, timestamp, merged};
+        }
+
+        // Накопленное движение (сбрасывает накопление)
+        std::optional<PointerMotionPayload> take() {
+            return std::exchange(latest_, std::nullopt);
+        }
+
+        bool pending() const { return latest_.has_value(); }
+
+    private:
+        std::optional<PointerMotionPayload> latest_;
+    };
+
+    enum class DragMode : std::uint8_t {
+        move,
+        resize
+    };
+
+    struct DragGeometry {
+        Window window;
+        int x, y;
+        unsigned int width, height;
+    };
+
+    // Интерактивное перемещение/изменение размера окна
+    // motion() только запоминает цель; frame() отдает геометрию
+    // не чаще раза за frame_interval, end() - последнюю непримененную
+    class DragController {
+    public:
+        explicit DragController(clock::duration frame_interval)
+            : frame_interval_(frame_interval) {}
+
+        void begin(DragMode mode, int pointer_x, int pointer_y, const DragGeometry& start, clock::time_point now) {
+            mode_ = mode;
+            start_ = start;
+            target_ = start;
+            pointer_x_ = pointer_x;
+            pointer_y_ = pointer_y;
+            active_ = true;
+            pending_ = false;
+            last_frame_ = now - frame_interval_; // Первый кадр - без ожидания
+        }
+
+        void motion(int pointer_x, int pointer_y) {
+            if (!active_) return;
+            const int dx = pointer_x - pointer_x_;
+            const int dy = pointer_y - pointer_y_;
+            if (mode_ == DragMode::move) {
+                target_.x = start_.x + dx;
+                target_.y = start_.y + dy;
+            } else {
+                target_.width = static_cast<unsigned int>(std::max(1, static_cast<int>(start_.width) + dx));
+                target_.height = static_cast<unsigned int>(std::max(1, static_cast<int>(start_.height) + dy));
+            }
+            pending_ = !same_geometry(target_, applied());
+        }
+
+        std::optional<DragGeometry> frame(clock::time_point now) {
+            if (!pending_ || now < next_frame()) return std::nullopt;
+            last_frame_ = now;
+            return apply();
+        }
+
+        std::optional<DragGeometry> end() {
+            if (!active_) return std::nullopt;
+            active_ = false;
+            if (!pending_) return std::nullopt;
+            return apply();
+        }
+
+        bool active() const { return active_; }
+        bool pending() const { return pending_; }
+        DragMode mode() const { return mode_; }
+        clock::time_point next_frame() const { return last_frame_ + frame_interval_; }
+
+    private:
+        static bool same_geometry(const DragGeometry& a, const DragGeometry& b) {
+            return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+        }
+
+        const DragGeometry& applied() const { return applied_ ? *applied_ : start_; }
+
+        DragGeometry apply() {
+            pending_ = false;
+            applied_ = target_;
+            return target_;
+        }
+
+        clock::duration frame_interval_;
+        clock::time_point last_frame_{};
+        DragMode mode_ = DragMode::move;
+        DragGeometry start_{};
+        DragGeometry target_{};
+        std::optional<DragGeometry> applied_;
+        int pointer_x_ = 0;
+        int pointer_y_ = 0;
+        bool active_ = false;
+        bool pending_ = false;
+    };
+}
+
+struct PointerConfig {
+    std::chrono::steady_clock::duration frame_interval = std::chrono::microseconds(16667); // 60 Гц
+    unsigned int drag_modifier = Mod4Mask;
+    unsigned int move_button = Button1;
+    unsigned int resize_button = Button3;
+};
+
+// Счетчики для диагностики и бенчмарков
+struct PointerStats {
+    std::size_t motion_events = 0;     // Получено MotionNotify
+    std::size_t motion_published = 0;  // Опубликовано PointerMotionEvent
+    std::size_t geometry_requests = 0; // XMoveWindow/XResizeWindow
+};
+
+class PointerModule : public ModuleBase<PointerModule> {
+public:
+    explicit PointerModule(Display* display, PointerConfig config = {})
+        : state_(std::make_shared<State>(display, config))
+    {}
+
+    void initialize() {
+        State& s = *state_;
+        if (!s.display || s.grabbed) return;
+        s.grabbed = true;
+
+        const Window root = DefaultRootWindow(s.display);
+        XSelectInput(s.display, root, PointerMotionMask | ButtonPressMask | ButtonReleaseMask);
+        for (unsigned int button : {s.config.move_button, s.config.resize_button}) {
+            XGrabButton(s.display, button, s.config.drag_modifier, root, False,
+                        ButtonPressMask | ButtonReleaseMask | PointerMotionMask,
+                        GrabModeAsync, GrabModeAsync, None, None);
+        }
+        XSync(s.display, False);
+    }
+
+    void cleanup() {
+        State& s = *state_;
+        if (!s.grabbed) return;
+        s.grabbed = false;
+        finish_drag(s);
+        const Window root = DefaultRootWindow(s.display);
+        for (unsigned int button : {s.config.move_button, s.config.resize_button}) {
+            XUngrabButton(s.display, button, s.config.drag_modifier, root);
+        }
+        XSync(s.display, False);
+    }
+
+    int event_fd() const {
+        return state_->epoll_fd;
+    }
+
+    // Разбор всех накопленных событий X, затем одно сжатое движение
+    // и не более одного кадра перетаскивания
+    bool handle_event() {
+        State& s = *state_;
+        if (!s.display) return false;
+
+        std::uint64_t expirations;
+        while (read(s.timer_fd, &expirations, sizeof(expirations)) > 0) {}
+
+        XEvent xevent;
+        while (XPending(s.display) > 0) {
+            XNextEvent(s.display, &xevent);
+            switch (xevent.type) {
+                case MotionNotify:
+                    ++s.stats.motion_events;
+                    s.motion.add(xevent.xmotion.x_root, xevent.xmotion.y_root,
+                                 xevent.xmotion.state, xevent.xmotion.time);
+                    s.drag.motion(xevent.xmotion.x_root, xevent.xmotion.y_root);
+                    break;
+                case ButtonPress:
+                    // Движение до нажатия публикуется раньше нажатия
+                    flush_motion(s);
+                    process_button_press(s, xevent.xbutton);
+                    break;
+                case ButtonRelease:
+                    flush_motion(s);
+                    process_button_release(s, xevent.xbutton);
+                    break;
+            }
+        }
+
+        flush_motion(s);
+        if (auto geometry = s.drag.frame(pointer_utils::clock::now())) {
+            apply_geometry(s, *geometry);
+        }
+        if (s.drag.pending()) {
+            arm_timer(s, s.drag.next_frame());
+        }
+        XFlush(s.display);
+        return true;
+    }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+
+    // Установка функции публикации для всех событий модуля
+    // (обобщенная лямбда: [&](const auto& e) { compositor.publish(e); })
+    template<typename PublishFunc>
+    void set_publisher(PublishFunc&& publish_func) {
+        State& s = *state_;
+        s.publish_motion = publish_func;
+        s.publish_press = publish_func;
+        s.publish_release = publish_func;
+        s.publish_configure = std::forward<PublishFunc>(publish_func);
+    }
+
+    Display* display() const { return state_->display; }
+    const PointerStats& stats() const { return state_->stats; }
+    bool dragging() const { return state_->drag.active(); }
+
+private:
+    // Состояние общее для всех копий модуля (Compositor хранит копию)
+    struct State {
+        // Один дескриптор для главного цикла: соединение X и таймер кадра
+        State(Display* dpy, const PointerConfig& cfg)
+            : display(dpy), config(cfg), drag(cfg.frame_interval)
+        {
+            if (!display) return;
+            epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            epoll_event ev{.events = EPOLLIN, .data = {.fd = ConnectionNumber(display)}};
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ConnectionNumber(display), &ev);
+            ev.data.fd = timer_fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+        }
+
+        ~State() {
+            if (timer_fd >= 0) close(timer_fd);
+            if (epoll_fd >= 0) close(epoll_fd);
+        }
+
+        Display* display;
+        PointerConfig config;
+        int epoll_fd = -1;
+        int timer_fd = -1;
+        bool grabbed = false;
+
+        pointer_utils::MotionCompressor motion;
+        pointer_utils::DragController drag;
+        PointerStats stats;
+
+        std::function<void(const PointerMotionEvent&)> publish_motion;
+        std::function<void(const PointerPressEvent&)> publish_press;
+        std::function<void(const PointerReleaseEvent&)> publish_release;
+        std::function<void(const WindowConfigureEvent&)> publish_configure;
+    };
+
+    static void flush_motion(State& s) {
+        if (auto payload = s.motion.take()) {
+            ++s.stats.motion_published;
+            if (s.publish_motion) s.publish_motion(PointerMotionEvent{.payload = *payload});
+        }
+    }
+
+    static void process_button_press(State& s, const XButtonEvent& xbutton) {
+        if (s.publish_press) {
+            s.publish_press(PointerPressEvent{.payload = {
+                .button = xbutton.button,
+                .state = xbutton.state,
+                .window = xbutton.subwindow,
+                .x = xbutton.x_root,
+                .y = xbutton.y_root,
+                .timestamp = xbutton.time
+            }});
+        }
+
+        if (s.drag.active() || xbutton.subwindow == None
+            || (xbutton.state & s.config.drag_modifier) != s.config.drag_modifier) {
+            return;
+        }
+        pointer_utils::DragMode mode;
+        if (xbutton.button == s.config.move_button) mode = pointer_utils::DragMode::move;
+        else if (xbutton.button == s.config.resize_button) mode = pointer_utils::DragMode::resize;
+        else return;
+
+        // Единственный запрос с ожиданием ответа - начальная геометрия окна
+        XWindowAttributes attrs;
+        if (!XGetWindowAttributes(s.display, xbutton.subwindow, &attrs)) return;
+        s.drag.begin(mode, xbutton.x_root, xbutton.y_root, pointer_utils::DragGeometry{
+            .window = xbutton.subwindow,
+            .x = attrs.x,
+            .y = attrs.y,
+            .width = static_cast<unsigned int>(attrs.width),
+            .height = static_cast<unsigned int>(attrs.height)
+        }, pointer_utils::clock::now());
+    }
+
+    static void process_button_release(State& s, const XButtonEvent& xbutton) {
+        if (s.drag.active() && (xbutton.button == s.config.move_button || xbutton.button == s.config.resize_button)) {
+            finish_drag(s);
+        }
+        if (s.publish_release) {
+            s.publish_release(PointerReleaseEvent{.payload = {
+                .button = xbutton.button,
+                .state = xbutton.state,
+                .window = xbutton.subwindow,
+                .x = xbutton.x_root,
+                .y = xbutton.y_root,
+                .timestamp = xbutton.time
+            }});
+        }
+    }
+
+    // Конечная позиция применяется сразу, без ожидания кадра
+    static void finish_drag(State& s) {
+        if (auto geometry = s.drag.end()) apply_geometry(s, *geometry);
+        disarm_timer(s);
+    }
+
+    static void apply_geometry(State& s, const pointer_utils::DragGeometry& geometry) {
+        ++s.stats.geometry_requests;
+        if (s.drag.mode() == pointer_utils::DragMode::move) {
+            XMoveWindow(s.display, geometry.window, geometry.x, geometry.y);
+        } else {
+            XResizeWindow(s.display, geometry.window, geometry.width, geometry.height);
+        }
+        if (s.publish_configure) {
+            s.publish_configure(WindowConfigureEvent{.payload = {
+                geometry.window, geometry.x, geometry.y, geometry.width, geometry.height
+            }});
+        }
+    }
+
+    static void arm_timer(State& s, pointer_utils::clock::time_point when) {
+        const auto delay = std::max<std::chrono::nanoseconds>(when - pointer_utils::clock::now(),
+                                                               std::chrono::microseconds(100));
+        itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(delay.count() / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(delay.count() % 1000000000);
+        timerfd_settime(s.timer_fd, 0, &spec, nullptr);
+    }
+
+    static void disarm_timer(State& s) {
+        if (s.timer_fd < 0) return;
+        itimerspec spec{};
+        timerfd_settime(s.timer_fd, 0, &spec, nullptr);
+    }
+
+    std::shared_ptr<State> state_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <core/module.hpp>
+#include <modules/keyboard.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// LATENCY PROBE MODULE - Сигнал об обработке ввода для внешних измерений
+////////////////////////////////////////////////////////////////////////////////
+//
+// Если задана переменная окружения TWM_PROBE_FD (дескриптор записи канала,
+// унаследованный от запустившего процесса), после обработки каждого нажатия
+// клавиши в канал пишется запись ProbeRecord. Без переменной обработчик
+// сводится к одной проверке.
+//
+// Модуль регистрируется после модулей, обрабатывающих клавиши: подписчики
+// вызываются в порядке регистрации, поэтому запись означает, что нажатие
+// полностью обработано. Используется src/bench/e2e/input_latency.cpp.
+//
+// Пример использования:
+//   auto compositor = Compositor<KeyboardModule, ShortcutsModule, LatencyProbeModule>{
+//       keyboard, shortcuts, LatencyProbeModule::from_environment()};
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct ProbeRecord {
+    std::uint64_t sequence;  // Номер нажатия с запуска
+    std::uint64_t keysym;
+};
+
+class LatencyProbeModule : public ModuleBase<LatencyProbeModule> {
+public:
+    explicit LatencyProbeModule(int fd = -1) : fd_(fd) {}
+
+    static LatencyProbeModule from_environment() {
+        const char* value = std::getenv("TWM_PROBE_FD");
+        return LatencyProbeModule(value && *value ? std::atoi(value) : -1);
+    }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus
+            .template subscribe_event<KeyPressEvent, &LatencyProbeModule::handle_key_press>();
+    }
+
+    bool enabled() const { return fd_ >= 0; }
+
+private:
+    void handle_key_press(const KeyPressEvent& event) {
+        if (fd_ < 0) return;
+        const ProbeRecord record{sequence_++, event.payload.keysym};
+        // Запись не больше PIPE_BUF атомарна; при закрытом канале пробник отключается
+        // (EPIPE: SIGPIPE в twm игнорируется, см. main.cpp)
+        while (write(fd_, &record, sizeof(record)) < 0) {
+            if (errno == EINTR) continue;
+            fd_ = -1;
+            return;
+        }
+    }
+
+    int fd_;
+    std::uint64_t sequence_ = 0;
+};
@@ -2,9 +2,115 @@
 
 #include <core/event.hpp>
 #include <core/module.hpp>
+#include <core/rcu.hpp>
 #include <modules/keyboard.hpp>
 #include <X11/keysym.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// SHORTCUT TABLE - Таблица привязок клавиш
+////////////////////////////////////////////////////////////////////////////////
+
+enum class ShortcutAction : std::uint8_t {
+    exit,     // Завершение оконного менеджера
+    message,  // Вывод сообщения в stdout
+    spawn,    // Запуск команды через /bin/sh -c
+    restart   // Перезапуск с передачей состояния (см. core/restart.hpp)
+};
+
+struct Shortcut {
+    KeySym keysym;           // Символ клавиши в нижнем регистре
+    unsigned int modifiers;  // Модификаторы, которые должны быть зажаты
+    ShortcutAction action;
+    std::uint32_t argument_offset; // Аргумент действия в ShortcutTable::strings
+    std::uint32_t argument_size;
+};
+
+// Неизменяемая после публикации таблица шорткатов и раскладок
+// Собирается целиком (например, ConfigModule в фоновом потоке)
+// и публикуется через ShortcutsModule::publish_table()
+struct ShortcutTable {
+    static constexpr std::size_t max_workspaces = 16;
+
+    std::vector<Shortcut> shortcuts;                   // Отсортированы по keysym, затем по числу модификаторов
+    std::string strings;                               // Аргументы действий подряд
+    std::array<std::uint32_t, max_workspaces> layouts{}; // Раскладка по умолчанию для рабочих столов
+
+    static KeySym normalize(KeySym keysym) {
+        KeySym lower, upper;
+        XConvertCase(keysym, &lower, &upper);
+        return lower;
+    }
+
+    void add(KeySym keysym, unsigned int modifiers, ShortcutAction action, std::string_view argument = {}) {
+        shortcuts.push_back(Shortcut{
+            .keysym = normalize(keysym),
+            .modifiers = modifiers,
+            .action = action,
+            .argument_offset = static_cast<std::uint32_t>(strings.size()),
+            .argument_size = static_cast<std::uint32_t>(argument.size())
+        });
+        strings.append(argument);
+    }
+
+    // Сортировка после заполнения; более специфичные привязки раньше
+    void finalize() {
+        std::stable_sort(shortcuts.begin(), shortcuts.end(), [](const Shortcut& a, const Shortcut& b) {
+            if (a.keysym != b.keysym) return a.keysym < b.keysym;
+            return std::popcount(a.modifiers) > std::popcount(b.modifiers);
+        });
+    }
+
+    std::string_view argument(const Shortcut& shortcut) const {
+        return std::string_view(strings).substr(shortcut.argument_offset, shortcut.argument_size);
+    }
+
+    // Привязка, все модификаторы которой зажаты в state
+    const Shortcut* find(KeySym keysym, unsigned int state) const {
+        const KeySym key = normalize(keysym);
+        auto it = std::lower_bound(shortcuts.begin(), shortcuts.end(), key,
+                                   [](const Shortcut& s, KeySym k) { return s.keysym < k; });
+        for (; it != shortcuts.end() && it->keysym == key; ++it) {
+            if ((state & it->modifiers) == it->modifiers) return &*it;
+        }
+        return nullptr;
+    }
+
+    // Плоская запись для образа перезапуска (Shortcut тривиально копируется)
+    void serialize(RestartWriter& out) const {
+        out.write_array(std::span(shortcuts));
+        out.write_string(strings);
+        out.write(layouts);
+    }
+
+    bool restore(RestartReader& in) {
+        const std::span<const Shortcut> restored = in.read_array<Shortcut>();
+        shortcuts.assign(restored.begin(), restored.end());
+        strings = in.read_string();
+        in.read(layouts);
+        return in.ok();
+    }
+
+    // Встроенные привязки (используются, пока не загружен конфиг)
+    static ShortcutTable defaults() {
+        ShortcutTable table;
+        table.add(XK_Escape, 0, ShortcutAction::exit);
+        table.add(XK_b, Mod4Mask, ShortcutAction::message, "Win+B pressed - Hello from TWM!");
+        table.finalize();
+        return table;
+    }
+};
 
 ////////////////////////////////////////////////////////////////////////////////
 // SHORTCUTS MODULE - Модуль обработки шорткатов
@@ -12,6 +118,7 @@
 
 // Модуль обработки шорткатов
 // Подписывается на события клавиатуры и обрабатывает комбинации клавиш
+// по текущей таблице; таблица может быть заменена на лету (см. ConfigModule)
 class ShortcutsModule : public ModuleBase<ShortcutsModule> {
 public:
     ShortcutsModule() = default;
@@ -21,49 +128,103 @@ public:
     constexpr auto register_impl(EventBus<Bindings...> bus) const {
         // Подписываемся на события клавиатуры
         return bus
-            .template subscribe_event<KeyPressEvent, handle_key_press>();
+            .template subscribe_event<KeyPressEvent, &ShortcutsModule::handle_key_press>();
     }
 
 private:
-    // Обработчик нажатия клавиши
-    static void handle_key_press(const KeyPressEvent& event) {
+    // Обработчик нажатия клавиши (вызывается на экземпляре модуля в Compositor)
+    void handle_key_press(const KeyPressEvent& event) {
         const auto& payload = event.payload;
-        
+
         // Отладочный вывод
-        std::cerr << "ShortcutsModule: received key press, keysym=" << payload.keysym 
+        std::cerr << "ShortcutsModule: received key press, keysym=" << payload.keysym
                   << ", state=" << payload.state << std::endl;
-        
-        // Escape - завершение программы
-        if (payload.keysym == XK_Escape) {
-            std::cout << "Escape pressed - exiting..." << std::endl;
-            // Устанавливаем флаг для остановки главного цикла
-            exit_requested = true;
-            return;
+
+        // Одна загрузка указателя на событие: обработка всегда видит
+        // целиком одну версию таблицы, даже если во время нее опубликована новая
+        const ShortcutTable* current = table_.read();
+        const Shortcut* shortcut = current->find(payload.keysym, payload.state);
+        if (!shortcut) return;
+
+        switch (shortcut->action) {
+            case ShortcutAction::exit:
+                std::cout << "Exit shortcut pressed - exiting..." << std::endl;
+                // Устанавливаем флаг для остановки главного цикла
+                exit_requested = true;
+                break;
+            case ShortcutAction::message:
+                std::cout << current->argument(*shortcut) << std::endl;
+                break;
+            case ShortcutAction::spawn:
+                spawn(std::string(current->argument(*shortcut)));
+                break;
+            case ShortcutAction::restart:
+                std::cout << "Restart shortcut pressed - restarting..." << std::endl;
+                restart_requested = true;
+                break;
         }
-        
-        // Win+B - вывод сообщения
-        // Win (Super) = Mod4Mask в X11
-        // Проверяем, что нажата клавиша 'b' и зажат модификатор Mod4 (Super/Windows)
-        if (payload.keysym == XK_b || payload.keysym == XK_B) {
-            if (payload.state & Mod4Mask) {
-                std::cout << "Win+B pressed - Hello from TWM!" << std::endl;
-                return;
+    }
+
+    // Запуск команды с двойным fork, чтобы не оставлять зомби-процессов
+    static void spawn(const std::string& command) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            setsid();
+            if (fork() == 0) {
+                execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+                _exit(127);
             }
+            _exit(0);
+        }
+        if (pid > 0) {
+            waitpid(pid, nullptr, 0);
         }
     }
 
     // Флаг для запроса выхода
-    static inline bool exit_requested = false;
+    bool exit_requested = false;
+
+    // Флаг для запроса перезапуска (главный цикл завершается, как при выходе)
+    bool restart_requested = false;
+
+    // Текущая таблица шорткатов
+    static inline RcuPointer<ShortcutTable> table_{
+        std::make_unique<const ShortcutTable>(ShortcutTable::defaults())
+    };
 
 public:
     // Проверка запроса на выход
-    static bool should_exit() {
-        return exit_requested;
+    bool should_exit() const {
+        return exit_requested || restart_requested;
     }
 
-    // Сброс флага (для переиспользования)
-    static void reset_exit_flag() {
+    bool should_restart() const {
+        return restart_requested;
+    }
+
+    // Сброс флагов (для переиспользования)
+    void reset_exit_flag() {
         exit_requested = false;
+        restart_requested = false;
     }
-};
 
+    // Атомарная замена таблицы (можно вызывать из любого потока)
+    static void publish_table(std::unique_ptr<const ShortcutTable> table) {
+        table_.publish(std::move(table));
+    }
+
+    // Освобождение замененных таблиц; вызывается в главном потоке между событиями
+    static void reclaim_tables() {
+        table_.reclaim();
+    }
+
+    // Точка покоя главного цикла (CompositorRunner, раз за итерацию): таблица,
+    // замененная перезагрузкой конфига, освобождается не позже чем через итерацию
+    void run() {
+        reclaim_tables();
+    }
+
+    static const ShortcutTable& table() {
+        return *table_.read();
+    }
+};
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <core/module.hpp>
+#include <modules/window_events.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// STATE SNAPSHOT MODULE - Публикация состояния в разделяемую память
+////////////////////////////////////////////////////////////////////////////////
+//
+// Статус-бары опрашивают текущий рабочий стол, окно в фокусе и раскладку.
+// Вместо IPC запросов композитор публикует компактный снимок состояния
+// в POSIX shm сегмент, защищенный seqlock'ом:
+//
+// - Писатель (главный поток композитора) обновляет снимок по событиям шины
+// - Читатели отображают сегмент только для чтения и читают согласованное
+//   состояние без системных вызовов и без блокировок писателя
+// - Счетчик seq меняется при каждом обновлении, поэтому читатель может
+//   дешево проверить, изменилось ли состояние
+// - При перезапуске на месте (serialize()) сегмент не удаляется: новый
+//   процесс открывает тот же сегмент и продолжает seq, поэтому читатели
+//   остаются на нем. При обычном завершении сегмент удаляется, а seq в нем
+//   остается нечетным - read() читателя больше не проходит, и он
+//   переоткрывает сегмент по имени
+//
+// Пример использования (композитор):
+//   auto compositor = Compositor<KeyboardModule, StateSnapshotModule>{keyboard, StateSnapshotModule{}};
+//   compositor.initialize(); // создает сегмент /twm-state-<uid>
+//
+// Пример использования (статус-бар):
+//   StateSnapshotReader reader;
+//   if (reader.open(state_snapshot::default_name())) {
+//       StateSnapshotData state;
+//       if (reader.changed()) {
+//           if (reader.read(state)) draw(state.workspace, state.focused_window);
+//           else reader.open(state_snapshot::default_name()); // Композитор завершился
+//       }
+//   }
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Содержимое снимка; размер кратен 8 байтам, чтобы копировать атомарно по 64-битным словам
+struct StateSnapshotData {
+    static constexpr std::size_t max_workspaces = 16;
+
+    std::uint64_t focused_window;
+    std::uint64_t updated_ns;                   // CLOCK_MONOTONIC последнего обновления
+    std::uint32_t workspace;
+    std::uint32_t workspace_count;
+    std::uint32_t layouts[max_workspaces];      // Раскладка каждого рабочего стола
+    std::uint32_t window_counts[max_workspaces]; // Количество окон на каждом рабочем столе
+};
+
+namespace state_snapshot {
+    inline constexpr std::uint32_t magic = 0x54574D53; // "TWMS"
+    inline constexpr std::uint32_t version = 1;
+
+    // Заголовок сегмента; seq нечетный во время записи
+    struct alignas(64) Segment {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t data_size;
+        std::uint32_t reserved;
+        alignas(64) std::atomic<std::uint64_t> seq;
+        alignas(64) StateSnapshotData data;
+    };
+
+    static_assert(std::is_trivially_copyable_v<StateSnapshotData>);
+    static_assert(sizeof(StateSnapshotData) % sizeof(std::uint64_t) == 0);
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+    inline std::string default_name() {
+        return "/twm-state-" + std::to_string(getuid());
+    }
+
+    inline std::uint64_t now_ns() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+    }
+
+    // Пословное копирование через relaxed атомарные операции:
+    // гонка с писателем не является UB, а согласованность проверяет seq
+    inline void copy_words(StateSnapshotData& dst, const StateSnapshotData& src) {
+        constexpr std::size_t words = sizeof(StateSnapshotData) / sizeof(std::uint64_t);
+        auto* d = reinterpret_cast<std::uint64_t*>(&dst);
+        auto* s = reinterpret_cast<std::uint64_t*>(const_cast<StateSnapshotData*>(&src));
+        for (std::size_t i = 0; i < words; ++i) {
+            std::atomic_ref<std::uint64_t>(d[i]).store(
+                std::atomic_ref<std::uint64_t>(s[i]).load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        }
+    }
+
+    // Запись писателем (единственным)
+    inline void write(Segment& segment, const StateSnapshotData& data) {
+        const std::uint64_t seq = segment.seq.load(std::memory_order_relaxed);
+        segment.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        copy_words(segment.data, data);
+        segment.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Чтение согласованного снимка; false если писатель мешал max_attempts раз подряд
+    inline bool read(const Segment& segment, StateSnapshotData& out, unsigned int max_attempts = 1024,
+                     std::uint64_t* seq_out = nullptr) {
+        for (unsigned int attempt = 0; attempt < max_attempts; ++attempt) {
+            const std::uint64_t before = segment.seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            copy_words(out, segment.data);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (segment.seq.load(std::memory_order_relaxed) == before) {
+                if (seq_out) *seq_out = before;
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// READER
+////////////////////////////////////////////////////////////////////////////////
+
+// Библиотека чтения снимка для внешних процессов
+// После open() чтение не выполняет системных вызовов
+class StateSnapshotReader {
+public:
+    StateSnapshotReader() = default;
+    StateSnapshotReader(const StateSnapshotReader&) = delete;
+    StateSnapshotReader& operator=(const StateSnapshotReader&) = delete;
+
+    ~StateSnapshotReader() {
+        close();
+    }
+
+    bool open(const std::string& name) {
+        close();
+        int fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0) return false;
+        void* addr = mmap(nullptr, sizeof(state_snapshot::Segment), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) return false;
+
+        segment_ = static_cast<const state_snapshot::Segment*>(addr);
+        if (segment_->magic != state_snapshot::magic || segment_->version != state_snapshot::version
+            || segment_->data_size != sizeof(StateSnapshotData)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (segment_) munmap(const_cast<state_snapshot::Segment*>(segment_), sizeof(state_snapshot::Segment));
+        segment_ = nullptr;
+        last_seq_ = 0;
+    }
+
+    bool is_open() const { return segment_ != nullptr; }
+
+    // Изменилось ли состояние с последнего успешного read()
+    bool changed() const {
+        return segment_ && segment_->seq.load(std::memory_order_acquire) != last_seq_;
+    }
+
+    bool read(StateSnapshotData& out) {
+        return segment_ && state_snapshot::read(*segment_, out, 1024, &last_seq_);
+    }
+
+    std::uint64_t sequence() const { return last_seq_; }
+
+private:
+    const state_snapshot::Segment* segment_ = nullptr;
+    std::uint64_t last_seq_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// MODULE
+////////////////////////////////////////////////////////////////////////////////
+
+class StateSnapshotModule : public ModuleBase<StateSnapshotModule> {
+public:
+    explicit StateSnapshotModule(std::string name = state_snapshot::default_name())
+        : state_(std::make_shared<State>(std::move(name)))
+    {}
+
+    // Создание и отображение сегмента
+    void initialize() {
+        State& s = *state_;
+        if (s.segment) return;
+
+        int fd = shm_open(s.name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+        if (fd < 0) return;
+        if (ftruncate(fd, sizeof(state_snapshot::Segment)) < 0) {
+            ::close(fd);
+            return;
+        }
+        void* addr = mmap(nullptr, sizeof(state_snapshot::Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) return;
+
+        // Сегмент, оставленный перезапуском (см. serialize()), уже отображен
+        // читателями: seq продолжается с четного значения, и они видят изменение
+        s.segment = static_cast<state_snapshot::Segment*>(addr);
+        s.segment->magic = state_snapshot::magic;
+        s.segment->version = state_snapshot::version;
+        s.segment->data_size = sizeof(StateSnapshotData);
+        s.segment->seq.store((s.segment->seq.load(std::memory_order_relaxed) + 1) & ~1ull,
+                             std::memory_order_relaxed);
+        s.publish();
+    }
+
+    void cleanup() {
+        state_->unmap();
+    }
+
+    // Фокус, рабочие столы и раскладки переживают перезапуск
+    static constexpr std::string_view state_tag = "state_snapshot";
+    static constexpr std::uint32_t state_version = 1;
+
+    // Образ пишется только перед перезапуском: сегмент остается для нового процесса
+    void serialize(RestartWriter& out) const {
+        state_->keep_segment = true;
+        out.write(state_->data);
+    }
+
+    bool restore(RestartReader& in) {
+        return in.read(state_->data);
+    }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus
+            .template subscribe_event<FocusChangedEvent, &StateSnapshotModule::handle_focus>()
+            .template subscribe_event<WorkspaceChangedEvent, &StateSnapshotModule::handle_workspace>()
+            .template subscribe_event<LayoutChangedEvent, &StateSnapshotModule::handle_layout>();
+    }
+
+    // Изменение снимка произвольной функцией и публикация
+    template<typename Mutator>
+    void update(Mutator&& mutate) {
+        std::forward<Mutator>(mutate)(state_->data);
+        state_->publish();
+    }
+
+    const StateSnapshotData& data() const { return state_->data; }
+    const std::string& name() const { return state_->name; }
+    std::uint64_t sequence() const {
+        return state_->segment ? state_->segment->seq.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    // Состояние общее для всех копий модуля (Compositor хранит копию)
+    struct State {
+        explicit State(std::string segment_name) : name(std::move(segment_name)) {}
+
+        ~State() {
+            unmap();
+        }
+
+        void publish() {
+            if (!segment) return;
+            data.updated_ns = state_snapshot::now_ns();
+            state_snapshot::write(*segment, data);
+        }
+
+        void unmap() {
+            if (!segment) return;
+            if (!keep_segment) {
+                // Нечетный seq навсегда: читатели старого сегмента переоткрывают его
+                segment->seq.fetch_or(1, std::memory_order_release);
+                shm_unlink(name.c_str());
+            }
+            munmap(segment, sizeof(state_snapshot::Segment));
+            segment = nullptr;
+        }
+
+        std::string name;
+        state_snapshot::Segment* segment = nullptr;
+        StateSnapshotData data{};  // Каноническая копия писателя
+        bool keep_segment = false; // Не удалять сегмент (перезапуск)
+    };
+
+    // Обработчики шины вызываются на экземпляре модуля в Compositor;
+    // до initialize() изменения копятся в data и публикуются при отображении
+    void handle_focus(const FocusChangedEvent& event) {
+        state_->data.focused_window = event.payload.window;
+        state_->publish();
+    }
+
+    void handle_workspace(const WorkspaceChangedEvent& event) {
+        state_->data.workspace = event.payload.workspace;
+        state_->data.workspace_count = event.payload.workspace_count;
+        state_->publish();
+    }
+
+    void handle_layout(const LayoutChangedEvent& event) {
+        if (event.payload.workspace >= StateSnapshotData::max_workspaces) return;
+        state_->data.layouts[event.payload.workspace] = event.payload.layout;
+        state_->data.window_counts[event.payload.workspace] = event.payload.window_count;
+        state_->publish();
+    }
+
+    std::shared_ptr<State> state_;
+};
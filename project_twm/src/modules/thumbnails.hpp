@@ -0,0 +1,537 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <core/module.hpp>
+#include <modules/window_events.hpp>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// THUMBNAIL MODULE - Кэш уменьшенных снимков окон
+////////////////////////////////////////////////////////////////////////////////
+//
+// Хранит уменьшенные копии содержимого окон для превью и быстрого
+// переключения рабочих столов, чтобы не читать pixmap'ы с X сервера
+// при каждом переключении.
+//
+// - Жесткий лимит памяти, вытеснение по LRU
+// - Инвалидация по событиям WindowDamage/WindowConfigure/WindowDestroy
+// - Снимок читается с X сервера в главном потоке (Xlib не потокобезопасен),
+//   уменьшение (box filter, SSE2) выполняется фоновым потоком
+//
+// Пример использования:
+//   ThumbnailModule thumbnails(display, ThumbnailConfig{.memory_budget = 16 << 20});
+//   auto compositor = Compositor<KeyboardModule, ThumbnailModule>{keyboard, thumbnails};
+//   compositor.initialize();
+//   ...
+//   auto thumb = compositor.dispatch(make_request<GetThumbnailPayload,
+//                                    std::shared_ptr<const Thumbnail>>({window}));
+//   if (!thumb) { /* снимок еще готовится, отрисовать заглушку */ }
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Уменьшенный снимок окна (ARGB32, строки без выравнивания)
+struct Thumbnail {
+    Window window;
+    unsigned int width, height;
+    std::vector<std::uint32_t> pixels;
+
+    std::size_t bytes() const {
+        return sizeof(Thumbnail) + pixels.size() * sizeof(std::uint32_t);
+    }
+};
+
+struct ThumbnailConfig {
+    std::size_t memory_budget = 32u << 20;  // Жесткий лимит памяти кэша в байтах
+    unsigned int max_width = 256;           // Максимальный размер превью
+    unsigned int max_height = 256;
+};
+
+struct GetThumbnailPayload {
+    Window window;
+};
+
+// Возвращает снимок из кэша; при промахе ставит окно в очередь и возвращает nullptr
+using GetThumbnailRequest = request<GetThumbnailPayload, std::shared_ptr<const Thumbnail>>;
+
+////////////////////////////////////////////////////////////////////////////////
+// BOX FILTER
+////////////////////////////////////////////////////////////////////////////////
+
+namespace thumbnail_utils {
+    // Размер превью с сохранением пропорций (не больше исходного)
+    inline void fit_size(unsigned int sw, unsigned int sh, unsigned int max_w, unsigned int max_h,
+                         unsigned int& dw, unsigned int& dh) {
+        if (sw <= max_w && sh <= max_h) {
+            dw = sw;
+            dh = sh;
+            return;
+        }
+        // Сравнение sw/max_w и sh/max_h без деления
+        if (static_cast<std::uint64_t>(sw) * max_h >= static_cast<std::uint64_t>(sh) * max_w) {
+            dw = max_w;
+            dh = std::max(1u, static_cast<unsigned int>(static_cast<std::uint64_t>(sh) * max_w / sw));
+        } else {
+            dh = max_h;
+            dw = std::max(1u, static_cast<unsigned int>(static_cast<std::uint64_t>(sw) * max_h / sh));
+        }
+    }
+
+    // Добавить строку пикселей к аккумулятору (4 канала по 32 бита на пиксель)
+    inline void accumulate_row(const std::uint32_t* row, std::uint32_t* acc, unsigned int width) {
+        unsigned int x = 0;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        for (; x + 4 <= width; x += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            __m128i lo = _mm_unpacklo_epi8(px, zero);
+            __m128i hi = _mm_unpackhi_epi8(px, zero);
+            __m128i* a = reinterpret_cast<__m128i*>(acc + x * 4);
+            _mm_storeu_si128(a + 0, _mm_add_epi32(_mm_loadu_si128(a + 0), _mm_unpacklo_epi16(lo, zero)));
+            _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(lo, zero)));
+            _mm_storeu_si128(a + 2, _mm_add_epi32(_mm_loadu_si128(a + 2), _mm_unpacklo_epi16(hi, zero)));
+            _mm_storeu_si128(a + 3, _mm_add_epi32(_mm_loadu_si128(a + 3), _mm_unpackhi_epi16(hi, zero)));
+        }
+#endif
+        for (; x < width; ++x) {
+            const std::uint32_t p = row[x];
+            acc[x * 4 + 0] += p & 0xFF;
+            acc[x * 4 + 1] += (p >> 8) & 0xFF;
+            acc[x * 4 + 2] += (p >> 16) & 0xFF;
+            acc[x * 4 + 3] += p >> 24;
+        }
+    }
+
+    // Усреднить 4 канала суммы [from, to) столбцов аккумулятора
+    inline std::uint32_t average_columns(const std::uint32_t* acc, unsigned int from, unsigned int to,
+                                         unsigned int rows) {
+        const float inv = 1.0f / static_cast<float>((to - from) * rows);
+#if defined(__SSE2__)
+        __m128i sum = _mm_setzero_si128();
+        for (unsigned int x = from; x < to; ++x) {
+            sum = _mm_add_epi32(sum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + x * 4)));
+        }
+        __m128i avg = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(inv)));
+        avg = _mm_packs_epi32(avg, avg);
+        avg = _mm_packus_epi16(avg, avg);
+        return static_cast<std::uint32_t>(_mm_cvtsi128_si32(avg));
+#else
+        std::uint32_t result = 0;
+        for (unsigned int c = 0; c < 4; ++c) {
+            std::uint32_t sum = 0;
+            for (unsigned int x = from; x < to; ++x) sum += acc[x * 4 + c];
+            result |= static_cast<std::uint32_t>(static_cast<float>(sum) * inv + 0.5f) << (c * 8);
+        }
+        return result;
+#endif
+    }
+
+    // Уменьшение ARGB32 изображения box filter'ом: каждый выходной пиксель -
+    // среднее по прямоугольнику исходных пикселей, который он покрывает.
+    // stride - длина строки источника в пикселях
+    inline void box_downscale(const std::uint32_t* src, unsigned int sw, unsigned int sh, std::size_t stride,
+                              std::uint32_t* dst, unsigned int dw, unsigned int dh) {
+        std::vector<std::uint32_t> acc(static_cast<std::size_t>(sw) * 4);
+        for (unsigned int y = 0; y < dh; ++y) {
+            const unsigned int y0 = static_cast<unsigned int>(static_cast<std::uint64_t>(y) * sh / dh);
+            const unsigned int y1 = std::max(y0 + 1,
+                static_cast<unsigned int>(static_cast<std::uint64_t>(y + 1) * sh / dh));
+
+            std::fill(acc.begin(), acc.end(), 0u);
+            for (unsigned int sy = y0; sy < y1; ++sy) {
+                accumulate_row(src + sy * stride, acc.data(), sw);
+            }
+
+            for (unsigned int x = 0; x < dw; ++x) {
+                const unsigned int x0 = static_cast<unsigned int>(static_cast<std::uint64_t>(x) * sw / dw);
+                const unsigned int x1 = std::max(x0 + 1,
+                    static_cast<unsigned int>(static_cast<std::uint64_t>(x + 1) * sw / dw));
+                dst[static_cast<std::size_t>(y) * dw + x] = average_columns(acc.data(), x0, x1, y1 - y0);
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// LRU CACHE
+////////////////////////////////////////////////////////////////////////////////
+
+// Потокобезопасный LRU кэш снимков с лимитом памяти
+// Поколение - общий счетчик изменений: задача запоминает его при постановке
+// в очередь, invalidate() записывает окну новое значение, и insert()
+// отбрасывает результаты, начатые раньше последнего изменения окна.
+// Окно без записи не менялось (поиск не создает записей); запись
+// уничтоженного окна остается надгробием, чтобы задача в полете не попала в кэш.
+// Когда записей больше max_tracked_windows, они сбрасываются вместе с
+// нижней границей поколений (все задачи в полете отбрасываются - снимки
+// будут сняты заново при следующем промахе)
+class ThumbnailCache {
+public:
+    explicit ThumbnailCache(std::size_t memory_budget) : budget_(memory_budget) {}
+
+    std::shared_ptr<const Thumbnail> lookup(Window window) {
+        std::lock_guard lock(mutex_);
+        auto it = index_.find(window);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return *it->second;
+    }
+
+    // Вставка снимка; false если снимок устарел или больше всего бюджета
+    bool insert(std::shared_ptr<const Thumbnail> thumbnail, std::uint64_t generation) {
+        const std::size_t size = thumbnail->bytes();
+        std::lock_guard lock(mutex_);
+        if (size > budget_ || !current_locked(thumbnail->window, generation)) {
+            return false;
+        }
+        erase_locked(thumbnail->window);
+        while (used_ + size > budget_ && !lru_.empty()) {
+            ++evictions_;
+            erase_locked(lru_.back()->window);
+        }
+        used_ += size;
+        lru_.push_front(std::move(thumbnail));
+        index_[lru_.front()->window] = lru_.begin();
+        return true;
+    }
+
+    static constexpr std::size_t max_tracked_windows = 4096;
+
+    // Поколение для новой задачи (запоминается при постановке в очередь)
+    std::uint64_t generation() {
+        std::lock_guard lock(mutex_);
+        return clock_;
+    }
+
+    // Окно изменено или уничтожено: снимок удаляется, задачи в полете отсекаются
+    void invalidate(Window window) {
+        std::lock_guard lock(mutex_);
+        touch_locked(window);
+        erase_locked(window);
+    }
+
+    void clear() {
+        std::lock_guard lock(mutex_);
+        floor_ = ++clock_;
+        changed_.clear();
+        lru_.clear();
+        index_.clear();
+        used_ = 0;
+    }
+
+    std::size_t memory_usage() const { std::lock_guard lock(mutex_); return used_; }
+    std::size_t memory_budget() const { return budget_; }
+    std::size_t size() const { std::lock_guard lock(mutex_); return lru_.size(); }
+    std::size_t hits() const { std::lock_guard lock(mutex_); return hits_; }
+    std::size_t misses() const { std::lock_guard lock(mutex_); return misses_; }
+    std::size_t evictions() const { std::lock_guard lock(mutex_); return evictions_; }
+
+private:
+    using LruList = std::list<std::shared_ptr<const Thumbnail>>;
+
+    // Задача с поколением generation начата после последнего изменения окна
+    bool current_locked(Window window, std::uint64_t generation) const {
+        if (generation < floor_) return false;
+        auto it = changed_.find(window);
+        return it == changed_.end() || generation >= it->second;
+    }
+
+    void touch_locked(Window window) {
+        if (changed_.size() >= max_tracked_windows && !changed_.contains(window)) {
+            floor_ = clock_ + 1;
+            changed_.clear();
+        }
+        changed_[window] = ++clock_;
+    }
+
+    void erase_locked(Window window) {
+        auto it = index_.find(window);
+        if (it == index_.end()) return;
+        used_ -= (*it->second)->bytes();
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+
+    mutable std::mutex mutex_;
+    std::size_t budget_;
+    std::size_t used_ = 0;
+    LruList lru_;  // Начало - последний использованный
+    std::unordered_map<Window, LruList::iterator> index_;
+    std::uint64_t clock_ = 0;
+    std::uint64_t floor_ = 0;   // Задачи с меньшим поколением отбрасываются
+    std::unordered_map<Window, std::uint64_t> changed_;  // Поколение последнего изменения окна
+    std::size_t hits_ = 0, misses_ = 0, evictions_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// BACKGROUND WORKER
+////////////////////////////////////////////////////////////////////////////////
+
+// Фоновый поток, уменьшающий снятые с X сервера изображения
+class ThumbnailWorker {
+public:
+    struct Job {
+        Window window;
+        std::uint64_t generation;
+        unsigned int width, height;              // Размер исходного изображения
+        unsigned int target_width, target_height;
+        std::vector<std::uint32_t> pixels;       // Исходные пиксели, stride == width
+    };
+
+    explicit ThumbnailWorker(ThumbnailCache& cache) : cache_(cache) {}
+
+    ~ThumbnailWorker() {
+        stop();
+    }
+
+    void start() {
+        if (thread_.joinable()) return;
+        stopping_ = false;
+        thread_ = std::thread([this] { loop(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    void submit(Job job) {
+        {
+            std::lock_guard lock(mutex_);
+            // Повторный запрос того же окна заменяет ожидающую задачу
+            auto it = std::find_if(jobs_.begin(), jobs_.end(),
+                                   [&](const Job& j) { return j.window == job.window; });
+            if (it != jobs_.end()) {
+                *it = std::move(job);
+                return;
+            }
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+    // Ожидание обработки всех поставленных задач
+    void drain() {
+        std::unique_lock lock(mutex_);
+        idle_cv_.wait(lock, [this] { return jobs_.empty() && !busy_; });
+    }
+
+private:
+    void loop() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (stopping_) break;
+
+            Job job = std::move(jobs_.front());
+            jobs_.pop_front();
+            busy_ = true;
+            lock.unlock();
+
+            process(job);
+
+            lock.lock();
+            busy_ = false;
+            if (jobs_.empty()) idle_cv_.notify_all();
+        }
+        busy_ = false;
+        idle_cv_.notify_all();
+    }
+
+    void process(const Job& job) {
+        auto thumbnail = std::make_shared<Thumbnail>();
+        thumbnail->window = job.window;
+        thumbnail->width = job.target_width;
+        thumbnail->height = job.target_height;
+        thumbnail->pixels.resize(static_cast<std::size_t>(job.target_width) * job.target_height);
+        thumbnail_utils::box_downscale(job.pixels.data(), job.width, job.height, job.width,
+                                       thumbnail->pixels.data(), job.target_width, job.target_height);
+        cache_.insert(std::move(thumbnail), job.generation);
+    }
+
+    ThumbnailCache& cache_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    std::deque<Job> jobs_;
+    bool stopping_ = false;
+    bool busy_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// MODULE
+////////////////////////////////////////////////////////////////////////////////
+
+class ThumbnailModule : public ModuleBase<ThumbnailModule> {
+public:
+    explicit ThumbnailModule(Display* display, ThumbnailConfig config = {})
+        : display_(display)
+        , state_(std::make_shared<State>(config))
+    {}
+
+    void initialize() {
+        state_->worker.start();
+        state_->display = display_;
+    }
+
+    void cleanup() {
+        state_->worker.stop();
+        state_->display = nullptr;
+    }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus
+            .template subscribe_event<WindowDamageEvent, &ThumbnailModule::handle_damage>()
+            .template subscribe_event<WindowConfigureEvent, &ThumbnailModule::handle_configure>()
+            .template subscribe_event<WindowDestroyEvent, &ThumbnailModule::handle_destroy>()
+            .template bind_request<GetThumbnailRequest, &ThumbnailModule::handle_get_thumbnail>();
+    }
+
+    // Снять окно с X сервера и поставить в очередь на уменьшение
+    // Возвращает false, если окно недоступно
+    bool capture(Window window) {
+        return capture_into(*state_, display_, window);
+    }
+
+    // Поставить в очередь уже снятое изображение (stride == width)
+    void submit(Window window, unsigned int width, unsigned int height, std::vector<std::uint32_t> pixels) {
+        submit_into(*state_, window, width, height, std::move(pixels));
+    }
+
+    std::shared_ptr<const Thumbnail> lookup(Window window) { return state_->cache.lookup(window); }
+    ThumbnailCache& cache() { return state_->cache; }
+    const ThumbnailCache& cache() const { return state_->cache; }
+    void wait_idle() { state_->worker.drain(); }
+
+private:
+    // Состояние общее для всех копий модуля (Compositor хранит копию)
+    struct State {
+        explicit State(const ThumbnailConfig& cfg)
+            : config(cfg), cache(cfg.memory_budget), worker(cache) {}
+
+        ThumbnailConfig config;
+        ThumbnailCache cache;
+        ThumbnailWorker worker;
+        Display* display = nullptr;  // Задан между initialize() и cleanup()
+    };
+
+    static void submit_into(State& state, Window window, unsigned int width, unsigned int height,
+                            std::vector<std::uint32_t> pixels) {
+        if (width == 0 || height == 0) return;
+        ThumbnailWorker::Job job{
+            .window = window,
+            .generation = state.cache.generation(),
+            .width = width,
+            .height = height,
+            .target_width = 0,
+            .target_height = 0,
+            .pixels = std::move(pixels)
+        };
+        thumbnail_utils::fit_size(width, height, state.config.max_width, state.config.max_height,
+                                  job.target_width, job.target_height);
+        state.worker.submit(std::move(job));
+    }
+
+    // Ошибка X во время снятия окна (окно закрыто между запросами):
+    // обработчик Xlib по умолчанию завершает процесс
+    static int ignore_x_error(Display*, XErrorEvent*) { return 0; }
+
+    // Снимается видимая на экране часть окна: XGetImage за границами
+    // корневого окна дает BadMatch
+    static bool capture_into(State& state, Display* display, Window window) {
+        if (!display) return false;
+
+        XWindowAttributes attrs;
+        if (!XGetWindowAttributes(display, window, &attrs) || attrs.map_state != IsViewable) {
+            return false;
+        }
+
+        int root_x, root_y;
+        Window child;
+        if (!XTranslateCoordinates(display, window, attrs.root, 0, 0, &root_x, &root_y, &child)) {
+            return false;
+        }
+        const int x0 = std::max(0, -root_x);
+        const int y0 = std::max(0, -root_y);
+        const int x1 = std::min(attrs.width, WidthOfScreen(attrs.screen) - root_x);
+        const int y1 = std::min(attrs.height, HeightOfScreen(attrs.screen) - root_y);
+        if (x1 <= x0 || y1 <= y0) return false;
+
+        const auto width = static_cast<unsigned int>(x1 - x0);
+        const auto height = static_cast<unsigned int>(y1 - y0);
+        auto previous_handler = XSetErrorHandler(ignore_x_error);
+        XImage* image = XGetImage(display, window, x0, y0, width, height, AllPlanes, ZPixmap);
+        XSetErrorHandler(previous_handler);
+        if (!image) return false;
+
+        std::vector<std::uint32_t> pixels(static_cast<std::size_t>(width) * height);
+        if (image->bits_per_pixel == 32) {
+            for (unsigned int y = 0; y < height; ++y) {
+                std::memcpy(pixels.data() + static_cast<std::size_t>(y) * width,
+                            image->data + static_cast<std::size_t>(y) * image->bytes_per_line,
+                            width * sizeof(std::uint32_t));
+            }
+        } else {
+            for (unsigned int y = 0; y < height; ++y) {
+                for (unsigned int x = 0; x < width; ++x) {
+                    pixels[static_cast<std::size_t>(y) * width + x] =
+                        static_cast<std::uint32_t>(XGetPixel(image, x, y));
+                }
+            }
+        }
+        XDestroyImage(image);
+
+        submit_into(state, window, width, height, std::move(pixels));
+        return true;
+    }
+
+    // Обработчики шины вызываются на экземпляре модуля в Compositor
+    void handle_damage(const WindowDamageEvent& event) {
+        state_->cache.invalidate(event.payload.window);
+    }
+
+    void handle_configure(const WindowConfigureEvent& event) {
+        state_->cache.invalidate(event.payload.window);
+    }
+
+    void handle_destroy(const WindowDestroyEvent& event) {
+        state_->cache.invalidate(event.payload.window);
+    }
+
+    // Промах кэша ставит снятие окна в очередь (только после initialize())
+    std::shared_ptr<const Thumbnail> handle_get_thumbnail(const GetThumbnailRequest& request) {
+        auto thumbnail = state_->cache.lookup(request.payload.window);
+        if (!thumbnail) {
+            capture_into(*state_, state_->display, request.payload.window);
+        }
+        return thumbnail;
+    }
+
+    Display* display_;
+    std::shared_ptr<State> state_;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <core/event.hpp>
+#include <X11/Xlib.h>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////
+// WINDOW EVENTS - События об изменении окон
+////////////////////////////////////////////////////////////////////////////////
+//
+// Общие события, которые публикует модуль управления окнами (или любой
+// другой модуль, получающий Damage/ConfigureNotify от X сервера).
+// Вынесены в отдельный заголовок, чтобы подписчики не зависели от источника.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Содержимое окна изменилось (область в координатах окна)
+struct WindowDamagePayload {
+    Window window;
+    int x, y;
+    unsigned int width, height;
+};
+
+// Окно перемещено или изменило размер
+struct WindowConfigurePayload {
+    Window window;
+    int x, y;
+    unsigned int width, height;
+};
+
+// Окно уничтожено
+struct WindowDestroyPayload {
+    Window window;
+};
+
+using WindowDamageEvent = event<WindowDamagePayload>;
+using WindowConfigureEvent = event<WindowConfigurePayload>;
+using WindowDestroyEvent = event<WindowDestroyPayload>;
+
+// События одного окна обрабатываются по порядку (см. core/sharded.hpp)
+template<>
+struct shard_key<WindowDamagePayload> {
+    static std::uint64_t get(const WindowDamagePayload& p) { return p.window; }
+};
+
+template<>
+struct shard_key<WindowConfigurePayload> {
+    static std::uint64_t get(const WindowConfigurePayload& p) { return p.window; }
+};
+
+template<>
+struct shard_key<WindowDestroyPayload> {
+    static std::uint64_t get(const WindowDestroyPayload& p) { return p.window; }
+};
+
+// Фокус перешел на другое окно (None - нет окна в фокусе)
+struct FocusChangedPayload {
+    Window window;
+};
+
+// Переключен активный рабочий стол
+struct WorkspaceChangedPayload {
+    unsigned int workspace;
+    unsigned int workspace_count;
+};
+
+// Изменена раскладка окон рабочего стола
+struct LayoutChangedPayload {
+    unsigned int workspace;
+    unsigned int layout;      // Идентификатор раскладки
+    unsigned int window_count; // Количество окон на рабочем столе
+};
+
+using FocusChangedEvent = event<FocusChangedPayload>;
+using WorkspaceChangedEvent = event<WorkspaceChangedPayload>;
+using LayoutChangedEvent = event<LayoutChangedPayload>;
@@ -1,9 +1,31 @@
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <core/event.hpp>
+#include <core/compositor.hpp>
+#include <core/arena.hpp>
+#include <core/restart.hpp>
+#include <core/sharded.hpp>
+#include <modules/config.hpp>
+#include <modules/event_stream.hpp>
+#include <modules/ipc.hpp>
+#include <modules/thumbnails.hpp>
+#include <poll.h>
 
 #define TEST1 true // correct cases of usage basic multiply event subscribtion and related concepts
 #define TEST2 true // correct usage of command, request and event with external api(module)
+#define TEST3 true // module initialization and cleanup order with depends_on
+#define TEST4 true // per-iteration frame arena for event payloads
+#define TEST5 true // memoized requests invalidated by commands and events
+#define TEST6 true // member function handlers bound to module instances of each compositor
+#define TEST7 true // module state handed over through a restart image (memfd)
+#define TEST8 true // config parsing, reload keeping the previous table on error, restore stamp check
+#define TEST9 true // IPC client and event subscriber that disconnect without reading
+#define TEST10 true // sharded window events delivered to member handlers of a compositor's module
+#define TEST11 true // thumbnail cache: LRU memory budget, invalidation of jobs in flight, destroy tombstone
 
 
 #if TEST1
@@ -54,13 +76,16 @@ void test1(){
         .subscribe<event<PrintMsgPayload>, print_msg_handler>()
         .subscribe<PrintMsgEvent, another_print_msg_handler>()
         .subscribe<PrintMsgEvent, lambda_print_msg_handler>()
-        // .subscribe<PrintMsgEvent, functor_print_msg_handler(" (functor value)")>()
+        .subscribe<PrintMsgEvent, &functor_print_msg_handler::operator()>()
     ;
 
+    // functor with state is bound by member pointer and called on the instance passed as context
+    functor_print_msg_handler functor(" (functor value)");
+
     const auto e = make_event<PrintMsgPayload>({"\t Event msg!"});
-    bus.publish(e);
+    bus.publish(e, functor);
     std::cout<<"-----------------------------------------"<<std::endl;
-    bus.publish(PrintMsgEvent{.payload={.msg="\t Manual created event."}});
+    bus.publish(PrintMsgEvent{.payload={.msg="\t Manual created event."}}, functor);
 
     std::cout << "-_-_-_-_-_-_-_-\\  TEST 1 END  /-_-_-_-_-_-_-_-"  << std::endl;
 }
@@ -121,6 +146,600 @@ void test2(){
 }; // namespace
 #endif
 
+#if TEST3
+namespace test3{
+static std::mutex order_mutex;
+static std::vector<std::string> order;
+
+template<char Name, typename... Deps>
+struct OrderedModule : ModuleBase<OrderedModule<Name, Deps...>> {
+    using depends_on = type_list<Deps...>;
+
+    void initialize() { record(std::string("init ") + Name); }
+    void cleanup() { record(std::string("cleanup ") + Name); }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+
+    static void record(std::string entry) {
+        std::lock_guard lock(order_mutex);
+        order.push_back(std::move(entry));
+    }
+};
+
+using A = OrderedModule<'A'>;
+using B = OrderedModule<'B', A>;
+using C = OrderedModule<'C', A>;
+using D = OrderedModule<'D', B, C>;
+
+std::size_t position(const std::string& entry) {
+    for (std::size_t i = 0; i < order.size(); ++i) if (order[i] == entry) return i;
+    return order.size();
+}
+
+void test3(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 3 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    // порядок в паке не совпадает с порядком зависимостей
+    auto compositor = Compositor<D, C, B, A>{D{}, C{}, B{}, A{}};
+    compositor.initialize();
+    compositor.cleanup();
+
+    for (const auto& entry : order) std::cout << entry << std::endl;
+
+    const bool ok = position("init A") < position("init B") && position("init A") < position("init C")
+                 && position("init B") < position("init D") && position("init C") < position("init D")
+                 && position("cleanup D") < position("cleanup B") && position("cleanup D") < position("cleanup C")
+                 && position("cleanup B") < position("cleanup A") && position("cleanup C") < position("cleanup A")
+                 && order.size() == 8;
+    std::cout << (ok ? "order is correct" : "WRONG ORDER") << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 3 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
+#if TEST4
+namespace test4{
+struct PmrMsgPayload {
+    std::pmr::string msg;
+};
+
+using PmrMsgEvent = event<PmrMsgPayload>;
+
+void hndl_pmr_event(const PmrMsgEvent& e){
+    std::pmr::string copy(e.payload.msg, frame_resource());
+    std::cout << "Arena event: " << copy << std::endl;
+}
+
+void test4(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 4 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    constexpr auto bus = EventBus<>{}
+        .subscribe<PmrMsgEvent, hndl_pmr_event>()
+    ;
+
+    FrameArena arena(256);
+    {
+        FrameArenaScope scope(arena);
+        static_assert(Payload<PmrMsgPayload>, "PmrMsgPayload is not a Payload");
+        for (int iteration = 0; iteration < 3; ++iteration) {
+            arena.reset();
+            for (int i = 0; i < 4; ++i) {
+                bus.publish(PmrMsgEvent{.payload = {std::pmr::string(
+                    "\t message that is longer than the small string buffer", frame_resource())}});
+            }
+        }
+    }
+    std::cout << "outside of scope default resource is used: "
+              << (frame_resource() == std::pmr::get_default_resource()) << std::endl;
+    // первая итерация переросла блок, затем блоки объединены и больше не растут
+    std::cout << "upstream allocations: " << arena.upstream_allocations()
+              << ", capacity: " << arena.capacity() << ", peak: " << arena.peak() << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 4 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
+#if TEST5
+namespace test5{
+struct WorkspacePayload {
+    int workspace;
+};
+
+struct LayoutPayload {
+    int workspace;
+    int layout;
+};
+
+using GetLayoutRequest = request<WorkspacePayload, int>;
+using SetLayoutCommand = command<LayoutPayload>;
+using LayoutChangedEvent = event<LayoutPayload>;
+using UnrelatedCommand = command<WorkspacePayload>;
+}; // namespace
+
+template<>
+struct request_cache_traits<test5::GetLayoutRequest> {
+    using invalidated_by = type_list<test5::SetLayoutCommand, test5::LayoutChangedEvent>;
+};
+
+namespace test5{
+static int layouts[4] = {};
+static int handler_calls = 0;
+
+int hndl_get_layout(GetLayoutRequest r){
+    ++handler_calls;
+    return layouts[r.payload.workspace];
+}
+void hndl_set_layout(SetLayoutCommand c){
+    layouts[c.payload.workspace] = c.payload.layout;
+}
+void hndl_layout_changed(LayoutChangedEvent){}
+void hndl_unrelated(UnrelatedCommand){}
+
+void test5(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 5 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    static_assert(  CachedRequest<GetLayoutRequest>,                    "GetLayoutRequest is not cached"   );
+    static_assert( !CachedRequest<request<LayoutPayload, int>>,         "Request must not be cached by default" );
+
+    constexpr auto bus = EventBus<>{}
+        .subscribe<GetLayoutRequest, hndl_get_layout>()
+        .subscribe<SetLayoutCommand, hndl_set_layout>()
+        .subscribe<LayoutChangedEvent, hndl_layout_changed>()
+        .subscribe<UnrelatedCommand, hndl_unrelated>()
+    ;
+
+    auto get = [&](int workspace) { return bus.dispatch(make_request<WorkspacePayload, int>({workspace})); };
+
+    get(0); get(0); get(1); get(0);                                  // 2 промаха, 2 попадания
+    bus.dispatch(make_command<WorkspacePayload>({0}));               // не сбрасывает кэш
+    get(1);                                                          // попадание
+    bus.dispatch(make_command<LayoutPayload>({0, 7}));               // сброс
+    const int layout = get(0);                                       // промах, новое значение
+    bus.publish(make_event<LayoutPayload>({1, 0}));                  // сброс
+    get(1);                                                          // промах
+
+    const auto stats = request_cache_stats<GetLayoutRequest>();
+    std::cout << "layout: " << layout << ", handler calls: " << handler_calls
+              << ", hits: " << stats.hits << ", misses: " << stats.misses
+              << ", invalidations: " << stats.invalidations << std::endl;
+    std::cout << ((layout == 7 && handler_calls == 4 && stats.hits == 3 && stats.misses == 4)
+                  ? "cache is correct" : "WRONG CACHE BEHAVIOUR") << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 5 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
+#if TEST6
+namespace test6{
+struct NumPayload {
+    int num;
+};
+
+struct GetSumPayload {};
+
+using AddCommand = command<NumPayload>;
+using GetSumRequest = request<GetSumPayload, int>;
+using ResetEvent = event<GetSumPayload>;
+
+// state lives in the module instance, no statics
+struct AccumulatorModule : ModuleBase<AccumulatorModule> {
+    explicit AccumulatorModule(int initial = 0) : sum(initial) {}
+
+    void add(const AddCommand& c) { sum += c.payload.num; }
+    int get(const GetSumRequest&) const { return sum; }
+    void reset(const ResetEvent&) { sum = 0; }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus
+            .template bind_command<AddCommand, &AccumulatorModule::add>()
+            .template bind_request<GetSumRequest, &AccumulatorModule::get>()
+            .template subscribe_event<ResetEvent, &AccumulatorModule::reset>();
+    }
+
+    int sum = 0;
+};
+
+void test6(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 6 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    auto first = Compositor<AccumulatorModule>{AccumulatorModule{}};
+    auto second = Compositor<AccumulatorModule>{AccumulatorModule{100}};
+
+    first.dispatch(make_command<NumPayload>({1}));
+    first.dispatch(make_command<NumPayload>({2}));
+    second.dispatch(make_command<NumPayload>({5}));
+    const int first_sum = first.dispatch(make_request<GetSumPayload, int>({}));
+    second.publish(make_event<GetSumPayload>({}));
+    const int second_sum = second.dispatch(make_request<GetSumPayload, int>({}));
+
+    std::cout << "first: " << first_sum << ", second: " << second_sum << std::endl;
+    std::cout << ((first_sum == 3 && second_sum == 0 && first.module<AccumulatorModule>().sum == 3)
+                  ? "instances are independent" : "WRONG INSTANCE BINDING") << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 6 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
+#if TEST7
+namespace test7{
+struct Entry {
+    unsigned long id;
+    int workspace;
+};
+
+// list of entries and a name survive the restart
+struct TableModule : ModuleBase<TableModule> {
+    static constexpr std::string_view state_tag = "table";
+    static constexpr std::uint32_t state_version = 2;
+
+    void serialize(RestartWriter& out) const {
+        out.write_array(std::span(entries));
+        out.write_string(name);
+    }
+
+    bool restore(RestartReader& in) {
+        const auto restored = in.read_array<Entry>();
+        entries.assign(restored.begin(), restored.end());
+        name = in.read_string();
+        return in.ok();
+    }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+
+    std::vector<Entry> entries;
+    std::string name;
+};
+
+// same tag, older format: must be skipped
+struct OldTableModule : ModuleBase<OldTableModule> {
+    static constexpr std::string_view state_tag = "table";
+    static constexpr std::uint32_t state_version = 1;
+
+    void serialize(RestartWriter&) const {}
+    bool restore(RestartReader&) { return true; }
+
+    template<auto... Bindings>
+    constexpr auto register_impl(EventBus<Bindings...> bus) const {
+        return bus;
+    }
+};
+
+void test7(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 7 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    auto before = Compositor<TableModule>{TableModule{}};
+    for (int i = 0; i < 1000; ++i) {
+        before.module<TableModule>().entries.push_back({0x1a00001ul + i, i % 10});
+    }
+    before.module<TableModule>().name = "workspace layout";
+
+    RestartWriter writer;
+    before.serialize_state(writer);
+    std::optional<RestartImage> image = RestartImage::open(restart_image::create(writer.image()));
+
+    auto after = Compositor<TableModule>{TableModule{}};
+    auto old = Compositor<OldTableModule>{OldTableModule{}};
+    const std::size_t restored = image ? after.restore_state(*image) : 0;
+    const std::size_t restored_old = image ? old.restore_state(*image) : 0;
+
+    const auto& table = after.module<TableModule>();
+    std::cout << "image: " << (image ? image->size() : 0) << " bytes, restored: " << restored
+              << ", entries: " << table.entries.size() << ", old format restored: " << restored_old << std::endl;
+    std::cout << ((restored == 1 && restored_old == 0 && table.entries.size() == 1000
+                   && table.entries[999].id == 0x1a00001ul + 999 && table.entries[999].workspace == 9
+                   && table.name == "workspace layout")
+                  ? "state is restored" : "WRONG RESTORED STATE") << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 7 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
+#if TEST8
+namespace test8{
+void write_file(const std::string& path, std::string_view text) {
+    std::ofstream(path, std::ios::trunc) << text;
+}
+
+// action and argument of the binding found for keysym with state, or "none"
+std::string lookup(const ShortcutTable& table, KeySym keysym, unsigned int state) {
+    const Shortcut* shortcut = table.find(keysym, state);
+    if (!shortcut) return "none";
+    return std::to_string(static_cast<int>(shortcut->action)) + ":" + std::string(table.argument(*shortcut));
+}
+
+void test8(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 8 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    // in-memory text: directives, comments, modifier combos, layouts
+    ShortcutTable parsed;
+    const auto good = config_parser::parse(
+        "# comment line\n"
+        "bind Escape exit\n"
+        "  bind Mod4+Shift+Return spawn xterm -e top   # trailing comment\n"
+        "bind Mod4+Return spawn xterm\n"
+        "bind Ctrl+Alt+t message hi there\r\n"
+        "\n"
+        "layout 2 1\n", parsed);
+    const bool parse_ok = good.error_line == 0 && parsed.shortcuts.size() == 4 && parsed.layouts[2] == 1
+        && lookup(parsed, XK_Escape, 0) == "0:"
+        && lookup(parsed, XK_Return, Mod4Mask | ShiftMask | Mod2Mask) == "2:xterm -e top" // more specific wins
+        && lookup(parsed, XK_Return, Mod4Mask) == "2:xterm"
+        && lookup(parsed, XK_Return, ShiftMask) == "none"
+        && lookup(parsed, XK_T, ControlMask | Mod1Mask) == "1:hi there";               // case-insensitive keysym
+
+    // first error line and message
+    struct Bad { std::string_view text; std::size_t line; std::string_view error; };
+    const Bad bad[] = {
+        {"bind Escape exit\nbind Hyper+x exit\n", 2, "unknown key"},
+        {"bind Escape exit\n\nbind x jump\n", 3, "unknown action"},
+        {"layout 16 1\n", 1, "expected: layout <workspace> <layout>"},
+        {"layout 1 x\n", 1, "expected: layout <workspace> <layout>"},
+        {"# ok\nbinds Escape exit\n", 2, "unknown directive"},
+    };
+    bool errors_ok = true;
+    for (const Bad& b : bad) {
+        ShortcutTable table;
+        const auto result = config_parser::parse(b.text, table);
+        errors_ok = errors_ok && result.error_line == b.line && result.error == b.error;
+    }
+
+    // file reload through ConfigModule: a bad file keeps the previous table
+    char dir_template[] = "/tmp/twm-test8-XXXXXX";
+    const std::string dir = mkdtemp(dir_template);
+    const std::string path = dir + "/config";
+    write_file(path, "bind Mod4+b message first\n");
+
+    bool reload_ok;
+    {
+        ConfigModule config(path);
+        config.initialize();
+        const bool first = config.generation() == 1
+            && lookup(ShortcutsModule::table(), XK_b, Mod4Mask) == "1:first";
+
+        write_file(path, "bind Mod4+b message second\nbind Hyper+b exit\n");
+        config.handle_event();
+        config.wait_idle();
+        const bool kept = config.generation() == 1
+            && lookup(ShortcutsModule::table(), XK_b, Mod4Mask) == "1:first";
+
+        write_file(path, "bind Mod4+b message third\n");
+        config.handle_event();
+        config.wait_idle();
+        const bool replaced = config.generation() == 2
+            && lookup(ShortcutsModule::table(), XK_b, Mod4Mask) == "1:third";
+
+        config.cleanup();
+        reload_ok = first && kept && replaced;
+    }
+
+    // restart image: table is taken only while the file is unchanged
+    auto before = Compositor<ConfigModule>{ConfigModule{path}};
+    before.initialize();
+    RestartWriter writer;
+    before.serialize_state(writer);
+    before.cleanup();
+    std::optional<RestartImage> image = RestartImage::open(restart_image::create(writer.image()));
+
+    auto same_file = Compositor<ConfigModule>{ConfigModule{path}};
+    const std::size_t restored_same = image ? same_file.restore_state(*image) : 0;
+    write_file(path, "bind Mod4+b message changed on disk\n");
+    auto changed_file = Compositor<ConfigModule>{ConfigModule{path}};
+    const std::size_t restored_changed = image ? changed_file.restore_state(*image) : 0;
+    const bool restore_ok = restored_same == 1 && restored_changed == 0;
+
+    std::remove(path.c_str());
+    rmdir(dir.c_str());
+    ShortcutsModule::publish_table(std::make_unique<const ShortcutTable>(ShortcutTable::defaults()));
+    ShortcutsModule::reclaim_tables();
+
+    std::cout << "parse: " << parse_ok << ", error lines: " << errors_ok << ", reload: " << reload_ok
+              << ", restore same file: " << restored_same << ", changed file: " << restored_changed << std::endl;
+    std::cout << ((parse_ok && errors_ok && reload_ok && restore_ok)
+                  ? "config is correct" : "WRONG CONFIG BEHAVIOUR") << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 8 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
+#if TEST9
+namespace test9{
+struct NumPayload {
+    int num;
+};
+
+using SquareRequest = request<NumPayload, int>;
+using NumEvent = event<NumPayload>;
+using Ipc = IpcModule<SquareRequest>;
+using Stream = EventStreamModule<NumEvent>;
+
+// poll + handle_event until done()
+template<typename M, typename Done>
+void pump(M& module, Done done) {
+    for (int i = 0; i < 1000 && !done(); ++i) {
+        pollfd fd{module.event_fd(), POLLIN, 0};
+        if (poll(&fd, 1, 10) <= 0) continue;
+        module.handle_event();
+    }
+}
+
+int connect_to(const std::string& path) {
+    sockaddr_un addr;
+    ipc::fill_address(addr, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void test9(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 9 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    Ipc ipc("/tmp/twm-test9-" + std::to_string(getpid()) + ".sock");
+    ipc.set_dispatcher([](const SquareRequest& r) { return r.payload.num * r.payload.num; });
+    ipc.initialize();
+
+    // client pipelines requests and closes before reading any reply:
+    // sending the replies must not raise SIGPIPE and must drop the client
+    int fd = connect_to(ipc.socket_path());
+    const bool connected = fd >= 0;
+    pump(ipc, [&] { return ipc.client_count() == 1; });
+
+    std::vector<char> frames;
+    for (std::uint32_t k = 0; k < 4000; ++k) {
+        const ipc::Header header{.size = sizeof(NumPayload), .type = Ipc::type_id<SquareRequest>, .flags = 0, .seq = k};
+        const NumPayload payload{static_cast<int>(k)};
+        frames.insert(frames.end(), reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header + 1));
+        frames.insert(frames.end(), reinterpret_cast<const char*>(&payload), reinterpret_cast<const char*>(&payload + 1));
+    }
+    const bool sent = write(fd, frames.data(), frames.size()) == static_cast<ssize_t>(frames.size());
+    close(fd);
+    pump(ipc, [&] { return ipc.client_count() == 0; });
+    const std::size_t left = ipc.client_count();
+
+    // the module keeps serving other clients
+    IpcClient<SquareRequest> client;
+    const bool reconnected = client.connect(ipc.socket_path());
+    int square = 0;
+    std::thread caller([&] { square = client.call(make_request<NumPayload, int>({12})); });
+    pump(ipc, [&] { return square != 0; });
+    caller.join();
+
+    ipc.cleanup();
+
+    // subscriber closes while frames are queued for it: flush() must drop it
+    auto compositor = Compositor<Stream>{Stream{"/tmp/twm-test9-events-" + std::to_string(getpid()) + ".sock"}};
+    compositor.initialize();
+    Stream& stream = compositor.module<Stream>();
+    int subscriber = connect_to(stream.socket_path());
+    pump(stream, [&] { return stream.client_count() == 1; });
+    const bool subscribed = subscriber >= 0 && stream.client_count() == 1;
+    close(subscriber);
+    for (int k = 0; k < 100; ++k) compositor.publish(make_event<NumPayload>({k}));
+    stream.flush();
+    const std::size_t subscribers_left = stream.client_count();
+    compositor.cleanup();
+
+    std::cout << "connected: " << connected << ", sent: " << sent << ", clients left: " << left
+              << ", next client answer: " << square << ", subscribers left: " << subscribers_left << std::endl;
+    std::cout << ((connected && sent && reconnected && left == 0 && square == 144 && subscribed && subscribers_left == 0)
+                  ? "disconnect is handled" : "WRONG DISCONNECT HANDLING") << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 9 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
+#if TEST10
+namespace test10{
+using Thumbnails = ThumbnailModule;
+
+void test10(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 10 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    // no display: images are submitted directly, handlers only invalidate the cache
+    auto compositor = Compositor<Thumbnails>{Thumbnails{nullptr}};
+    compositor.initialize();
+    Thumbnails& thumbnails = compositor.module<Thumbnails>();
+
+    constexpr Window window_count = 64;
+    for (Window w = 1; w <= window_count; ++w) {
+        thumbnails.submit(w, 8, 8, std::vector<std::uint32_t>(64, 0xff000000u | w));
+    }
+    thumbnails.wait_idle();
+    const std::size_t cached = thumbnails.cache().size();
+
+    // odd windows are damaged or configured, every fourth is destroyed
+    {
+        ShardedPublisher<decltype(compositor)::BusType, WindowDamageEvent, WindowConfigureEvent, WindowDestroyEvent>
+            sharded(compositor, 4);
+        for (Window w = 1; w <= window_count; ++w) {
+            if (w % 4 == 0) sharded.publish(WindowDestroyEvent{.payload = {w}});
+            else if (w % 4 == 1) sharded.publish(WindowDamageEvent{.payload = {w, 0, 0, 1, 1}});
+            else if (w % 4 == 3) sharded.publish(WindowConfigureEvent{.payload = {w, 0, 0, 10, 10}});
+        }
+        sharded.flush();
+    }
+
+    std::size_t kept = 0, dropped_wrong = 0;
+    for (Window w = 1; w <= window_count; ++w) {
+        const bool present = thumbnails.lookup(w) != nullptr;
+        if (w % 4 == 2) kept += present;
+        else dropped_wrong += present;
+    }
+    compositor.cleanup();
+
+    std::cout << "cached: " << cached << ", kept: " << kept << ", stale left: " << dropped_wrong << std::endl;
+    std::cout << ((cached == window_count && kept == window_count / 4 && dropped_wrong == 0)
+                  ? "sharded handlers reach the module instance" : "WRONG SHARDED DELIVERY") << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 10 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
+#if TEST11
+namespace test11{
+std::shared_ptr<const Thumbnail> make_thumbnail(Window window) {
+    auto thumbnail = std::make_shared<Thumbnail>();
+    thumbnail->window = window;
+    thumbnail->width = thumbnail->height = 16;
+    thumbnail->pixels.assign(16 * 16, 0xff000000u);
+    return thumbnail;
+}
+
+void test11(){
+    std::cout << "-_-_-_-_-_-_-_-/ TEST 11 START \\-_-_-_-_-_-_-_-" << std::endl;
+
+    // budget for exactly three thumbnails
+    const std::size_t size = make_thumbnail(0)->bytes();
+    auto compositor = Compositor<ThumbnailModule>{ThumbnailModule{nullptr, ThumbnailConfig{.memory_budget = 3 * size}}};
+    compositor.initialize();
+    ThumbnailCache& cache = compositor.module<ThumbnailModule>().cache();
+
+    // LRU: window 1 is looked up, so inserting 4 evicts window 2
+    for (Window w = 1; w <= 3; ++w) cache.insert(make_thumbnail(w), cache.generation());
+    cache.lookup(1);
+    cache.insert(make_thumbnail(4), cache.generation());
+    const bool lru = cache.size() == 3 && cache.memory_usage() <= cache.memory_budget() && cache.evictions() == 1
+                     && cache.lookup(1) && !cache.lookup(2) && cache.lookup(3) && cache.lookup(4);
+
+    // damage drops the thumbnail and the job started before it, a later job is accepted
+    const std::uint64_t before_damage = cache.generation();
+    compositor.publish(make_event<WindowDamagePayload>({1, 0, 0, 1, 1}));
+    const bool damaged = !cache.lookup(1)
+                         && !cache.insert(make_thumbnail(1), before_damage)
+                         && cache.insert(make_thumbnail(1), cache.generation());
+
+    // destroyed window leaves a tombstone: the job in flight is rejected
+    const std::uint64_t before_destroy = cache.generation();
+    compositor.publish(make_event<WindowDestroyPayload>({3}));
+    const bool destroyed = !cache.lookup(3) && !cache.insert(make_thumbnail(3), before_destroy)
+                           && cache.lookup(4);
+    compositor.cleanup();
+
+    std::cout << "lru: " << lru << ", damaged: " << damaged << ", destroyed: " << destroyed << std::endl;
+    std::cout << ((lru && damaged && destroyed) ? "thumbnail cache is consistent" : "WRONG THUMBNAIL CACHE") << std::endl;
+
+    std::cout << "-_-_-_-_-_-_-_-\\  TEST 11 END  /-_-_-_-_-_-_-_-" << std::endl;
+}
+}; // namespace
+#endif
+
 int main() {
 #if TEST1
     test1::test1();
@@ -128,6 +747,33 @@ int main() {
 #if TEST2
     test2::test2();
 #endif
+#if TEST3
+    test3::test3();
+#endif
+#if TEST4
+    test4::test4();
+#endif
+#if TEST5
+    test5::test5();
+#endif
+#if TEST6
+    test6::test6();
+#endif
+#if TEST7
+    test7::test7();
+#endif
+#if TEST8
+    test8::test8();
+#endif
+#if TEST9
+    test9::test9();
+#endif
+#if TEST10
+    test10::test10();
+#endif
+#if TEST11
+    test11::test11();
+#endif
 
     return 0;
 };